@@ -0,0 +1,155 @@
+/**
+ * @file kit_bundle.h
+ * @brief Single-file binary kit bundle format (.kit)
+ * @version 2.0
+ * @date 2025-12-10
+ *
+ * A kit bundle packs every sample of a kit into one file so the main brain can
+ * load it with a few large sequential reads straight into one PSRAM block,
+ * instead of opening each WAV and walking its RIFF chunks on the SPI SD bus.
+ *
+ * File layout (all fields little-endian):
+ *
+ *   offset 0            KitBundleHeader (padded to KIT_BUNDLE_ALIGN)
+ *   indexOffset         KitBundleEntry[sampleCount] (padded to KIT_BUNDLE_ALIGN)
+ *   dataOffset          Sample blobs, each one starting on a KIT_BUNDLE_ALIGN boundary
+ *
+ * A blob is plain PCM16 or one of the block codecs in sample_codec.h
+ * (KitBundleEntry::format); the firmware keeps it in PSRAM as stored.
+ *
+ * Entry offsets are relative to dataOffset, so the data region can be read as a
+ * single block and sample pointers computed as (block + entry.offset).
+ *
+ * Each entry carries a content fingerprint (kitSampleFingerprint) so the
+ * firmware's sample cache can reuse a sample already in PSRAM - loaded from
+ * another kit or as a loose WAV - instead of reading it again.
+ *
+ * This header is shared by the firmware and the host-side packer
+ * (tools/kit_packer), so it must not depend on Arduino.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================
+// FORMAT CONSTANTS
+// ============================================================
+
+#define KIT_BUNDLE_MAGIC        0x424B4447u  // "GDKB"
+#define KIT_BUNDLE_VERSION      2            // v2: per-entry content fingerprint
+#define KIT_BUNDLE_ALIGN        512          // SD sector size - keeps reads sector aligned
+#define KIT_BUNDLE_MAX_SAMPLES  64
+#define KIT_BUNDLE_NAME_LEN     32           // Same as PadConfig::sampleName
+#define KIT_BUNDLE_KIT_NAME_LEN 16
+#define KIT_FINGERPRINT_SPAN    4096         // PCM bytes hashed at each end of a sample
+                                             // (of the source PCM, before trimming)
+
+// Sample storage formats
+enum KitSampleFormat : uint8_t {
+    KIT_FORMAT_PCM16 = 0,   // Signed 16-bit, interleaved if stereo
+    KIT_FORMAT_PCM12 = 1,   // 12-bit with per-block shift (sample_codec.h)
+    KIT_FORMAT_ADPCM4 = 2   // IMA-ADPCM, 4 bits per sample (sample_codec.h)
+};
+
+// ============================================================
+// ON-DISK STRUCTURES
+// ============================================================
+
+#pragma pack(push, 1)
+
+struct KitBundleHeader {
+    uint32_t magic;          // KIT_BUNDLE_MAGIC
+    uint16_t version;        // KIT_BUNDLE_VERSION
+    uint16_t headerSize;     // sizeof(KitBundleHeader)
+    uint16_t entrySize;      // sizeof(KitBundleEntry)
+    uint16_t sampleCount;    // Number of entries in the index
+    uint32_t indexOffset;    // Absolute file offset of the index
+    uint32_t dataOffset;     // Absolute file offset of the PCM region
+    uint32_t dataSize;       // Size of the PCM region in bytes (multiple of KIT_BUNDLE_ALIGN)
+    char kitName[KIT_BUNDLE_KIT_NAME_LEN];
+};
+
+struct KitBundleEntry {
+    uint32_t nameHash;       // kitBundleHash(name)
+    uint32_t offset;         // Blob offset relative to dataOffset
+    uint32_t bytes;          // Blob size in bytes (sampleCodecBytes())
+    uint32_t frames;         // Frames (samples per channel)
+    uint32_t sampleRate;     // Hz
+    uint8_t channels;        // 1 = mono, 2 = stereo
+    uint8_t format;          // KitSampleFormat
+    uint16_t trimLeadFrames; // Leading silence removed by the packer (saturated, 0 = none)
+    uint32_t loopStart;      // Loop start frame
+    uint32_t loopEnd;        // Loop end frame (0 = one-shot)
+    uint32_t fingerprint;    // kitSampleFingerprint() of the PCM blob
+    char name[KIT_BUNDLE_NAME_LEN];  // Sample name as referenced by PadConfig
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(KitBundleHeader) == 40, "KitBundleHeader layout changed");
+static_assert(sizeof(KitBundleEntry) == 68, "KitBundleEntry layout changed");
+
+// ============================================================
+// HELPERS
+// ============================================================
+
+/**
+ * @brief FNV-1a hash of a sample name, used as the index lookup key
+ */
+constexpr uint32_t kitBundleHash(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (name && *name) {
+        hash ^= static_cast<uint8_t>(*name++);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Round a size or offset up to the bundle alignment
+ */
+constexpr uint32_t kitBundleAlign(uint32_t value) {
+    return (value + (KIT_BUNDLE_ALIGN - 1)) & ~static_cast<uint32_t>(KIT_BUNDLE_ALIGN - 1);
+}
+
+/**
+ * @brief Content fingerprint of a PCM sample
+ *
+ * FNV-1a over the format, the PCM size and the first and last
+ * KIT_FINGERPRINT_SPAN bytes (the whole sample if shorter). Cheap enough to
+ * compute on the device from two small SD reads, before deciding whether the
+ * full sample has to be loaded. Use kitFingerprintSpan() for the span lengths.
+ */
+constexpr uint32_t kitFingerprintSpan(uint32_t bytes) {
+    return bytes < KIT_FINGERPRINT_SPAN ? bytes : KIT_FINGERPRINT_SPAN;
+}
+
+inline uint32_t kitFingerprintUpdate(uint32_t hash, const uint8_t* data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline uint32_t kitFingerprintBegin(uint32_t bytes, uint32_t sampleRate, uint8_t channels) {
+    uint8_t format[9] = {
+        (uint8_t)bytes, (uint8_t)(bytes >> 8), (uint8_t)(bytes >> 16), (uint8_t)(bytes >> 24),
+        (uint8_t)sampleRate, (uint8_t)(sampleRate >> 8), (uint8_t)(sampleRate >> 16),
+        (uint8_t)(sampleRate >> 24), channels
+    };
+    return kitFingerprintUpdate(2166136261u, format, sizeof(format));
+}
+
+/**
+ * @brief Fingerprint of a sample held entirely in memory (host packer)
+ */
+inline uint32_t kitSampleFingerprint(const uint8_t* pcm, uint32_t bytes,
+                                     uint32_t sampleRate, uint8_t channels) {
+    uint32_t span = kitFingerprintSpan(bytes);
+    uint32_t hash = kitFingerprintBegin(bytes, sampleRate, channels);
+    hash = kitFingerprintUpdate(hash, pcm, span);
+    return kitFingerprintUpdate(hash, pcm + bytes - span, span);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file master_limiter.h
+ * @brief Fixed-point lookahead peak limiter for the master bus
+ * @version 1.0
+ * @date 2025-12-14
+ *
+ * Replaces the per-sample clamp at the end of the mixer. Dense playing used to
+ * hard-clip; the limiter instead pulls the gain down just before a peak and
+ * lets it recover slowly afterwards.
+ *
+ * Block-based, stereo-linked:
+ *   - the block is cut into sub-blocks of MASTER_LIMITER_SUB_BLOCK frames;
+ *   - each incoming sub-block's peak sets the gain it needs (ceiling / peak);
+ *   - output is delayed by MASTER_LIMITER_LOOKAHEAD_SUBS sub-blocks, and the
+ *     gain for an outgoing sub-block is the minimum needed by it and every
+ *     sub-block still in the delay line, so the gain is already down when a
+ *     peak leaves the delay line;
+ *   - the gain is interpolated linearly across each sub-block. Both ends of
+ *     the ramp satisfy the outgoing sub-block, so no sample exceeds the ceiling.
+ *
+ * Everything runs in integers: samples are Q0 int32 (may exceed 16 bits before
+ * limiting), gain is Q15 (32768 = unity).
+ *
+ * Cost per 256-frame block: one peak scan, one 32-bit division per sub-block
+ * and two 32x32->64 multiplies per frame. Roughly 20 cycles/frame, ~5k cycles
+ * (~21 us at 240 MHz) per block, under 0.4% of the 5.8 ms block period.
+ * AudioEngine measures the real figure (limiterCycles()).
+ *
+ * Latency: MASTER_LIMITER_LOOKAHEAD_SUBS * MASTER_LIMITER_SUB_BLOCK frames
+ * (64 frames = 1.45 ms at 44.1 kHz).
+ *
+ * Shared by the firmware and the host tests, so it must not depend on Arduino.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// ============================================================
+// DEFAULTS
+// ============================================================
+
+#define MASTER_LIMITER_CEILING        32000   // Output ceiling (~-0.2 dBFS)
+#define MASTER_LIMITER_SUB_BLOCK      32      // Frames per gain step (power of two)
+#define MASTER_LIMITER_SUB_SHIFT      5       // log2(MASTER_LIMITER_SUB_BLOCK)
+#define MASTER_LIMITER_LOOKAHEAD_SUBS 2       // Lookahead in sub-blocks
+#define MASTER_LIMITER_RELEASE_Q15    476     // Recovery per sub-block (~50 ms time constant)
+#define MASTER_LIMITER_UNITY          32768   // Q15
+
+#define MASTER_LIMITER_LOOKAHEAD_FRAMES (MASTER_LIMITER_SUB_BLOCK * MASTER_LIMITER_LOOKAHEAD_SUBS)
+
+struct MasterLimiterStats {
+    int32_t minGain;        // Lowest gain applied since reset (Q15)
+    int32_t gain;           // Current gain (Q15)
+    uint32_t clippedSamples; // Samples still clamped after limiting (should stay 0)
+};
+
+class MasterLimiter {
+public:
+    MasterLimiter() { reset(); }
+
+    void reset() {
+        std::memset(delayL, 0, sizeof(delayL));
+        std::memset(delayR, 0, sizeof(delayR));
+        std::memset(peaks, 0, sizeof(peaks));
+        peakSlot = 0;
+        delaySlot = 0;
+        gain = MASTER_LIMITER_UNITY;
+        resetStats();
+    }
+
+    void resetStats() {
+        stats.minGain = gain;
+        stats.gain = gain;
+        stats.clippedSamples = 0;
+    }
+
+    const MasterLimiterStats& getStats() const { return stats; }
+
+    /**
+     * @brief Limit one block into an interleaved stereo int16 buffer
+     * @param frames Multiple of MASTER_LIMITER_SUB_BLOCK
+     */
+    void process(const int32_t* inL, const int32_t* inR, int16_t* out, uint32_t frames) {
+        for (uint32_t base = 0; base < frames; base += MASTER_LIMITER_SUB_BLOCK) {
+            processSubBlock(inL + base, inR + base, out + base * 2);
+        }
+        stats.gain = gain;
+    }
+
+private:
+    static constexpr int PEAK_SLOTS = MASTER_LIMITER_LOOKAHEAD_SUBS + 1;
+
+    int32_t delayL[MASTER_LIMITER_LOOKAHEAD_FRAMES];
+    int32_t delayR[MASTER_LIMITER_LOOKAHEAD_FRAMES];
+    int32_t peaks[PEAK_SLOTS];      // Delayed sub-blocks + the incoming one
+    uint8_t peakSlot;               // Next peaks[] slot
+    uint8_t delaySlot;              // Delay-line sub-block leaving next
+    int32_t gain;                   // Q15, value at the end of the last sub-block
+    MasterLimiterStats stats;
+
+    static inline int32_t absolute(int32_t v) { return v < 0 ? -v : v; }
+
+    static inline int32_t requiredGain(int32_t peak) {
+        if (peak <= MASTER_LIMITER_CEILING) return MASTER_LIMITER_UNITY;
+        return (int32_t)(((int64_t)MASTER_LIMITER_CEILING << 15) / peak);
+    }
+
+    void processSubBlock(const int32_t* inL, const int32_t* inR, int16_t* out) {
+        // 1. Peak of the incoming sub-block
+        int32_t peak = 0;
+        for (int i = 0; i < MASTER_LIMITER_SUB_BLOCK; i++) {
+            int32_t l = absolute(inL[i]);
+            int32_t r = absolute(inR[i]);
+            if (l > peak) peak = l;
+            if (r > peak) peak = r;
+        }
+        peaks[peakSlot] = peak;
+        peakSlot = (peakSlot + 1) % PEAK_SLOTS;
+
+        // 2. Target gain: covers the outgoing sub-block and everything behind it
+        int32_t worst = 0;
+        for (int s = 0; s < PEAK_SLOTS; s++) {
+            if (peaks[s] > worst) worst = peaks[s];
+        }
+        int32_t target = requiredGain(worst);
+        if (target > gain) {
+            // Release: recover a fraction of the distance per sub-block
+            target = gain + (int32_t)(((int64_t)(target - gain) * MASTER_LIMITER_RELEASE_Q15) >> 15);
+        }
+
+        // 3. Outgoing sub-block, gain ramped linearly (Q23 accumulator)
+        int32_t* dl = delayL + delaySlot * MASTER_LIMITER_SUB_BLOCK;
+        int32_t* dr = delayR + delaySlot * MASTER_LIMITER_SUB_BLOCK;
+        int32_t acc = gain * 256;
+        // Shift rounds toward -inf: the ramp never ends above the target
+        int32_t step = ((target - gain) * 256) >> MASTER_LIMITER_SUB_SHIFT;
+        for (int i = 0; i < MASTER_LIMITER_SUB_BLOCK; i++) {
+            acc += step;
+            int32_t g = acc >> 8;
+            out[i * 2] = saturate((int32_t)(((int64_t)dl[i] * g) >> 15));
+            out[i * 2 + 1] = saturate((int32_t)(((int64_t)dr[i] * g) >> 15));
+
+            // Incoming frame takes the slot just played
+            dl[i] = inL[i];
+            dr[i] = inR[i];
+        }
+
+        gain = target;
+        if (gain < stats.minGain) stats.minGain = gain;
+        delaySlot = (delaySlot + 1) % MASTER_LIMITER_LOOKAHEAD_SUBS;
+    }
+
+    inline int16_t saturate(int32_t v) {
+        if (v > 32767) { stats.clippedSamples++; return 32767; }
+        if (v < -32767) { stats.clippedSamples++; return -32767; }
+        return (int16_t)v;
+    }
+};
+
+/**
+ * @brief Gain reduction in dB for a Q15 gain (0 = none)
+ */
+inline float masterLimiterReductionDb(int32_t gainQ15) {
+    if (gainQ15 <= 0) return -96.0f;
+    return 20.0f * std::log10((float)gainQ15 / MASTER_LIMITER_UNITY);
+}
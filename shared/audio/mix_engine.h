@@ -0,0 +1,562 @@
+/**
+ * @file mix_engine.h
+ * @brief Polyphonic sample mixer: voices -> per-pad buses -> master -> limiter
+ * @version 1.0
+ * @date 2025-12-15
+ *
+ * One engine, templated on:
+ *   - MaxVoices:   polyphony;
+ *   - BlockFrames: frames rendered per call (must be a multiple of
+ *                  MASTER_LIMITER_SUB_BLOCK);
+ *   - OutChannels: output layout, 2 = interleaved stereo, 1 = mono;
+ *   - BusCount:    mixer buses (one per pad). Voices started on MIX_BUS_NONE
+ *                  go straight to the master.
+ *
+ * Buses are stereo. The inner kernel is specialized at compile time on the
+ * source layout (mono->stereo, stereo->stereo); the dispatch happens once per
+ * voice per block, never per sample.
+ *
+ * Sources may be block coded (sample_codec.h). Each voice then decodes one
+ * SAMPLE_CODEC_BLOCK at a time into its own scratch buffer (1 KB per voice,
+ * internal RAM) and the kernel reads from there; a mixer block touches at
+ * most two codec blocks per voice.
+ *
+ * Per block:
+ *   1. voices whose remaining envelope * gain is inaudible are culled;
+ *   2. voices are summed into their bus (choke fades applied per sample);
+ *   3. buses get fader + constant-power pan with per-block gain ramps and
+ *      peak/RMS meters, and are summed into the master;
+ *   4. master gain (ramped), meters, then the lookahead limiter.
+ *
+ * The engine does no locking and no I/O: the caller serializes access (the
+ * firmware wraps it in AudioEngine with a mutex, I2S and a task) and is told
+ * through a release hook when a voice lets go of its sample. This keeps it
+ * free of Arduino so the host tools can render with the same code.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "master_limiter.h"
+#include "sample_codec.h"
+
+// ============================================================
+// DEFAULTS
+// ============================================================
+
+#define MIX_ENVELOPE_BLOCK   256   // Frames per envelope value (Sample::envelope)
+#define MIX_CULL_LEVEL       16    // Remaining RMS * gain below which a voice is cut (~-66 dBFS)
+#define MIX_CHOKE_RELEASE_MS 3     // Linear fade of a choked voice (1-5 ms)
+#define MIX_BUS_NONE         0xFF  // No pad: straight to the master
+
+static_assert(MIX_ENVELOPE_BLOCK == SAMPLE_CODEC_BLOCK, "Envelope blocks must match codec blocks");
+
+/**
+ * @brief What a voice plays. The engine never owns the data.
+ */
+struct MixSource {
+    const int16_t* data;        // Interleaved PCM (KIT_FORMAT_PCM16)
+    uint32_t frames;
+    uint8_t channels;           // 1 or 2
+    const uint16_t* envelope;   // Max remaining RMS per MIX_ENVELOPE_BLOCK (may be null)
+    uint32_t envelopeBlocks;
+    const void* handle;         // Returned to the release hook
+    uint8_t format;             // KitSampleFormat
+    const uint8_t* coded;       // Coded blocks (KIT_FORMAT_PCM12 / KIT_FORMAT_ADPCM4)
+};
+
+constexpr uint32_t mixEnvelopeBlocks(uint32_t frames) {
+    return (frames + MIX_ENVELOPE_BLOCK - 1) / MIX_ENVELOPE_BLOCK;
+}
+
+/**
+ * @brief Build a source's envelope at load time
+ *
+ * RMS of each MIX_ENVELOPE_BLOCK, then a backwards running max, so env[b]
+ * never underestimates what is still to play. Coded sources are decoded
+ * block by block (what the mixer will hear).
+ *
+ * @param env     mixEnvelopeBlocks(src.frames) values
+ * @param scratch SAMPLE_CODEC_BLOCK * 2 samples (coded sources only)
+ */
+inline void mixBuildEnvelope(const MixSource& src, uint16_t* env, int16_t* scratch) {
+    uint32_t blocks = mixEnvelopeBlocks(src.frames);
+    uint32_t blockBytes = sampleCodecBlockBytes(src.format, src.channels);
+    for (uint32_t b = 0; b < blocks; b++) {
+        uint32_t first = b * MIX_ENVELOPE_BLOCK;
+        uint32_t frames = src.frames - first < MIX_ENVELOPE_BLOCK ? src.frames - first : MIX_ENVELOPE_BLOCK;
+        uint32_t count = frames * src.channels;
+        const int16_t* p = scratch;
+        if (sampleCodecIsCoded(src.format)) {
+            sampleCodecDecodeBlock(src.format, src.channels, src.coded + (size_t)b * blockBytes, scratch);
+        } else {
+            p = src.data + (size_t)first * src.channels;
+        }
+        uint64_t sumSquares = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            sumSquares += (int32_t)p[i] * p[i];
+        }
+        env[b] = (uint16_t)std::sqrt((float)sumSquares / count);
+    }
+    for (int32_t b = (int32_t)blocks - 2; b >= 0; b--) {
+        if (env[b + 1] > env[b]) env[b] = env[b + 1];
+    }
+}
+
+// Bus meter: linear magnitudes (32767 = 0 dBFS)
+struct MeterReading {
+    uint16_t peak = 0;
+    uint16_t rms = 0;
+};
+
+template <size_t BusCount>
+struct MixMeters {
+    MeterReading bus[BusCount];
+    MeterReading master;
+};
+
+template <size_t MaxVoices, size_t BlockFrames, uint8_t OutChannels = 2, size_t BusCount = 4>
+class MixEngine {
+    static_assert(OutChannels == 1 || OutChannels == 2, "Output must be mono or stereo");
+    static_assert(BlockFrames % MASTER_LIMITER_SUB_BLOCK == 0, "Block must hold whole limiter sub-blocks");
+    static_assert(BusCount <= 8, "Mute/solo masks are 8 bits");
+
+public:
+    typedef MixMeters<BusCount> Meters;
+    typedef void (*ReleaseFn)(const void* handle, void* ctx);
+    typedef uint32_t (*CycleFn)();
+
+    static constexpr size_t VOICES = MaxVoices;
+    static constexpr size_t BLOCK = BlockFrames;
+    static constexpr size_t BUSES = BusCount;
+
+    explicit MixEngine(uint32_t sampleRate)
+        : releaseFrames((uint16_t)(sampleRate * MIX_CHOKE_RELEASE_MS / 1000)) {
+        if (releaseFrames == 0) releaseFrames = 1;
+    }
+
+    void setReleaseHook(ReleaseFn fn, void* ctx) {
+        releaseHook = fn;
+        releaseCtx = ctx;
+    }
+
+    // Optional cycle counter to time the limiter (e.g. ESP.getCycleCount)
+    void setCycleCounter(CycleFn fn) { cycleCounter = fn; }
+
+    // ============================================================
+    // VOICES
+    // ============================================================
+
+    /**
+     * @brief Start a voice
+     * @param chokeMask Choke groups of the trigger: voices sharing any group fade out
+     * @param velocityHiRes 16-bit velocity (MIDI 2.0 scale); 0 = use the 7-bit one
+     * @return false if the source is empty
+     */
+    bool start(const MixSource& src, uint8_t velocity, uint8_t volume, uint8_t chokeMask, uint8_t bus,
+               uint16_t velocityHiRes = 0) {
+        if (src.frames == 0 || src.channels < 1 || src.channels > 2) return false;
+        if (sampleCodecIsCoded(src.format) ? !src.coded : (src.format != KIT_FORMAT_PCM16 || !src.data)) return false;
+
+        // Choke: fade the voices of these groups (a hard cut would click)
+        if (chokeMask) choke(chokeMask);
+
+        // Free voice, or steal the one that is least audible right now: a soft
+        // tom tail before a crash in full sustain
+        int index = -1;
+        for (size_t i = 0; i < MaxVoices; i++) {
+            if (!voices[i].active) {
+                index = (int)i;
+                break;
+            }
+        }
+        if (index < 0) {
+            uint32_t minLevel = UINT32_MAX;
+            index = 0;
+            for (size_t i = 0; i < MaxVoices; i++) {
+                uint32_t level = remainingLevel(voices[i]);
+                if (level < minLevel) {
+                    minLevel = level;
+                    index = (int)i;
+                }
+            }
+            stolenCount++;
+        }
+
+        Voice& v = voices[index];
+        releaseVoice(v);
+        v.src = src;
+        v.position = 0;
+        v.decodedBlock = NO_BLOCK;
+        float level = velocityHiRes ? velocityHiRes / 65535.0f : velocity / 127.0f;
+        v.gain = (volume / 127.0f) * level;
+        v.chokeMask = chokeMask;
+        v.releaseLeft = 0;
+        v.bus = bus;
+        v.active = true;
+        return true;
+    }
+
+    // Fade out the voices in any of these choke groups. A fading voice leaves
+    // its groups so another choke does not restart the fade.
+    void choke(uint8_t chokeMask) {
+        for (size_t i = 0; i < MaxVoices; i++) {
+            Voice& v = voices[i];
+            if (v.active && (v.chokeMask & chokeMask)) {
+                v.chokeMask = 0;
+                v.releaseLeft = releaseFrames;
+            }
+        }
+    }
+
+    void stopAll() {
+        for (size_t i = 0; i < MaxVoices; i++) releaseVoice(voices[i]);
+    }
+
+    bool anyActive() const {
+        for (size_t i = 0; i < MaxVoices; i++) {
+            if (voices[i].active) return true;
+        }
+        return false;
+    }
+
+    // ============================================================
+    // BUSES / MASTER
+    // ============================================================
+
+    void setBusVolume(uint8_t bus, uint8_t volume) {
+        if (bus < BusCount) buses[bus].volume = std::min<uint8_t>(volume, 127);
+    }
+
+    void setBusPan(uint8_t bus, int8_t pan) {
+        if (bus < BusCount) buses[bus].pan = std::max<int8_t>(-64, std::min<int8_t>(64, pan));
+    }
+
+    void setBusMute(uint8_t bus, bool mute) {
+        if (bus < BusCount) buses[bus].mute = mute;
+    }
+
+    void setBusSolo(uint8_t bus, bool solo) {
+        if (bus < BusCount) buses[bus].solo = solo;
+    }
+
+    uint8_t busVolume(uint8_t bus) const { return bus < BusCount ? buses[bus].volume : 0; }
+
+    uint8_t muteMask() const {
+        uint8_t mask = 0;
+        for (size_t b = 0; b < BusCount; b++) {
+            if (buses[b].mute) mask |= 1 << b;
+        }
+        return mask;
+    }
+
+    uint8_t soloMask() const {
+        uint8_t mask = 0;
+        for (size_t b = 0; b < BusCount; b++) {
+            if (buses[b].solo) mask |= 1 << b;
+        }
+        return mask;
+    }
+
+    void setMasterVolume(uint8_t volume) { masterVolume = std::min<uint8_t>(volume, 127); }
+    uint8_t getMasterVolume() const { return masterVolume; }
+
+    // Peak/RMS since the previous read (resets the accumulators)
+    void readMeters(Meters& out) {
+        for (size_t b = 0; b < BusCount; b++) {
+            out.bus[b] = takeMeter(buses[b].peak, buses[b].sumSq);
+        }
+        out.master = takeMeter(masterPeak, masterSumSq);
+        meterFrames = 0;
+    }
+
+    // ============================================================
+    // RENDER
+    // ============================================================
+
+    /**
+     * @brief Render one block of BlockFrames frames into 'out' (OutChannels interleaved)
+     * @return true if the engine is idle: no voices left and the block (and the
+     *         limiter's delay line) is pure silence, so the caller may stop rendering
+     */
+    bool render(int16_t* out) {
+        std::memset(busBuffer, 0, sizeof(busBuffer));
+
+        // 1. Cull voices whose remainder is inaudible: the envelope is the max
+        // still to come, so nothing further ahead gets louder than this
+        for (size_t v = 0; v < MaxVoices; v++) {
+            if (voices[v].active && remainingLevel(voices[v]) < MIX_CULL_LEVEL) {
+                releaseVoice(voices[v]);
+                culledCount++;
+            }
+        }
+
+        // 2. Voices -> their bus
+        for (size_t v = 0; v < MaxVoices; v++) {
+            Voice& voice = voices[v];
+            if (!voice.active) continue;
+            BusFrame* bus = busBuffer[voice.bus < BusCount ? voice.bus : BusCount];
+            int16_t* scratch = decodeScratch[v];
+            if (voice.src.channels == 1) {
+                renderVoice<1>(voice, scratch, bus);
+            } else {
+                renderVoice<2>(voice, scratch, bus);
+            }
+        }
+
+        // 3. Buses -> master (fader + pan, ramped per block) and meters
+        const BusFrame* direct = busBuffer[BusCount];
+        for (size_t i = 0; i < BlockFrames; i++) {
+            mixLeft[i] = (float)direct[i].left;
+            mixRight[i] = (float)direct[i].right;
+        }
+
+        bool anySolo = false;
+        for (size_t b = 0; b < BusCount; b++) anySolo |= buses[b].solo;
+
+        const float rampScale = 1.0f / BlockFrames;
+        for (size_t b = 0; b < BusCount; b++) {
+            Bus& bus = buses[b];
+            float targetL, targetR;
+            busTargetGains(bus, anySolo, targetL, targetR);
+
+            // Linear ramp to the target across the block: no zipper noise
+            float gainL = bus.gainL, gainR = bus.gainR;
+            float stepL = (targetL - gainL) * rampScale;
+            float stepR = (targetR - gainR) * rampScale;
+            const BusFrame* in = busBuffer[b];
+            for (size_t i = 0; i < BlockFrames; i++) {
+                gainL += stepL;
+                gainR += stepR;
+                float left = in[i].left * gainL;
+                float right = in[i].right * gainR;
+                mixLeft[i] += left;
+                mixRight[i] += right;
+
+                float level = std::max(std::fabs(left), std::fabs(right));
+                if (level > bus.peak) bus.peak = level;
+                bus.sumSq += level * level;
+            }
+            bus.gainL = targetL;
+            bus.gainR = targetR;
+        }
+
+        // 4. Master gain (ramped) and meters
+        bool signal = false;
+        float targetMaster = faderGain(masterVolume);
+        float gain = masterGain;
+        float step = (targetMaster - gain) * rampScale;
+        for (size_t i = 0; i < BlockFrames; i++) {
+            gain += step;
+            float left = mixLeft[i] * gain;
+            float right = mixRight[i] * gain;
+            if (OutChannels == 1) left = right = (left + right) * 0.5f;
+
+            float level = std::max(std::fabs(left), std::fabs(right));
+            if (level > masterPeak) masterPeak = level;
+            masterSumSq += level * level;
+
+            masterLeft[i] = (int32_t)left;
+            masterRight[i] = (int32_t)right;
+            signal |= (masterLeft[i] | masterRight[i]) != 0;
+        }
+        masterGain = targetMaster;
+        meterFrames += BlockFrames;
+
+        // 5. Limiter -> output
+        uint32_t cycles = cycleCounter ? cycleCounter() : 0;
+        limiter.process(masterLeft, masterRight, limited, BlockFrames);
+        if (cycleCounter) {
+            cycles = cycleCounter() - cycles;
+            if (cycles > limiterMaxCycles) limiterMaxCycles = cycles;
+        }
+
+        bool silentOut = true;
+        if (OutChannels == 2) {
+            std::memcpy(out, limited, sizeof(limited));
+            for (size_t i = 0; i < BlockFrames * 2 && silentOut; i++) silentOut = limited[i] == 0;
+        } else {
+            for (size_t i = 0; i < BlockFrames; i++) {
+                out[i] = limited[i * 2];
+                silentOut &= out[i] == 0;
+            }
+        }
+
+        lastSignal = signal || !silentOut;
+        return !anyActive() && !signal && silentOut;
+    }
+
+    // true if the last rendered block carried any signal
+    bool hadSignal() const { return lastSignal; }
+
+    // ============================================================
+    // STATS
+    // ============================================================
+
+    MasterLimiterStats limiterStats() const { return limiter.getStats(); }
+    uint32_t limiterCycles() const { return limiterMaxCycles; }
+    uint32_t culledVoices() const { return culledCount; }
+    uint32_t stolenVoices() const { return stolenCount; }
+
+private:
+    struct Voice {
+        bool active = false;
+        MixSource src = {};
+        uint32_t position = 0;      // Frames
+        uint32_t decodedBlock = 0;  // Codec block in the voice's scratch (NO_BLOCK = none)
+        float gain = 1.0f;          // Volume * velocity
+        uint8_t chokeMask = 0;      // Choke groups this voice belongs to (bit n = group n+1)
+        uint16_t releaseLeft = 0;   // Choke fade frames left (0 = not fading)
+        uint8_t bus = MIX_BUS_NONE;
+    };
+
+    struct Bus {
+        uint8_t volume = 127;       // Fader 0-127
+        int8_t pan = 0;             // -64 (left) .. +64 (right)
+        bool mute = false;
+        bool solo = false;
+        float gainL = 0.0f;         // Applied gain (follows the target with a ramp)
+        float gainR = 0.0f;
+        float peak = 0.0f;          // Meters since the last read
+        float sumSq = 0.0f;
+    };
+
+    struct BusFrame {
+        int32_t left;
+        int32_t right;
+    };
+
+    static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+    Voice voices[MaxVoices];
+    int16_t decodeScratch[MaxVoices][SAMPLE_CODEC_BLOCK * 2];  // Coded sources only
+    Bus buses[BusCount];
+    BusFrame busBuffer[BusCount + 1][BlockFrames];  // Last one = direct to master
+    float mixLeft[BlockFrames];
+    float mixRight[BlockFrames];
+    int32_t masterLeft[BlockFrames];
+    int32_t masterRight[BlockFrames];
+    int16_t limited[BlockFrames * 2];
+    MasterLimiter limiter;
+
+    uint8_t masterVolume = 127;
+    float masterGain = 0.0f;
+    float masterPeak = 0.0f;
+    float masterSumSq = 0.0f;
+    uint32_t meterFrames = 0;
+
+    uint16_t releaseFrames;
+    ReleaseFn releaseHook = nullptr;
+    void* releaseCtx = nullptr;
+    CycleFn cycleCounter = nullptr;
+
+    uint32_t culledCount = 0;
+    uint32_t stolenCount = 0;
+    uint32_t limiterMaxCycles = 0;
+    bool lastSignal = false;
+
+    void releaseVoice(Voice& v) {
+        if (v.active && releaseHook) releaseHook(v.src.handle, releaseCtx);
+        v.active = false;
+        v.src.handle = nullptr;
+    }
+
+    // Current gain including the choke fade
+    inline float voiceGain(const Voice& v) const {
+        float gain = v.gain;
+        if (v.releaseLeft) gain *= (float)v.releaseLeft / releaseFrames;
+        return gain;
+    }
+
+    // What a voice still has to play: remaining RMS * gain. Without an
+    // envelope (test tone) assume full scale.
+    uint32_t remainingLevel(const Voice& v) const {
+        float gain = voiceGain(v);
+        if (!v.src.envelope) return (uint32_t)(32767 * gain);
+        uint32_t block = v.position / MIX_ENVELOPE_BLOCK;
+        if (block >= v.src.envelopeBlocks) return 0;
+        return (uint32_t)(v.src.envelope[block] * gain);
+    }
+
+    // Inner kernel, specialized on the source layout. Runs in spans of
+    // contiguous PCM: the whole block for PCM16, up to the end of the
+    // decoded codec block otherwise.
+    template <uint8_t SrcChannels>
+    void renderVoice(Voice& v, int16_t* scratch, BusFrame* bus) {
+        const bool coded = sampleCodecIsCoded(v.src.format);
+        size_t i = 0;
+        while (i < BlockFrames) {
+            const int16_t* frame;
+            uint32_t span = v.src.frames - v.position;
+            if (coded) {
+                uint32_t block = v.position / SAMPLE_CODEC_BLOCK;
+                if (block != v.decodedBlock) {
+                    uint32_t blockBytes = sampleCodecBlockBytes(v.src.format, SrcChannels);
+                    sampleCodecDecodeBlock(v.src.format, SrcChannels, v.src.coded + (size_t)block * blockBytes,
+                                           scratch);
+                    v.decodedBlock = block;
+                }
+                uint32_t offset = v.position % SAMPLE_CODEC_BLOCK;
+                frame = scratch + (size_t)offset * SrcChannels;
+                span = std::min<uint32_t>(span, SAMPLE_CODEC_BLOCK - offset);
+            } else {
+                frame = v.src.data + (size_t)v.position * SrcChannels;
+            }
+            span = std::min<uint32_t>(span, (uint32_t)(BlockFrames - i));
+
+            for (uint32_t k = 0; k < span; k++, i++, frame += SrcChannels) {
+                float gain = voiceGain(v);
+                if (SrcChannels == 1) {
+                    int32_t s = (int32_t)(frame[0] * gain);
+                    bus[i].left += s;
+                    bus[i].right += s;
+                } else {
+                    bus[i].left += (int32_t)(frame[0] * gain);
+                    bus[i].right += (int32_t)(frame[1] * gain);
+                }
+                if (v.releaseLeft && --v.releaseLeft == 0) {
+                    releaseVoice(v);  // End of choke fade
+                    return;
+                }
+            }
+
+            v.position += span;
+            if (v.position >= v.src.frames) {
+                releaseVoice(v);  // End of sample
+                return;
+            }
+        }
+    }
+
+    // Fader curve: quadratic, closer to perception than linear
+    static inline float faderGain(uint8_t volume) {
+        float g = volume / 127.0f;
+        return g * g;
+    }
+
+    // Constant-power pan normalized to 0 dB at center, so a centered bus
+    // plays at the voice's own level
+    static void busTargetGains(const Bus& bus, bool anySolo, float& left, float& right) {
+        if (bus.mute || (anySolo && !bus.solo)) {
+            left = right = 0.0f;
+            return;
+        }
+        float gain = faderGain(bus.volume) * 1.41421356f;  // sqrt(2)
+        float theta = (bus.pan + 64) * (float)(M_PI / 2.0 / 128.0);
+        left = gain * std::cos(theta);
+        right = gain * std::sin(theta);
+    }
+
+    MeterReading takeMeter(float& peak, float& sumSq) const {
+        MeterReading reading;
+        reading.peak = (uint16_t)std::min(peak, 65535.0f);
+        reading.rms = meterFrames ? (uint16_t)std::min(std::sqrt(sumSq / meterFrames), 65535.0f) : 0;
+        peak = 0.0f;
+        sumSq = 0.0f;
+        return reading;
+    }
+};
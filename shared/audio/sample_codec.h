@@ -0,0 +1,283 @@
+/**
+ * @file sample_codec.h
+ * @brief Block codecs for samples held compressed in PSRAM
+ * @version 1.0
+ * @date 2025-12-16
+ *
+ * PSRAM capacity is what limits a kit. A kit bundle entry may store its
+ * sample in one of these formats (KitBundleEntry::format) and the mixer
+ * decodes it SAMPLE_CODEC_BLOCK frames at a time into a per-voice scratch
+ * buffer in internal RAM.
+ *
+ * Every format is cut into fixed-size blocks of SAMPLE_CODEC_BLOCK frames
+ * (the last one zero-padded), so block n starts at n * sampleCodecBlockBytes()
+ * and any block decodes on its own: a voice never has to decode from the
+ * start of the sample.
+ *
+ *   KIT_FORMAT_PCM16   plain signed 16-bit, interleaved. Not block coded.
+ *
+ *   KIT_FORMAT_PCM12   near-lossless, 75.8% of PCM16. Per block a 4-byte
+ *                      header (right shift 0-4, shared by all channels) and
+ *                      the interleaved samples as signed 12-bit, two per
+ *                      three bytes. Blocks whose peak fits in 12 bits (tails,
+ *                      soft hits) are lossless; louder blocks lose the
+ *                      bottom 'shift' bits. Decode is 8 samples per three
+ *                      32-bit loads.
+ *
+ *   KIT_FORMAT_ADPCM4  IMA-ADPCM, 4 bits per sample, 25.8% of PCM16. Per
+ *                      block and channel a 4-byte header (first sample, step
+ *                      index) and 255 nibbles. The step state carries over
+ *                      between blocks in the encoder but is stored in each
+ *                      header, so blocks stay independent.
+ *
+ * Shared by the firmware and the host tools (tools/kit_packer,
+ * test/host/test_sample_codec.cpp), so it must not depend on Arduino.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "kit_bundle.h"
+
+// ============================================================
+// DEFAULTS
+// ============================================================
+
+#define SAMPLE_CODEC_BLOCK          256   // Frames per coded block (= mixer / envelope block)
+#define SAMPLE_CODEC_PCM12_HEADER   4     // Bytes: shift, reserved[3]
+#define SAMPLE_CODEC_ADPCM_HEADER   4     // Bytes per channel: int16 sample, uint8 index, reserved
+#define SAMPLE_CODEC_ADPCM_DATA     (SAMPLE_CODEC_BLOCK / 2)  // 255 nibbles per channel, padded to a byte
+
+// ============================================================
+// SIZES
+// ============================================================
+
+/**
+ * @brief true if the format is block coded (needs a decode before mixing)
+ */
+constexpr bool sampleCodecIsCoded(uint8_t format) {
+    return format == KIT_FORMAT_PCM12 || format == KIT_FORMAT_ADPCM4;
+}
+
+constexpr bool sampleCodecIsKnown(uint8_t format) {
+    return format == KIT_FORMAT_PCM16 || sampleCodecIsCoded(format);
+}
+
+/**
+ * @brief Bytes per coded block (0 for PCM16)
+ */
+constexpr uint32_t sampleCodecBlockBytes(uint8_t format, uint8_t channels) {
+    return format == KIT_FORMAT_PCM12
+               ? SAMPLE_CODEC_PCM12_HEADER + SAMPLE_CODEC_BLOCK * channels * 3 / 2
+           : format == KIT_FORMAT_ADPCM4
+               ? (uint32_t)channels * (SAMPLE_CODEC_ADPCM_HEADER + SAMPLE_CODEC_ADPCM_DATA)
+               : 0;
+}
+
+constexpr uint32_t sampleCodecBlocks(uint32_t frames) {
+    return (frames + SAMPLE_CODEC_BLOCK - 1) / SAMPLE_CODEC_BLOCK;
+}
+
+/**
+ * @brief Stored size of a sample in the given format
+ */
+constexpr uint32_t sampleCodecBytes(uint8_t format, uint32_t frames, uint8_t channels) {
+    return sampleCodecIsCoded(format) ? sampleCodecBlocks(frames) * sampleCodecBlockBytes(format, channels)
+                                      : frames * channels * (uint32_t)sizeof(int16_t);
+}
+
+inline const char* sampleCodecName(uint8_t format) {
+    switch (format) {
+        case KIT_FORMAT_PCM16:  return "pcm16";
+        case KIT_FORMAT_PCM12:  return "pcm12";
+        case KIT_FORMAT_ADPCM4: return "adpcm";
+        default:                return "?";
+    }
+}
+
+// ============================================================
+// IMA-ADPCM TABLES
+// ============================================================
+
+namespace sample_codec_detail {
+
+static const int16_t ADPCM_STEPS[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t ADPCM_INDEX[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+struct AdpcmState {
+    int32_t predictor;
+    int32_t index;
+};
+
+// Decoder step, shared by the encoder so both sides track the same state
+inline int16_t adpcmStep(AdpcmState& st, uint8_t nibble) {
+    int32_t step = ADPCM_STEPS[st.index];
+    int32_t diff = step >> 3;
+    if (nibble & 4) diff += step;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 1) diff += step >> 2;
+    st.predictor += (nibble & 8) ? -diff : diff;
+    if (st.predictor > 32767) st.predictor = 32767;
+    if (st.predictor < -32768) st.predictor = -32768;
+    st.index += ADPCM_INDEX[nibble];
+    if (st.index < 0) st.index = 0;
+    if (st.index > 88) st.index = 88;
+    return (int16_t)st.predictor;
+}
+
+inline uint8_t adpcmEncodeSample(AdpcmState& st, int32_t sample) {
+    int32_t step = ADPCM_STEPS[st.index];
+    int32_t diff = sample - st.predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    if (diff >= step >> 1) { nibble |= 2; diff -= step >> 1; }
+    if (diff >= step >> 2) { nibble |= 1; }
+    adpcmStep(st, nibble);
+    return nibble;
+}
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;  // Little-endian host/target
+}
+
+inline int16_t pcm12Sample(uint32_t bits, int shift) {
+    // Sign-extend the 12-bit field, then restore the dropped bits
+    return (int16_t)(((int32_t)(bits << 20) >> 20) * (1 << shift));
+}
+
+}  // namespace sample_codec_detail
+
+// ============================================================
+// DECODE
+// ============================================================
+
+/**
+ * @brief Decode one coded block into SAMPLE_CODEC_BLOCK interleaved frames
+ * @param block Start of the block (sampleCodecBlockBytes() bytes)
+ * @param out   SAMPLE_CODEC_BLOCK * channels samples
+ */
+inline void sampleCodecDecodeBlock(uint8_t format, uint8_t channels, const uint8_t* block, int16_t* out) {
+    using namespace sample_codec_detail;
+
+    if (format == KIT_FORMAT_PCM12) {
+        int shift = block[0];
+        const uint8_t* p = block + SAMPLE_CODEC_PCM12_HEADER;
+        uint32_t count = SAMPLE_CODEC_BLOCK * channels;
+        // 8 samples = 96 bits = three words
+        for (uint32_t i = 0; i < count; i += 8, p += 12) {
+            uint32_t w0 = load32(p), w1 = load32(p + 4), w2 = load32(p + 8);
+            out[i + 0] = pcm12Sample(w0, shift);
+            out[i + 1] = pcm12Sample(w0 >> 12, shift);
+            out[i + 2] = pcm12Sample((w0 >> 24) | (w1 << 8), shift);
+            out[i + 3] = pcm12Sample(w1 >> 4, shift);
+            out[i + 4] = pcm12Sample(w1 >> 16, shift);
+            out[i + 5] = pcm12Sample((w1 >> 28) | (w2 << 4), shift);
+            out[i + 6] = pcm12Sample(w2 >> 8, shift);
+            out[i + 7] = pcm12Sample(w2 >> 20, shift);
+        }
+        return;
+    }
+
+    if (format == KIT_FORMAT_ADPCM4) {
+        for (uint8_t c = 0; c < channels; c++) {
+            const uint8_t* p = block + c * (SAMPLE_CODEC_ADPCM_HEADER + SAMPLE_CODEC_ADPCM_DATA);
+            AdpcmState st = {(int16_t)(p[0] | (p[1] << 8)), p[2] > 88 ? 88 : p[2]};
+            const uint8_t* nibbles = p + SAMPLE_CODEC_ADPCM_HEADER;
+            int16_t* o = out + c;
+            o[0] = (int16_t)st.predictor;
+            // Two samples per byte, low nibble first
+            for (uint32_t i = 1; i + 1 < SAMPLE_CODEC_BLOCK; i += 2) {
+                uint8_t byte = *nibbles++;
+                o[i * channels] = adpcmStep(st, byte & 0x0F);
+                o[(i + 1) * channels] = adpcmStep(st, byte >> 4);
+            }
+            o[(SAMPLE_CODEC_BLOCK - 1) * channels] = adpcmStep(st, *nibbles & 0x0F);
+        }
+        return;
+    }
+}
+
+// ============================================================
+// ENCODE (host packer)
+// ============================================================
+
+/**
+ * @brief Encode interleaved PCM16 into the given block format
+ * @param out sampleCodecBytes(format, frames, channels) bytes
+ */
+inline void sampleCodecEncode(uint8_t format, const int16_t* pcm, uint32_t frames, uint8_t channels, uint8_t* out) {
+    using namespace sample_codec_detail;
+
+    uint32_t blockBytes = sampleCodecBlockBytes(format, channels);
+    uint32_t blocks = sampleCodecBlocks(frames);
+    int16_t buf[SAMPLE_CODEC_BLOCK * 2];
+    AdpcmState carry[2] = {{0, 0}, {0, 0}};
+
+    for (uint32_t b = 0; b < blocks; b++) {
+        // Block frames, zero-padded past the end
+        uint32_t first = b * SAMPLE_CODEC_BLOCK;
+        uint32_t count = frames - first < SAMPLE_CODEC_BLOCK ? frames - first : SAMPLE_CODEC_BLOCK;
+        std::memset(buf, 0, sizeof(buf));
+        std::memcpy(buf, pcm + (size_t)first * channels, count * channels * sizeof(int16_t));
+
+        uint8_t* block = out + (size_t)b * blockBytes;
+        std::memset(block, 0, blockBytes);
+
+        if (format == KIT_FORMAT_PCM12) {
+            // Smallest shift whose rounded samples fit in signed 12 bits
+            uint32_t n = SAMPLE_CODEC_BLOCK * channels;
+            int shift = 0;
+            for (; shift < 4; shift++) {
+                bool fits = true;
+                for (uint32_t i = 0; i < n && fits; i++) {
+                    int32_t v = shift ? (buf[i] + (1 << (shift - 1))) >> shift : buf[i];
+                    fits = v >= -2048 && v <= 2047;
+                }
+                if (fits) break;
+            }
+            block[0] = (uint8_t)shift;
+            uint8_t* p = block + SAMPLE_CODEC_PCM12_HEADER;
+            for (uint32_t i = 0; i < n; i += 2, p += 3) {
+                int32_t v0 = shift ? (buf[i] + (1 << (shift - 1))) >> shift : buf[i];
+                int32_t v1 = shift ? (buf[i + 1] + (1 << (shift - 1))) >> shift : buf[i + 1];
+                if (v0 > 2047) v0 = 2047;
+                if (v1 > 2047) v1 = 2047;
+                uint32_t s0 = (uint32_t)v0 & 0xFFF, s1 = (uint32_t)v1 & 0xFFF;
+                p[0] = (uint8_t)s0;
+                p[1] = (uint8_t)((s0 >> 8) | (s1 << 4));
+                p[2] = (uint8_t)(s1 >> 4);
+            }
+        } else if (format == KIT_FORMAT_ADPCM4) {
+            for (uint8_t c = 0; c < channels; c++) {
+                uint8_t* p = block + c * (SAMPLE_CODEC_ADPCM_HEADER + SAMPLE_CODEC_ADPCM_DATA);
+                AdpcmState st = {buf[c], carry[c].index};
+                p[0] = (uint8_t)(st.predictor & 0xFF);
+                p[1] = (uint8_t)((st.predictor >> 8) & 0xFF);
+                p[2] = (uint8_t)st.index;
+                uint8_t* nibbles = p + SAMPLE_CODEC_ADPCM_HEADER;
+                for (uint32_t i = 1; i < SAMPLE_CODEC_BLOCK; i++) {
+                    uint8_t nibble = adpcmEncodeSample(st, buf[i * channels + c]);
+                    uint32_t k = i - 1;
+                    nibbles[k / 2] |= (k & 1) ? (uint8_t)(nibble << 4) : nibble;
+                }
+                carry[c] = st;
+            }
+        }
+    }
+}
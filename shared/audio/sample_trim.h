@@ -0,0 +1,136 @@
+/**
+ * @file sample_trim.h
+ * @brief Leading-silence trimming and tail truncation for one-shot samples
+ * @version 1.0
+ * @date 2025-12-12
+ *
+ * Drum WAVs often start with a few milliseconds of near-silence, and the voice
+ * always starts at frame 0, so that silence adds directly to hit latency. The
+ * decay below audibility only costs PSRAM and mixer cycles.
+ *
+ * analyzeSampleTrim() finds:
+ *   - the onset: first frame above (peak + onsetDb), minus a short pre-roll so
+ *     the attack transient is kept intact;
+ *   - the tail: last frame above (peak + tailFloorDb), plus a short fade.
+ * applySampleTrim() moves the kept frames to the start of the buffer and fades
+ * out the cut, so the caller can shrink the allocation.
+ *
+ * Shared by the firmware (WAV load) and the host-side packer (kit bundles),
+ * so it must not depend on Arduino.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// ============================================================
+// DEFAULTS
+// ============================================================
+
+#define SAMPLE_TRIM_ONSET_DB       -40.0f  // Onset threshold relative to peak
+#define SAMPLE_TRIM_PREROLL_US     250     // Kept before the onset
+#define SAMPLE_TRIM_TAIL_FLOOR_DB  -60.0f  // Tail floor relative to peak
+#define SAMPLE_TRIM_FADE_MS        5       // Fade-out at the cut
+
+struct SampleTrimConfig {
+    float onsetDb;
+    uint32_t prerollUs;
+    float tailFloorDb;
+    uint32_t fadeMs;
+};
+
+constexpr SampleTrimConfig SAMPLE_TRIM_DEFAULTS = {
+    SAMPLE_TRIM_ONSET_DB,
+    SAMPLE_TRIM_PREROLL_US,
+    SAMPLE_TRIM_TAIL_FLOOR_DB,
+    SAMPLE_TRIM_FADE_MS
+};
+
+struct SampleTrim {
+    uint32_t startFrame;   // First frame kept
+    uint32_t endFrame;     // One past the last frame kept
+    uint32_t fadeFrames;   // Fade-out length ending at endFrame (0 = tail not cut)
+    int32_t peak;          // Absolute peak (0 = silent sample, left untouched)
+};
+
+// ============================================================
+// HELPERS
+// ============================================================
+
+inline int32_t sampleTrimLevel(float db, int32_t peak) {
+    int32_t level = (int32_t)(peak * std::pow(10.0f, db / 20.0f));
+    return level > 0 ? level : 1;
+}
+
+// Largest absolute value across the channels of one frame
+inline int32_t sampleTrimMagnitude(const int16_t* pcm, uint32_t frame, uint8_t channels) {
+    int32_t mag = 0;
+    for (uint8_t c = 0; c < channels; c++) {
+        int32_t v = pcm[frame * channels + c];
+        if (v < 0) v = -v;
+        if (v > mag) mag = v;
+    }
+    return mag;
+}
+
+/**
+ * @brief Find the audible range of a one-shot sample
+ */
+inline SampleTrim analyzeSampleTrim(const int16_t* pcm, uint32_t frames, uint8_t channels,
+                                    uint32_t sampleRate,
+                                    const SampleTrimConfig& cfg = SAMPLE_TRIM_DEFAULTS) {
+    SampleTrim trim = {0, frames, 0, 0};
+    for (uint32_t f = 0; f < frames; f++) {
+        int32_t mag = sampleTrimMagnitude(pcm, f, channels);
+        if (mag > trim.peak) trim.peak = mag;
+    }
+    if (trim.peak == 0) return trim;
+
+    int32_t onsetLevel = sampleTrimLevel(cfg.onsetDb, trim.peak);
+    uint32_t onset = 0;
+    while (onset < frames && sampleTrimMagnitude(pcm, onset, channels) < onsetLevel) onset++;
+    uint32_t preroll = (uint32_t)((uint64_t)sampleRate * cfg.prerollUs / 1000000);
+    trim.startFrame = onset > preroll ? onset - preroll : 0;
+
+    int32_t floorLevel = sampleTrimLevel(cfg.tailFloorDb, trim.peak);
+    uint32_t last = frames - 1;
+    while (last > trim.startFrame && sampleTrimMagnitude(pcm, last, channels) < floorLevel) last--;
+    uint32_t fade = (uint32_t)((uint64_t)sampleRate * cfg.fadeMs / 1000);
+    uint64_t end = (uint64_t)last + 1 + fade;
+    if (end < frames) {
+        trim.endFrame = (uint32_t)end;
+        trim.fadeFrames = fade;
+    }
+    return trim;
+}
+
+/**
+ * @brief Move the kept range to the start of the buffer and fade out the cut
+ * @return Frames kept
+ */
+inline uint32_t applySampleTrim(int16_t* pcm, uint8_t channels, const SampleTrim& trim) {
+    uint32_t kept = trim.endFrame - trim.startFrame;
+    if (trim.startFrame > 0) {
+        std::memmove(pcm, pcm + (size_t)trim.startFrame * channels, (size_t)kept * channels * sizeof(int16_t));
+    }
+
+    uint32_t fade = trim.fadeFrames < kept ? trim.fadeFrames : kept;
+    for (uint32_t i = 0; i < fade; i++) {
+        // Linear ramp from ~1 to 0 over the last 'fade' frames (Q15)
+        int32_t gain = (int32_t)(((uint64_t)(fade - i) << 15) / (fade + 1));
+        int16_t* frame = pcm + (size_t)(kept - fade + i) * channels;
+        for (uint8_t c = 0; c < channels; c++) {
+            frame[c] = (int16_t)((frame[c] * gain) >> 15);
+        }
+    }
+    return kept;
+}
+
+/**
+ * @brief Milliseconds represented by a number of frames
+ */
+inline float sampleTrimMs(uint32_t frames, uint32_t sampleRate) {
+    return sampleRate ? frames * 1000.0f / sampleRate : 0.0f;
+}
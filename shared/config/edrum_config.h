@@ -47,6 +47,21 @@ extern const char* PAD_NAMES[4];
 #define SAMPLE_PATH_HIHAT  "/samples/default/hihat.wav"
 #define SAMPLE_PATH_TOM    "/samples/default/tom.wav"
 
+// Default kit bundle (built with tools/kit_packer, see kit_bundle.h)
+#define KIT_BUNDLE_DEFAULT_PATH "/kits/default.kit"
+
+// Built-in kit: same bundle format, written to a flash data partition
+// (partitions_kit_16MB.csv) and played memory-mapped, without SD or PSRAM copy
+#define KIT_PARTITION_LABEL   "kit"
+#define KIT_PARTITION_SUBTYPE 0x40
+
+// SD SPI clock negotiation: candidates are tried fastest first and accepted
+// only if SD_PROBE_SECTORS read back with the same CRC as at SD_SAFE_CLOCK_HZ
+#define SD_SAFE_CLOCK_HZ     4000000
+#define SD_FALLBACK_CLOCK_HZ 1000000
+#define SD_PROBE_SECTORS     16
+#define SD_PROBE_PASSES      2
+
 // --- MIDI OUTPUT ---
 // NOTA: Se usa USB MIDI nativo (TinyUSB), no hardware serial
 #define MIDI_BAUD   31250   // Solo referencia para futuro uso
@@ -84,6 +99,12 @@ extern const char* PAD_NAMES[4];
 #define UART_RX_PIN 1    // RX desde display (antes 44)
 #define UART_BAUD   921600
 
+// Telemetry scheduler (UARTProtocol::flushTelemetry): one batch frame per tick
+#define UART_TX_BUFFER_SIZE 4096          // Driver TX ring: writes return at once while it has room
+#define UART_TX_TICK_US 5000              // Hits, pad states and meters packed per tick
+#define UART_TX_LOW_WATER 1024            // Free TX bytes needed before non-essential telemetry goes out
+#define UART_TX_PAD_STATE_PERIOD_US 20000 // Pad state updates per pad, at most 50 Hz
+
 // ============================================================
 // HARDWARE PIN DEFINITIONS - MCU #2 (Display)
 // ============================================================
@@ -123,6 +144,7 @@ extern const char* PAD_NAMES[4];
 // UART from MCU #1
 #define UART_RX_DISPLAY  16  // RX (display) connected to main TX (GPIO 2)
 #define UART_TX_DISPLAY  17  // TX (display) connected to main RX (GPIO 1)
+#define CONFIG_RESYNC_RETRY_MS 500  // Min time between config snapshot requests
 
 #endif // MCU_DISPLAY
 
@@ -176,9 +198,37 @@ extern const CRGB PAD_LED_COLORS[4];                 // Use cfg.ledColorHit
 #define MIDI_VELOCITY_MIN 1
 #define MIDI_VELOCITY_MAX 127
 
+// High-resolution velocity: 16-bit (MIDI 2.0 scale) from a per-pad curve LUT.
+// The 7-bit velocity is always (hiRes >> 9), so both stay consistent.
+#define VELOCITY_LUT_BITS 10                 // 1024 segments over the calibrated peak range
+#define VELOCITY_HIRES_MIN (MIDI_VELOCITY_MIN << 9)
+#define MIDI_CC_HIRES_VELOCITY 88            // MIDI 1.0 High Resolution Velocity Prefix
+#define MIDI_HIRES_VELOCITY_DEFAULT false    // Send the CC88 prefix before each note-on
+
+// MIDI input: incoming note-ons play the kit (note -> pad map, any channel).
+// Off at boot ('i' toggles it): a DAW track that echoes the controller's own
+// notes back (MIDI thru / input monitoring) would trigger every pad twice.
+#define MIDI_INPUT_SOUND_MODULE_DEFAULT false
+#define MIDI_CLOCK_DRIVES_BPM true           // Show the tempo of incoming MIDI clock on the display
+#define MIDI_CLOCK_TIMEOUT_MS 1000           // No clock for this long = tempo unknown
+#define TEMPO_BROADCAST_PERIOD_MS 250
+
 // Auto Note-Off timing (milliseconds)
 #define MIDI_NOTE_OFF_DELAY_MS 100
 
+// ============================================================
+// MIXER CONFIGURATION
+// ============================================================
+
+// Meter frames to the display (MSG_MIXER_METERS)
+#define MIXER_METER_RATE_HZ 30
+#define MIXER_METER_PERIOD_US (1000000 / MIXER_METER_RATE_HZ)
+#define MIXER_METER_FLOOR_DB -60.0f   // Meter level 0 (0 dBFS = 127)
+
+// Master volume on the right encoder (0-127)
+#define MASTER_VOLUME_DEFAULT 127
+#define MASTER_VOLUME_STEP 4
+
 // ============================================================
 // LED ANIMATION CONFIGURATION
 // ============================================================
@@ -210,27 +260,41 @@ extern const CRGB PAD_LED_COLORS[4];                 // Use cfg.ledColorHit
 #define TASK_STACK_LED_ANIMATION 4096
 #define TASK_STACK_UART_COMM     4096
 #define TASK_STACK_BUTTON_READER 2048
+#define TASK_STACK_SAMPLE_LOADER 6144  // FATFS + SD SPI driver need the extra room
+#define TASK_STACK_AUDIO_TRIGGER 4096
+#define TASK_STACK_LOG_DRAIN     3072
 
 // Task Priorities (0-24, higher = more priority)
 #define TASK_PRIORITY_TRIGGER_SCAN  24  // Highest - real-time trigger detection
+#define TASK_PRIORITY_AUDIO_TRIGGER 19  // Bus → voice start (below the mixer, above MIDI)
 #define TASK_PRIORITY_UART_COMM     15  // High - communication
-#define TASK_PRIORITY_MIDI_OUTPUT   10  // Medium - MIDI output
+#define TASK_PRIORITY_MIDI_OUTPUT   18  // High - USB MIDI to the DAW (below the mixer, above UART)
 #define TASK_PRIORITY_LED_ANIMATION 5   // Low - visual feedback
 #define TASK_PRIORITY_BUTTON_READER 5   // Low - user input
+#define TASK_PRIORITY_SAMPLE_LOADER 2   // Lowest - background SD reads
+#define TASK_PRIORITY_LOG_DRAIN     1   // Below everything but idle - Serial may block here
 
 // Core Assignment
 #define TASK_CORE_TRIGGER_SCAN   0  // Core 0: Real-time trigger scanning
 #define TASK_CORE_MIDI_OUTPUT    1  // Core 1: MIDI and communication
+#define TASK_CORE_AUDIO_TRIGGER  1  // Core 1: next to the mixer
 #define TASK_CORE_LED_ANIMATION  1  // Core 1: LED animations
 #define TASK_CORE_UART_COMM      1  // Core 1: UART communication
+#define TASK_CORE_SAMPLE_LOADER  0  // Core 0: keeps SD reads away from the mixer
+#define TASK_CORE_LOG_DRAIN      0  // Core 0: Serial writes stay off the audio core
 
 // ============================================================
 // QUEUE SIZES
 // ============================================================
 
 #define QUEUE_SIZE_HIT_EVENTS  16   // Buffer for hit events (trigger → MIDI)
-#define QUEUE_SIZE_UART_TX     32   // UART transmit buffer
+#define QUEUE_SIZE_MIDI_EVENTS 64   // Lock-free ring into the MIDI task (power of two)
+#define QUEUE_SIZE_BUS_INBOX   16   // Per-subscriber event bus inbox (power of two)
+#define BUS_MAX_SUBSCRIBERS    6
+#define QUEUE_SIZE_LOG_RECORDS 128  // Deferred log ring (power of two)
+#define QUEUE_SIZE_UART_TX     32   // Hits waiting for the next telemetry batch
 #define QUEUE_SIZE_UART_RX     32   // UART receive buffer
+#define QUEUE_SIZE_SAMPLE_LOAD 8    // Pending sample/kit load requests
 
 // ============================================================
 // DEBUG CONFIGURATION
@@ -240,6 +304,10 @@ extern const CRGB PAD_LED_COLORS[4];                 // Use cfg.ledColorHit
 #define DEBUG_SERIAL_ENABLE
 #define DEBUG_BAUD_RATE 115200
 
+// Deferred log (core/log_ring.h): drain period and output format at boot
+#define LOG_DRAIN_PERIOD_MS 20
+#define LOG_BINARY_DEFAULT false  // true = binary frames for tools/log_decode
+
 // Debug output levels
 // #define DEBUG_TRIGGER_RAW        // Print raw ADC values
 // #define DEBUG_TRIGGER_EVENTS     // Print hit events with velocity
@@ -290,6 +358,15 @@ enum ButtonState {
 #define TEMP_WARNING_CELSIUS 70
 #define TEMP_SHUTDOWN_CELSIUS 85
 
+// Memory health (SystemWatchdog)
+#define HEAP_WARNING_BYTES (32 * 1024)           // Internal RAM left for stacks/DMA
+#define PSRAM_WARNING_BYTES (64 * 1024)          // PSRAM outside the sample arena
+#define SAMPLE_ARENA_FRAG_WARNING_PCT 50         // Warn if largest free block < half of free arena
+
+// Per-core load (SystemWatchdog): while measuring, the idle tasks never
+// reach WFI, so it is off at boot and toggled from the serial console
+#define CPU_LOAD_MEASURE_DEFAULT false
+
 // ============================================================
 // VERSION INFORMATION
 // ============================================================
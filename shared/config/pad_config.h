@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <cstring>
 #include <edrum_config.h>
+#include <config_sync.h>
 
 // ============================================================================
 // PAD CONFIGURATION STRUCTURE
@@ -35,6 +36,7 @@ struct PadConfig {
     char sampleName[32];         // Sample filename (full path)
     uint8_t sampleVolume;        // Volume (0-100)
     int8_t samplePitch;          // Pitch shift in semitones (-12 to +12)
+    uint8_t chokeGroup;          // Choke group (0=none, 1-8): a hit cuts ringing voices of the same group
 
     // === VISUAL ===
     uint32_t ledColorHit;        // RGB color on hit (0xRRGGBB)
@@ -47,6 +49,7 @@ struct PadConfig {
     uint16_t rimThreshold;       // Rim threshold if dual-zone
     uint8_t rimMidiNote;         // Rim MIDI note
     char rimSampleName[32];      // Rim sample filename
+    uint8_t rimChokeGroup;       // Rim choke group (0=none, 1-8)
 
     // === METADATA ===
     char name[16];               // User-defined pad name (e.g., "Snare", "Kick")
@@ -77,6 +80,7 @@ inline PadConfig makeKickConfig() {
     cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
     cfg.sampleVolume = 100;
     cfg.samplePitch = 0;
+    cfg.chokeGroup = 0;
     cfg.ledColorHit = 0xFF0000;
     cfg.ledColorIdle = 0x330000;
     cfg.ledBrightness = 80;
@@ -85,6 +89,7 @@ inline PadConfig makeKickConfig() {
     cfg.rimThreshold = 0;
     cfg.rimMidiNote = 0;
     cfg.rimSampleName[0] = '\0';
+    cfg.rimChokeGroup = 0;
     std::strncpy(cfg.name, "PAD1", sizeof(cfg.name));
     cfg.name[sizeof(cfg.name) - 1] = '\0';
     cfg.padType = 0;
@@ -111,6 +116,7 @@ inline PadConfig makeSnareConfig() {
     cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
     cfg.sampleVolume = 95;
     cfg.samplePitch = 0;
+    cfg.chokeGroup = 0;
     cfg.ledColorHit = 0x00FF00;
     cfg.ledColorIdle = 0x003300;
     cfg.ledBrightness = 80;
@@ -120,6 +126,7 @@ inline PadConfig makeSnareConfig() {
     cfg.rimMidiNote = 40;
     std::strncpy(cfg.rimSampleName, "snare_rim_001.wav", sizeof(cfg.rimSampleName));
     cfg.rimSampleName[sizeof(cfg.rimSampleName) - 1] = '\0';
+    cfg.rimChokeGroup = 0;
     std::strncpy(cfg.name, "PAD2", sizeof(cfg.name));
     cfg.name[sizeof(cfg.name) - 1] = '\0';
     cfg.padType = 1;
@@ -146,6 +153,7 @@ inline PadConfig makeHiHatConfig() {
     cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
     cfg.sampleVolume = 85;
     cfg.samplePitch = 0;
+    cfg.chokeGroup = 1;
     cfg.ledColorHit = 0x00FFFF;
     cfg.ledColorIdle = 0x003333;
     cfg.ledBrightness = 80;
@@ -155,6 +163,7 @@ inline PadConfig makeHiHatConfig() {
     cfg.rimMidiNote = 46;
     std::strncpy(cfg.rimSampleName, "hihat_open_001.wav", sizeof(cfg.rimSampleName));
     cfg.rimSampleName[sizeof(cfg.rimSampleName) - 1] = '\0';
+    cfg.rimChokeGroup = 1;
     std::strncpy(cfg.name, "PAD3", sizeof(cfg.name));
     cfg.name[sizeof(cfg.name) - 1] = '\0';
     cfg.padType = 4;
@@ -181,6 +190,7 @@ inline PadConfig makeTomConfig() {
     cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
     cfg.sampleVolume = 90;
     cfg.samplePitch = 0;
+    cfg.chokeGroup = 0;
     cfg.ledColorHit = 0x0000FF;
     cfg.ledColorIdle = 0x000033;
     cfg.ledBrightness = 80;
@@ -189,6 +199,7 @@ inline PadConfig makeTomConfig() {
     cfg.rimThreshold = 0;
     cfg.rimMidiNote = 0;
     cfg.rimSampleName[0] = '\0';
+    cfg.rimChokeGroup = 0;
     std::strncpy(cfg.name, "PAD4", sizeof(cfg.name));
     cfg.name[sizeof(cfg.name) - 1] = '\0';
     cfg.padType = 2;
@@ -201,6 +212,17 @@ const PadConfig DEFAULT_SNARE_CONFIG = makeSnareConfig();
 const PadConfig DEFAULT_HIHAT_CONFIG = makeHiHatConfig();
 const PadConfig DEFAULT_TOM_CONFIG = makeTomConfig();
 
+// Choke groups 1-8 map to bits 0-7 of a choke mask
+#define PAD_CHOKE_GROUPS 8
+
+inline uint8_t chokeGroupMask(uint8_t group) {
+    return (group >= 1 && group <= PAD_CHOKE_GROUPS) ? (uint8_t)(1u << (group - 1)) : 0;
+}
+
+// Note -> pad map entries (MIDI input)
+#define PAD_NOTE_NONE 0xFF
+#define PAD_NOTE_RIM  0x80   // Entry plays the rim zone
+
 // ============================================================================
 // CONFIGURATION MANAGEMENT
 // ============================================================================
@@ -226,6 +248,17 @@ public:
     static void setSample(uint8_t padId, const char* filename);
     static void setLEDColor(uint8_t padId, uint32_t hitColor, uint32_t idleColor);
     static void setCrosstalk(uint8_t padId, bool enabled, uint16_t window, float ratio);
+    static void setChokeGroup(uint8_t padId, uint8_t group, uint8_t rimGroup);
+
+    // Choke mask for a pad zone, resolved when the config changes (O(1) on the hit path)
+    static uint8_t getChokeMask(uint8_t padId, bool rim = false);
+
+    // Pad zone that plays an incoming MIDI note (false = note not mapped). Same table
+    // lifetime as the choke masks: safe to read from the MIDI task.
+    static bool padForNote(uint8_t note, uint8_t& padId, bool& rim);
+
+    // Rebuild choke masks and the note -> pad map after a config change
+    static void compileLookups();
 
     // Bulk operations
     static void resetToDefaults(uint8_t padId);
@@ -235,8 +268,20 @@ public:
     static String exportJSON();
     static bool importJSON(const String& json);
 
+    // Pending display sync. Every change made through this class marks the
+    // fields it touched; code that edits getConfig() in place calls
+    // markChanged() itself. The main brain's UART link takes the marks on
+    // its next tick and sends a config delta (or a snapshot for bulk changes).
+    // Masks are built with configFieldBit() (config_sync.h).
+    static void markChanged(uint8_t padId, uint32_t fieldMask);
+    static void markChanged();  // Every field of every pad
+    static uint32_t takePendingFields(uint8_t padId);
+
 private:
     static PadConfig configs[8];  // Support up to 8 pads
+    static uint32_t pendingFields[8];
+    static uint8_t chokeMasks[8][2];  // [pad][0=head, 1=rim]
+    static uint8_t noteMap[128];      // pad | PAD_NOTE_RIM, or PAD_NOTE_NONE
 };
 
 #endif // PAD_CONFIG_H
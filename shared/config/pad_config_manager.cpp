@@ -4,6 +4,84 @@
 
 // Static member initialization
 PadConfig PadConfigManager::configs[8];
+uint8_t PadConfigManager::chokeMasks[8][2] = {};
+uint8_t PadConfigManager::noteMap[128];
+uint32_t PadConfigManager::pendingFields[8] = {};
+
+// NVS layout of the "padN" blobs, stored under "cfgver". Blobs written
+// before the key existed are v1 (no choke groups) and are migrated on load.
+#define PAD_CONFIG_NVS_VERSION 2
+
+namespace {
+
+// PadConfig as stored by v1 firmware. Frozen: never edit.
+struct PadConfigV1 {
+    uint16_t threshold;
+    uint16_t velocityMin;
+    uint16_t velocityMax;
+    float velocityCurve;
+    bool crosstalkEnabled;
+    uint16_t crosstalkWindow;
+    float crosstalkRatio;
+    uint8_t crosstalkMask;
+    uint16_t peakWindowMs;
+    uint16_t decayTimeMs;
+    uint8_t minRetriggerMs;
+    uint8_t midiNote;
+    uint8_t midiChannel;
+    char sampleName[32];
+    uint8_t sampleVolume;
+    int8_t samplePitch;
+    uint32_t ledColorHit;
+    uint32_t ledColorIdle;
+    uint8_t ledBrightness;
+    uint16_t ledFadeDuration;
+    bool dualZoneEnabled;
+    uint16_t rimThreshold;
+    uint8_t rimMidiNote;
+    char rimSampleName[32];
+    char name[16];
+    uint8_t padType;
+    bool enabled;
+};
+
+// Fields added since v1 keep their "off" value (no choke), as on v1
+void migrateV1(const PadConfigV1& old, PadConfig& cfg) {
+    cfg = PadConfig{};
+    cfg.threshold = old.threshold;
+    cfg.velocityMin = old.velocityMin;
+    cfg.velocityMax = old.velocityMax;
+    cfg.velocityCurve = old.velocityCurve;
+    cfg.crosstalkEnabled = old.crosstalkEnabled;
+    cfg.crosstalkWindow = old.crosstalkWindow;
+    cfg.crosstalkRatio = old.crosstalkRatio;
+    cfg.crosstalkMask = old.crosstalkMask;
+    cfg.peakWindowMs = old.peakWindowMs;
+    cfg.decayTimeMs = old.decayTimeMs;
+    cfg.minRetriggerMs = old.minRetriggerMs;
+    cfg.midiNote = old.midiNote;
+    cfg.midiChannel = old.midiChannel;
+    memcpy(cfg.sampleName, old.sampleName, sizeof(cfg.sampleName));
+    cfg.sampleVolume = old.sampleVolume;
+    cfg.samplePitch = old.samplePitch;
+    cfg.chokeGroup = 0;
+    cfg.ledColorHit = old.ledColorHit;
+    cfg.ledColorIdle = old.ledColorIdle;
+    cfg.ledBrightness = old.ledBrightness;
+    cfg.ledFadeDuration = old.ledFadeDuration;
+    cfg.dualZoneEnabled = old.dualZoneEnabled;
+    cfg.rimThreshold = old.rimThreshold;
+    cfg.rimMidiNote = old.rimMidiNote;
+    memcpy(cfg.rimSampleName, old.rimSampleName, sizeof(cfg.rimSampleName));
+    cfg.rimChokeGroup = 0;
+    memcpy(cfg.name, old.name, sizeof(cfg.name));
+    cfg.padType = old.padType;
+    cfg.enabled = old.enabled;
+}
+
+bool nvsMigrated = false;  // Set by loadFromNVS() when it converted v1 blobs
+
+} // namespace
 
 // ============================================================================
 // INITIALIZATION
@@ -20,11 +98,16 @@ void PadConfigManager::init() {
 
     // Load from NVS, or use defaults if not found
     if (!loadFromNVS()) {
-        Serial.println("[CONFIG] No saved config found, using defaults");
+        Serial.println("[CONFIG] No usable saved config, using defaults");
         resetAllToDefaults();
     } else {
         Serial.println("[CONFIG] Loaded configuration from NVS");
+        if (nvsMigrated) {
+            // Rewrite in the current layout so the next boot loads it directly
+            saveToNVS();
+        }
     }
+    compileLookups();
 }
 
 // ============================================================================
@@ -37,6 +120,9 @@ bool PadConfigManager::loadFromNVS() {
         return false;
     }
 
+    // Decode into a copy: a rejected blob must not leave pads half loaded
+    PadConfig loaded[4];
+    uint8_t version = prefs.getUChar("cfgver", 1);
     bool success = true;
     for (uint8_t i = 0; i < 4; i++) {  // Load 4 pads
         char key[16];
@@ -48,15 +134,31 @@ bool PadConfigManager::loadFromNVS() {
         }
 
         size_t len = prefs.getBytesLength(key);
-        if (len == sizeof(PadConfig)) {
-            prefs.getBytes(key, &configs[i], sizeof(PadConfig));
+        if (version == PAD_CONFIG_NVS_VERSION && len == sizeof(PadConfig)) {
+            prefs.getBytes(key, &loaded[i], sizeof(PadConfig));
+        } else if (version == 1 && len == sizeof(PadConfigV1)) {
+            PadConfigV1 old;
+            prefs.getBytes(key, &old, sizeof(old));
+            migrateV1(old, loaded[i]);
         } else {
+            Serial.printf("[CONFIG] %s: NVS layout v%u, %u bytes not supported (expected v%u, %u bytes)\n",
+                          key, version, (unsigned)len, PAD_CONFIG_NVS_VERSION, (unsigned)sizeof(PadConfig));
             success = false;
             break;
         }
     }
 
     prefs.end();
+    if (success) {
+        nvsMigrated = version != PAD_CONFIG_NVS_VERSION;
+        if (nvsMigrated) {
+            Serial.printf("[CONFIG] Migrated pad config from NVS layout v%u to v%u\n", version,
+                          PAD_CONFIG_NVS_VERSION);
+        }
+        memcpy(configs, loaded, sizeof(loaded));
+        compileLookups();
+        markChanged();
+    }
     return success;
 }
 
@@ -71,6 +173,7 @@ bool PadConfigManager::saveToNVS() {
         snprintf(key, sizeof(key), "pad%d", i);
         prefs.putBytes(key, &configs[i], sizeof(PadConfig));
     }
+    prefs.putUChar("cfgver", PAD_CONFIG_NVS_VERSION);
 
     prefs.end();
     Serial.println("[CONFIG] Configuration saved to NVS");
@@ -89,6 +192,26 @@ PadConfig& PadConfigManager::getConfig(uint8_t padId) {
 void PadConfigManager::setConfig(uint8_t padId, const PadConfig& config) {
     if (padId >= 8) return;
     configs[padId] = config;
+    compileLookups();
+    markChanged(padId, CONFIG_FIELDS_ALL);
+}
+
+void PadConfigManager::markChanged(uint8_t padId, uint32_t fieldMask) {
+    if (padId >= 8) return;
+    pendingFields[padId] |= fieldMask;
+}
+
+void PadConfigManager::markChanged() {
+    for (uint8_t i = 0; i < 8; i++) {
+        pendingFields[i] = CONFIG_FIELDS_ALL;
+    }
+}
+
+uint32_t PadConfigManager::takePendingFields(uint8_t padId) {
+    if (padId >= 8) return 0;
+    uint32_t fields = pendingFields[padId];
+    pendingFields[padId] = 0;
+    return fields;
 }
 
 // ============================================================================
@@ -98,34 +221,41 @@ void PadConfigManager::setConfig(uint8_t padId, const PadConfig& config) {
 void PadConfigManager::setThreshold(uint8_t padId, uint16_t value) {
     if (padId >= 8) return;
     configs[padId].threshold = constrain(value, 50, 2000);
+    markChanged(padId, configFieldBit(CFG_THRESHOLD));
 }
 
 void PadConfigManager::setVelocityRange(uint8_t padId, uint16_t min, uint16_t max) {
     if (padId >= 8) return;
     configs[padId].velocityMin = constrain(min, 50, 1000);
     configs[padId].velocityMax = constrain(max, 500, 4000);
+    markChanged(padId, configFieldBit(CFG_VELOCITY_MIN) | configFieldBit(CFG_VELOCITY_MAX));
 }
 
 void PadConfigManager::setVelocityCurve(uint8_t padId, float curve) {
     if (padId >= 8) return;
     configs[padId].velocityCurve = constrain(curve, 0.3f, 2.0f);
+    markChanged(padId, configFieldBit(CFG_VELOCITY_CURVE));
 }
 
 void PadConfigManager::setMidiNote(uint8_t padId, uint8_t note) {
     if (padId >= 8) return;
     configs[padId].midiNote = (note > 127) ? 127 : note;
+    compileLookups();
+    markChanged(padId, configFieldBit(CFG_MIDI_NOTE));
 }
 
 void PadConfigManager::setSample(uint8_t padId, const char* filename) {
     if (padId >= 8) return;
     strncpy(configs[padId].sampleName, filename, 31);
     configs[padId].sampleName[31] = '\0';
+    markChanged(padId, configFieldBit(CFG_SAMPLE_NAME));
 }
 
 void PadConfigManager::setLEDColor(uint8_t padId, uint32_t hitColor, uint32_t idleColor) {
     if (padId >= 8) return;
     configs[padId].ledColorHit = hitColor;
     configs[padId].ledColorIdle = idleColor;
+    markChanged(padId, configFieldBit(CFG_LED_COLOR_HIT) | configFieldBit(CFG_LED_COLOR_IDLE));
 }
 
 void PadConfigManager::setCrosstalk(uint8_t padId, bool enabled, uint16_t window, float ratio) {
@@ -133,6 +263,56 @@ void PadConfigManager::setCrosstalk(uint8_t padId, bool enabled, uint16_t window
     configs[padId].crosstalkEnabled = enabled;
     configs[padId].crosstalkWindow = constrain(window, 10, 200);
     configs[padId].crosstalkRatio = constrain(ratio, 0.3f, 0.95f);
+    markChanged(padId, configFieldBit(CFG_CROSSTALK_ENABLED) | configFieldBit(CFG_CROSSTALK_WINDOW) |
+                         configFieldBit(CFG_CROSSTALK_RATIO));
+}
+
+void PadConfigManager::setChokeGroup(uint8_t padId, uint8_t group, uint8_t rimGroup) {
+    if (padId >= 8) return;
+    configs[padId].chokeGroup = (group > PAD_CHOKE_GROUPS) ? 0 : group;
+    configs[padId].rimChokeGroup = (rimGroup > PAD_CHOKE_GROUPS) ? 0 : rimGroup;
+    compileLookups();
+    markChanged(padId, configFieldBit(CFG_CHOKE_GROUP) | configFieldBit(CFG_RIM_CHOKE_GROUP));
+}
+
+// ============================================================================
+// CHOKE MASKS + NOTE MAP
+// ============================================================================
+
+uint8_t PadConfigManager::getChokeMask(uint8_t padId, bool rim) {
+    if (padId >= 8) return 0;
+    return chokeMasks[padId][rim ? 1 : 0];
+}
+
+void PadConfigManager::compileLookups() {
+    for (uint8_t i = 0; i < 8; i++) {
+        const PadConfig& cfg = configs[i];
+        chokeMasks[i][0] = cfg.enabled ? chokeGroupMask(cfg.chokeGroup) : 0;
+        chokeMasks[i][1] = (cfg.enabled && cfg.dualZoneEnabled) ? chokeGroupMask(cfg.rimChokeGroup) : 0;
+    }
+
+    // Note -> pad for MIDI input. Heads first, then rims; the lowest pad wins a shared note.
+    // Built aside and copied in one step: the MIDI task reads noteMap while
+    // this runs and must never see the cleared table.
+    uint8_t built[sizeof(noteMap)];
+    memset(built, PAD_NOTE_NONE, sizeof(built));
+    for (uint8_t i = NUM_PADS; i-- > 0;) {
+        const PadConfig& cfg = configs[i];
+        if (cfg.enabled && cfg.dualZoneEnabled) built[cfg.rimMidiNote & 0x7F] = i | PAD_NOTE_RIM;
+    }
+    for (uint8_t i = NUM_PADS; i-- > 0;) {
+        const PadConfig& cfg = configs[i];
+        if (cfg.enabled) built[cfg.midiNote & 0x7F] = i;
+    }
+    memcpy(noteMap, built, sizeof(noteMap));
+}
+
+bool PadConfigManager::padForNote(uint8_t note, uint8_t& padId, bool& rim) {
+    uint8_t entry = noteMap[note & 0x7F];
+    if (entry == PAD_NOTE_NONE) return false;
+    padId = entry & ~PAD_NOTE_RIM;
+    rim = (entry & PAD_NOTE_RIM) != 0;
+    return true;
 }
 
 // ============================================================================
@@ -148,6 +328,8 @@ void PadConfigManager::resetToDefaults(uint8_t padId) {
         case 2: configs[2] = DEFAULT_HIHAT_CONFIG; break;
         case 3: configs[3] = DEFAULT_TOM_CONFIG; break;
     }
+    compileLookups();
+    markChanged(padId, CONFIG_FIELDS_ALL);
 
     Serial.printf("[CONFIG] Pad %d reset to defaults\n", padId);
 }
@@ -157,12 +339,14 @@ void PadConfigManager::resetAllToDefaults() {
     configs[1] = DEFAULT_SNARE_CONFIG;
     configs[2] = DEFAULT_HIHAT_CONFIG;
     configs[3] = DEFAULT_TOM_CONFIG;
+    compileLookups();
+    markChanged();
 
     Serial.println("[CONFIG] All pads reset to defaults");
 }
 
 // ============================================================================
-// JSON EXPORT/IMPORT (for GUI communication)
+// JSON EXPORT/IMPORT (backup/restore; the display syncs via config_sync.h)
 // ============================================================================
 
 String PadConfigManager::exportJSON() {
@@ -188,6 +372,8 @@ String PadConfigManager::exportJSON() {
         pad["midiChannel"] = cfg.midiChannel;
         pad["sampleName"] = cfg.sampleName;
         pad["sampleVolume"] = cfg.sampleVolume;
+        pad["chokeGroup"] = cfg.chokeGroup;
+        pad["rimChokeGroup"] = cfg.rimChokeGroup;
 
         // LED
         pad["ledColorHit"] = cfg.ledColorHit;
@@ -234,6 +420,8 @@ bool PadConfigManager::importJSON(const String& json) {
         if (pad.containsKey("midiChannel")) cfg.midiChannel = pad["midiChannel"];
         if (pad.containsKey("sampleName")) strncpy(cfg.sampleName, pad["sampleName"] | "", 31);
         if (pad.containsKey("sampleVolume")) cfg.sampleVolume = pad["sampleVolume"];
+        if (pad.containsKey("chokeGroup")) cfg.chokeGroup = pad["chokeGroup"];
+        if (pad.containsKey("rimChokeGroup")) cfg.rimChokeGroup = pad["rimChokeGroup"];
 
         if (pad.containsKey("ledColorHit")) cfg.ledColorHit = pad["ledColorHit"];
         if (pad.containsKey("ledColorIdle")) cfg.ledColorIdle = pad["ledColorIdle"];
@@ -243,6 +431,8 @@ bool PadConfigManager::importJSON(const String& json) {
         if (pad.containsKey("enabled")) cfg.enabled = pad["enabled"];
     }
 
+    compileLookups();
+    markChanged();
     Serial.println("[CONFIG] Configuration imported from JSON");
     return true;
 }
@@ -0,0 +1,200 @@
+#ifndef CONFIG_SYNC_H
+#define CONFIG_SYNC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// ============================================================================
+// CONFIG SYNC - BINARY PAD CONFIG MIRROR (MAIN BRAIN -> DISPLAY)
+// ============================================================================
+// The main brain owns the pad config; PadConfigManager::markChanged()
+// records which fields changed and the UART link sends them on its next
+// tick. The display keeps a mirror of it:
+//
+// - MSG_CONFIG_DELTA for edits: [ConfigDeltaHeader] then TLV records
+//   [padId][field][len][value]. 'generation' goes up by one per delta. A
+//   display that sees anything but last + 1 applies the records and asks
+//   for a snapshot (CMD_GET_CONFIG).
+// - MSG_CONFIG_SNAPSHOT on resync (boot, gap, reset/load/import): every
+//   pad as a packed PadConfigWire, with the current generation.
+//
+// Values are little-endian, as laid out in memory on both ESP32-S3s.
+// Unknown field ids are skipped by length, so a newer main brain can add
+// fields without breaking an older display; a different
+// CONFIG_SYNC_VERSION is rejected as a whole. JSON (PadConfigManager::
+// exportJSON/importJSON) is only for backup and restore.
+
+#define CONFIG_SYNC_VERSION 1
+#define CONFIG_SNAPSHOT_PADS 4
+#define CONFIG_DELTA_RECORD_HEADER 3   // padId, field, len
+#define CONFIG_FIELDS_ALL 0xFFFFFFFFu  // Pending mask: every field (sent as a snapshot)
+
+#pragma pack(push, 1)
+
+// The synced subset of PadConfig (the trigger timing and rim fields stay
+// on the main brain)
+struct PadConfigWire {
+    uint16_t threshold;
+    uint16_t velocityMin;
+    uint16_t velocityMax;
+    float velocityCurve;
+    uint8_t crosstalkEnabled;
+    uint16_t crosstalkWindow;
+    float crosstalkRatio;
+    uint8_t midiNote;
+    uint8_t midiChannel;
+    char sampleName[32];
+    uint8_t sampleVolume;
+    uint8_t chokeGroup;
+    uint8_t rimChokeGroup;
+    uint32_t ledColorHit;
+    uint32_t ledColorIdle;
+    uint8_t ledBrightness;
+    char name[16];
+    uint8_t enabled;
+};
+
+struct ConfigSnapshotMsg {
+    uint8_t version;            // CONFIG_SYNC_VERSION
+    uint32_t generation;
+    uint8_t padCount;           // Valid entries in pads[]
+    PadConfigWire pads[CONFIG_SNAPSHOT_PADS];
+};
+
+struct ConfigDeltaHeader {
+    uint8_t version;            // CONFIG_SYNC_VERSION
+    uint32_t generation;        // Counter after this change
+};
+
+#pragma pack(pop)
+
+// Field ids are wire format: never renumber, only append
+#define CONFIG_FIELD_TABLE(X)                        \
+    X(CFG_THRESHOLD,         0x01, threshold)        \
+    X(CFG_VELOCITY_MIN,      0x02, velocityMin)      \
+    X(CFG_VELOCITY_MAX,      0x03, velocityMax)      \
+    X(CFG_VELOCITY_CURVE,    0x04, velocityCurve)    \
+    X(CFG_CROSSTALK_ENABLED, 0x05, crosstalkEnabled) \
+    X(CFG_CROSSTALK_WINDOW,  0x06, crosstalkWindow)  \
+    X(CFG_CROSSTALK_RATIO,   0x07, crosstalkRatio)   \
+    X(CFG_MIDI_NOTE,         0x08, midiNote)         \
+    X(CFG_MIDI_CHANNEL,      0x09, midiChannel)      \
+    X(CFG_SAMPLE_NAME,       0x0A, sampleName)       \
+    X(CFG_SAMPLE_VOLUME,     0x0B, sampleVolume)     \
+    X(CFG_CHOKE_GROUP,       0x0C, chokeGroup)       \
+    X(CFG_RIM_CHOKE_GROUP,   0x0D, rimChokeGroup)    \
+    X(CFG_LED_COLOR_HIT,     0x0E, ledColorHit)      \
+    X(CFG_LED_COLOR_IDLE,    0x0F, ledColorIdle)     \
+    X(CFG_LED_BRIGHTNESS,    0x10, ledBrightness)    \
+    X(CFG_NAME,              0x11, name)             \
+    X(CFG_ENABLED,           0x12, enabled)
+
+enum ConfigFieldId : uint8_t {
+#define CONFIG_FIELD_ENUM(id, wireId, member) id = wireId,
+    CONFIG_FIELD_TABLE(CONFIG_FIELD_ENUM)
+#undef CONFIG_FIELD_ENUM
+};
+
+// Bit of a field in a pending-changes mask (field ids stay below 32)
+inline constexpr uint32_t configFieldBit(uint8_t field) {
+    return field < 32 ? 1u << field : 0;
+}
+
+struct ConfigFieldInfo {
+    uint8_t offset;             // In PadConfigWire
+    uint8_t size;
+    bool text;                  // char array: sent without padding, NUL-terminated on apply
+};
+
+inline bool configFieldInfo(uint8_t field, ConfigFieldInfo& info) {
+    switch (field) {
+#define CONFIG_FIELD_INFO_CASE(id, wireId, member)                                           \
+    case id:                                                                                 \
+        info = {static_cast<uint8_t>(offsetof(PadConfigWire, member)),                       \
+                static_cast<uint8_t>(sizeof(PadConfigWire::member)),                         \
+                std::is_array<decltype(PadConfigWire::member)>::value};                      \
+        return true;
+        CONFIG_FIELD_TABLE(CONFIG_FIELD_INFO_CASE)
+#undef CONFIG_FIELD_INFO_CASE
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Encoding (main brain)
+// ----------------------------------------------------------------------------
+
+// Starts a delta payload in 'body'. Returns the fill (header size).
+inline size_t configDeltaBegin(uint8_t* body, uint32_t generation) {
+    ConfigDeltaHeader header = {CONFIG_SYNC_VERSION, generation};
+    memcpy(body, &header, sizeof(header));
+    return sizeof(header);
+}
+
+// Appends field 'field' of pad 'padId' taken from 'src'. Returns the new
+// fill, or 'used' unchanged for an unknown field or a full buffer.
+inline size_t configDeltaAppend(uint8_t* body, size_t used, size_t capacity, uint8_t padId, uint8_t field,
+                                const PadConfigWire& src) {
+    ConfigFieldInfo info;
+    if (!configFieldInfo(field, info)) return used;
+    const uint8_t* value = reinterpret_cast<const uint8_t*>(&src) + info.offset;
+    uint8_t length = info.size;
+    if (info.text) {
+        length = 0;
+        while (length < info.size - 1 && value[length] != '\0') length++;
+    }
+    if (used + CONFIG_DELTA_RECORD_HEADER + length > capacity) return used;
+    body[used] = padId;
+    body[used + 1] = field;
+    body[used + 2] = length;
+    memcpy(body + used + CONFIG_DELTA_RECORD_HEADER, value, length);
+    return used + CONFIG_DELTA_RECORD_HEADER + length;
+}
+
+// ----------------------------------------------------------------------------
+// Decoding (display)
+// ----------------------------------------------------------------------------
+
+// Calls onField(padId, field, value, length) for every record and stores
+// the delta's generation. Returns false on a wrong version, a short header
+// or a truncated record (records before it are still delivered).
+template <typename OnField>
+inline bool forEachConfigDelta(const uint8_t* payload, uint16_t length, uint32_t& generation, OnField&& onField) {
+    ConfigDeltaHeader header;
+    if (length < sizeof(header)) return false;
+    memcpy(&header, payload, sizeof(header));
+    if (header.version != CONFIG_SYNC_VERSION) return false;
+    generation = header.generation;
+
+    uint16_t pos = sizeof(header);
+    while (pos < length) {
+        if (length - pos < CONFIG_DELTA_RECORD_HEADER) return false;
+        uint8_t recordLength = payload[pos + 2];
+        if (length - pos - CONFIG_DELTA_RECORD_HEADER < recordLength) return false;
+        onField(payload[pos], payload[pos + 1], payload + pos + CONFIG_DELTA_RECORD_HEADER, recordLength);
+        pos += CONFIG_DELTA_RECORD_HEADER + recordLength;
+    }
+    return true;
+}
+
+// Writes one record's value into 'dst'. Returns false (and leaves 'dst'
+// alone) for an unknown field or a length that does not fit it.
+inline bool configApplyField(PadConfigWire& dst, uint8_t field, const uint8_t* value, uint8_t length) {
+    ConfigFieldInfo info;
+    if (!configFieldInfo(field, info)) return false;
+    uint8_t* target = reinterpret_cast<uint8_t*>(&dst) + info.offset;
+    if (info.text) {
+        if (length >= info.size) return false;
+        memcpy(target, value, length);
+        memset(target + length, 0, info.size - length);
+    } else {
+        if (length != info.size) return false;
+        memcpy(target, value, length);
+    }
+    return true;
+}
+
+#endif // CONFIG_SYNC_H
@@ -0,0 +1,85 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// FRAME CODEC - SHARED UART FRAMING FOR BOTH MCUs
+// ============================================================================
+// Frame: [0xAA][type][len hi][len lo][payload: len bytes][crc hi][crc lo]
+// CRC-16-CCITT (0x1021, init 0xFFFF, no reflection, no final XOR) over
+// header + payload.
+//
+// The encoder writes the whole frame into one caller-provided buffer so
+// the UART driver gets a single contiguous write. Callers that build the
+// payload themselves write it at frameBody(buf) and call frameSeal();
+// frameEncode() copies an existing payload in. FrameParser (frame_parser.h)
+// is the decoder. Plain C++, no Arduino.
+
+#define FRAME_START_BYTE 0xAA
+#define FRAME_HEADER_SIZE 4
+#define FRAME_CRC_SIZE 2
+#define FRAME_OVERHEAD (FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+
+namespace frame_codec_detail {
+
+struct Crc16Table {
+    uint16_t entry[256];
+
+    constexpr Crc16Table() : entry() {
+        for (int i = 0; i < 256; i++) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+            }
+            entry[i] = crc;
+        }
+    }
+};
+
+// Built at compile time, 512 bytes in flash
+inline constexpr Crc16Table CRC16_TABLE{};
+
+}  // namespace frame_codec_detail
+
+// One table lookup per byte instead of eight shift/XOR steps
+inline uint16_t frameCrc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    while (length--) {
+        crc = static_cast<uint16_t>((crc << 8) ^ frame_codec_detail::CRC16_TABLE.entry[(crc >> 8) ^ *data++]);
+    }
+    return crc;
+}
+
+inline constexpr size_t frameSize(uint16_t payloadLength) {
+    return FRAME_OVERHEAD + payloadLength;
+}
+
+// Where the payload goes inside a TX buffer
+inline uint8_t* frameBody(uint8_t* out) {
+    return out + FRAME_HEADER_SIZE;
+}
+
+// Writes header and CRC around a payload already placed at frameBody(out).
+// 'out' must hold frameSize(length) bytes. Returns the frame size.
+inline size_t frameSeal(uint8_t* out, uint8_t type, uint16_t length) {
+    out[0] = FRAME_START_BYTE;
+    out[1] = type;
+    out[2] = static_cast<uint8_t>(length >> 8);
+    out[3] = static_cast<uint8_t>(length & 0xFF);
+    uint16_t crc = frameCrc16(out, FRAME_HEADER_SIZE + length);
+    out[FRAME_HEADER_SIZE + length] = static_cast<uint8_t>(crc >> 8);
+    out[FRAME_HEADER_SIZE + length + 1] = static_cast<uint8_t>(crc & 0xFF);
+    return frameSize(length);
+}
+
+// Copies 'payload' into 'out' and seals it. Returns the frame size, or 0
+// if it does not fit in 'capacity'.
+inline size_t frameEncode(uint8_t* out, size_t capacity, uint8_t type, const void* payload, uint16_t length) {
+    if (frameSize(length) > capacity || (length > 0 && !payload)) return 0;
+    if (length > 0) memcpy(frameBody(out), payload, length);
+    return frameSeal(out, type, length);
+}
+
+#endif // FRAME_CODEC_H
@@ -0,0 +1,126 @@
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+
+#include "frame_codec.h"
+
+// ============================================================================
+// FRAME PARSER - INCREMENTAL, NON-BLOCKING UART FRAME DECODER
+// ============================================================================
+// Decodes the frames written by frame_codec.h.
+//
+// Used by both MCUs (UARTProtocol on the main brain, UARTLink on the
+// display). parse() takes whatever bytes the UART has right now and never
+// waits for the rest of a frame: a partial frame simply stays in the
+// parser until the next call.
+//
+// Resync keeps good data: the bytes of a candidate frame stay in the
+// window until its CRC checks out. If it fails (or the length is
+// impossible) only the false start byte is dropped and the window is
+// rescanned from the next 0xAA, so a real frame hiding behind a noise byte
+// that looked like a header is still delivered. Plain C++, no Arduino, so
+// test/host/test_frame_parser.cpp can fuzz it on the host.
+
+template <uint16_t MaxPayload>
+class FrameParser {
+public:
+    static constexpr size_t MAX_FRAME = FRAME_HEADER_SIZE + MaxPayload + FRAME_CRC_SIZE;
+
+    struct Stats {
+        uint32_t frames;        // Frames delivered
+        uint32_t crcErrors;     // Candidates rejected by CRC
+        uint32_t lengthErrors;  // Candidates with length > MaxPayload
+        uint32_t timeouts;      // Partial frames abandoned by expire()
+        uint32_t skippedBytes;  // Bytes discarded while hunting for a start byte
+    };
+
+    // Feeds 'length' received bytes. onFrame(type, payload, payloadLength)
+    // runs for every valid frame; payload points into the parser and is only
+    // valid during the call. Returns the number of frames delivered.
+    template <typename OnFrame>
+    size_t parse(const uint8_t* data, size_t length, OnFrame&& onFrame) {
+        size_t delivered = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (fill_ == 0 && data[i] != FRAME_START_BYTE) {
+                stats_.skippedBytes++;  // Hunting: nothing to keep
+                continue;
+            }
+            window_[fill_++] = data[i];
+            delivered += process(onFrame);
+        }
+        return delivered;
+    }
+
+    // Abandon a partial frame that stopped receiving bytes (call when the
+    // line has been idle for a while). The window is rescanned, so frames
+    // behind a false start byte with a huge length are still delivered.
+    template <typename OnFrame>
+    size_t expire(OnFrame&& onFrame) {
+        if (fill_ == 0) return 0;
+        stats_.timeouts++;
+        resync();
+        return process(onFrame);
+    }
+
+    bool idle() const { return fill_ == 0; }
+    size_t pending() const { return fill_; }
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = Stats(); }
+    void reset() { fill_ = 0; }
+
+private:
+    template <typename OnFrame>
+    size_t process(OnFrame& onFrame) {
+        size_t delivered = 0;
+        while (fill_ > 0) {
+            if (window_[0] != FRAME_START_BYTE) {
+                resync();
+                continue;
+            }
+            if (fill_ < FRAME_HEADER_SIZE) break;
+
+            uint16_t length = static_cast<uint16_t>((window_[2] << 8) | window_[3]);
+            if (length > MaxPayload) {
+                stats_.lengthErrors++;
+                resync();
+                continue;
+            }
+
+            size_t total = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE;
+            if (fill_ < total) break;
+
+            size_t crcAt = FRAME_HEADER_SIZE + length;
+            uint16_t received = static_cast<uint16_t>((window_[crcAt] << 8) | window_[crcAt + 1]);
+            if (frameCrc16(window_, crcAt) != received) {
+                stats_.crcErrors++;
+                resync();
+                continue;
+            }
+
+            stats_.frames++;
+            delivered++;
+            onFrame(window_[1], window_ + FRAME_HEADER_SIZE, length);
+            consume(total);
+        }
+        return delivered;
+    }
+
+    // Drop the byte at the window start and everything up to the next
+    // candidate start byte
+    void resync() {
+        size_t next = 1;
+        while (next < fill_ && window_[next] != FRAME_START_BYTE) next++;
+        stats_.skippedBytes += next;
+        consume(next);
+    }
+
+    void consume(size_t n) {
+        if (n < fill_) memmove(window_, window_ + n, fill_ - n);
+        fill_ -= n;
+    }
+
+    uint8_t window_[MAX_FRAME];
+    size_t fill_ = 0;
+    Stats stats_ = Stats();
+};
+
+#endif // FRAME_PARSER_H
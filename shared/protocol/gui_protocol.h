@@ -1,12 +1,17 @@
 #ifndef GUI_PROTOCOL_H
 #define GUI_PROTOCOL_H
 
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "frame_codec.h"
+#include "frame_parser.h"
+#include "config_sync.h"
 
-// Basic framing constants shared between MCUs
-#define UART_START_BYTE 0xAA
+// Basic framing constants shared between MCUs (frame layout: frame_codec.h)
+#define UART_START_BYTE FRAME_START_BYTE
 #define UART_MAX_PAYLOAD 2048
-#define UART_TIMEOUT_MS 100
+#define UART_TIMEOUT_MS 100      // Idle time before a partial frame is abandoned
+#define UART_RX_BUDGET 512       // Max bytes parsed per process call (bounds loop() time)
 
 // Message types (bidirectional)
 enum UARTMessageType : uint8_t {
@@ -14,14 +19,19 @@ enum UARTMessageType : uint8_t {
     MSG_HIT_EVENT = 0x01,
     MSG_PAD_STATE = 0x02,
     MSG_SYSTEM_STATUS = 0x03,
-    MSG_CONFIG_UPDATE = 0x04,
+    MSG_CONFIG_DELTA = 0x04,     // Binary per-field config changes (config_sync.h)
     MSG_CALIBRATION_DATA = 0x05,
+    MSG_LOAD_PROGRESS = 0x06,    // Background sample/kit load progress
+    MSG_MIXER_METERS = 0x07,     // Per-pad bus meters at a fixed rate
+    MSG_TEMPO = 0x08,            // Tempo followed from incoming MIDI clock
+    MSG_TELEMETRY_BATCH = 0x09,  // Several fixed-size messages in one frame (see below)
 
     // Responses from Main Brain
     MSG_ACK = 0x10,
     MSG_NACK = 0x11,
-    MSG_CONFIG_DUMP = 0x12,
+    MSG_CONFIG_DUMP = 0x12,      // JSON backup, only in reply to CMD_EXPORT_CONFIG
     MSG_SAMPLE_LIST = 0x13,
+    MSG_CONFIG_SNAPSHOT = 0x14,  // Full binary config, on resync (config_sync.h)
 
     // Commands from GUI
     CMD_SET_THRESHOLD = 0x20,
@@ -33,10 +43,11 @@ enum UARTMessageType : uint8_t {
     CMD_SET_CROSSTALK = 0x26,
     CMD_SET_FULL_CONFIG = 0x27,
 
-    CMD_GET_CONFIG = 0x30,
+    CMD_GET_CONFIG = 0x30,       // Replies MSG_CONFIG_SNAPSHOT
     CMD_SAVE_CONFIG = 0x31,
     CMD_LOAD_CONFIG = 0x32,
     CMD_RESET_CONFIG = 0x33,
+    CMD_EXPORT_CONFIG = 0x34,    // Replies MSG_CONFIG_DUMP (JSON)
 
     CMD_START_CALIBRATION = 0x40,
     CMD_STOP_CALIBRATION = 0x41,
@@ -67,6 +78,13 @@ enum MenuConfigOption : uint8_t {
     MENU_OPT_COUNT = 4
 };
 
+// Sample loader states (MSG_LOAD_PROGRESS)
+enum LoadStateType : uint8_t {
+    LOAD_STATE_LOADING = 0,      // Read in progress, percent is valid
+    LOAD_STATE_DONE = 1,         // Request finished, samples available
+    LOAD_STATE_FAILED = 2        // Request finished with an error
+};
+
 #pragma pack(push, 1)
 
 struct HitEventMsg {
@@ -93,6 +111,33 @@ struct SystemStatusMsg {
     uint32_t uptime;
 };
 
+struct LoadProgressMsg {
+    uint8_t state;              // LoadStateType
+    uint8_t percent;            // 0-100 of the file being read
+    uint8_t pending;            // Requests still queued behind this one
+    uint32_t bytesDone;
+    uint32_t bytesTotal;
+    char name[48];              // Sample path or kit name
+};
+
+// Levels are 0-127 on a dB scale (0 = floor, 127 = 0 dBFS)
+#define MIXER_METER_BUSES 4
+
+struct MixerMetersMsg {
+    uint8_t peak[MIXER_METER_BUSES];
+    uint8_t rms[MIXER_METER_BUSES];
+    uint8_t masterPeak;
+    uint8_t masterRms;
+    uint8_t masterVolume;       // 0-127
+    uint8_t muteMask;           // bit n = pad n
+    uint8_t soloMask;
+};
+
+struct TempoMsg {
+    uint16_t bpmX10;            // Tempo in tenths of BPM (1205 = 120.5)
+    uint8_t running;            // 1 after MIDI Start/Continue, 0 after Stop
+};
+
 struct SetThresholdCmd {
     uint8_t padId;
     uint16_t threshold;
@@ -172,4 +217,110 @@ struct SampleListMsg {
 
 #pragma pack(pop)
 
+// ============================================================================
+// MESSAGE DESCRIPTORS
+// ============================================================================
+// Fixed-size messages: type id, packed payload struct and its wire size.
+// The size column pins the layout: changing a struct without bumping it
+// here breaks the build instead of the link. Variable-length messages
+// (ACK/NACK, config deltas, JSON backup, CMD_RESET_CONFIG, payload-less
+// commands) are not listed and keep their manual handling.
+#define GUI_MESSAGE_TABLE(X)                            \
+    X(MSG_HIT_EVENT,          HitEventMsg,          8)  \
+    X(MSG_PAD_STATE,          PadStateMsg,          8)  \
+    X(MSG_SYSTEM_STATUS,      SystemStatusMsg,     16)  \
+    X(MSG_CALIBRATION_DATA,   CalibrationDataMsg,   7)  \
+    X(MSG_LOAD_PROGRESS,      LoadProgressMsg,     59)  \
+    X(MSG_MIXER_METERS,       MixerMetersMsg,      13)  \
+    X(MSG_TEMPO,              TempoMsg,             3)  \
+    X(MSG_MENU_STATE,         MenuStateMsg,        67)  \
+    X(MSG_MENU_SAMPLES,       SampleListMsg,      299)  \
+    X(MSG_CONFIG_SNAPSHOT,    ConfigSnapshotMsg,  326)  \
+    X(CMD_SET_THRESHOLD,      SetThresholdCmd,      3)  \
+    X(CMD_SET_VELOCITY_RANGE, SetVelocityRangeCmd,  5)  \
+    X(CMD_SET_VELOCITY_CURVE, SetVelocityCurveCmd,  5)  \
+    X(CMD_SET_MIDI_NOTE,      SetMidiNoteCmd,       3)  \
+    X(CMD_SET_SAMPLE,         SetSampleCmd,        33)  \
+    X(CMD_SET_LED_COLOR,      SetLEDColorCmd,      10)  \
+    X(CMD_SET_CROSSTALK,      SetCrosstalkCmd,      8)
+
+// MessageTraits<Msg>::TYPE / ::SIZE. Only listed structs have traits, so
+// sending an unlisted struct through encodeMessage() does not compile.
+template <typename Msg>
+struct MessageTraits;
+
+#define GUI_MESSAGE_TRAITS(id, msgType, size)                                   \
+    template <>                                                                 \
+    struct MessageTraits<msgType> {                                             \
+        static constexpr uint8_t TYPE = id;                                     \
+        static constexpr uint16_t SIZE = size;                                  \
+        static_assert(sizeof(msgType) == size, #msgType " wire size changed");  \
+    };
+GUI_MESSAGE_TABLE(GUI_MESSAGE_TRAITS)
+#undef GUI_MESSAGE_TRAITS
+
+// Expected payload size of a fixed-size message, 0 if the type is not listed
+inline constexpr uint16_t messagePayloadSize(uint8_t type) {
+#define GUI_MESSAGE_SIZE_CASE(id, msgType, size) \
+    if (type == id) return size;
+    GUI_MESSAGE_TABLE(GUI_MESSAGE_SIZE_CASE)
+#undef GUI_MESSAGE_SIZE_CASE
+    return 0;
+}
+
+// Encodes 'msg' as a complete frame into 'out'. Returns the frame size, or
+// 0 if 'capacity' is too small.
+template <typename Msg>
+inline size_t encodeMessage(uint8_t* out, size_t capacity, const Msg& msg) {
+    return frameEncode(out, capacity, MessageTraits<Msg>::TYPE, &msg, MessageTraits<Msg>::SIZE);
+}
+
+// Typed view of a received payload, or nullptr if the type or length does
+// not match. Packed structs have alignment 1, so the parser window can be
+// read in place; the pointer is only valid inside the onFrame callback.
+template <typename Msg>
+inline const Msg* decodeMessage(uint8_t type, const uint8_t* payload, uint16_t length) {
+    if (type != MessageTraits<Msg>::TYPE || length != MessageTraits<Msg>::SIZE) return nullptr;
+    return reinterpret_cast<const Msg*>(payload);
+}
+
+// ============================================================================
+// TELEMETRY BATCH (MSG_TELEMETRY_BATCH)
+// ============================================================================
+// Payload: records of [type][payload], back to back. Only types listed in
+// GUI_MESSAGE_TABLE can appear, so each record's length is known from its
+// type byte and needs no length field.
+
+// Appends one record at body[used]. Returns the new fill, or 'used'
+// unchanged if the record does not fit in 'capacity'. 'size' must be
+// messagePayloadSize(type).
+inline size_t batchAppend(uint8_t* body, size_t used, size_t capacity, uint8_t type, const void* payload,
+                          uint16_t size) {
+    if (used + 1 + size > capacity) return used;
+    body[used] = type;
+    memcpy(body + used + 1, payload, size);
+    return used + 1 + size;
+}
+
+template <typename Msg>
+inline size_t batchAppend(uint8_t* body, size_t used, size_t capacity, const Msg& msg) {
+    return batchAppend(body, used, capacity, MessageTraits<Msg>::TYPE, &msg, MessageTraits<Msg>::SIZE);
+}
+
+// Calls onRecord(type, payload, length) for every record. Returns false
+// (after delivering the records before it) on an unknown type or a
+// truncated record.
+template <typename OnRecord>
+inline bool forEachBatchRecord(const uint8_t* payload, uint16_t length, OnRecord&& onRecord) {
+    uint16_t pos = 0;
+    while (pos < length) {
+        uint8_t type = payload[pos];
+        uint16_t size = messagePayloadSize(type);
+        if (size == 0 || length - pos - 1 < size) return false;
+        onRecord(type, payload + pos + 1, size);
+        pos += 1 + size;
+    }
+    return true;
+}
+
 #endif // GUI_PROTOCOL_H
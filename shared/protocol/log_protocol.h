@@ -0,0 +1,164 @@
+#ifndef LOG_PROTOCOL_H
+#define LOG_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================================
+// DEFERRED BINARY LOG - RECORD, FORMAT TABLE AND WIRE FRAME
+// ============================================================================
+// Hot paths log a format id plus up to LOG_MAX_ARGS 32-bit integers into
+// the firmware's log ring (src/main_brain/core/log_ring.h); formatting
+// happens later in a low-priority task, or on the host when the firmware
+// ships raw frames (tools/log_decode). Plain C++ so both sides share it.
+//
+// Format ids are the FNV-1a hash of the format string, so adding or
+// reordering entries never changes an existing id. Formats may only use
+// 32-bit integer conversions (%u %d %x %c); the table switch below turns a
+// hash collision into a duplicate-case compile error.
+
+#define LOG_MAX_ARGS 4
+
+// Argument order matches the format string
+#define LOG_FORMAT_TABLE(X) \
+    X(LOG_DROPPED,          "[LOG] %u records dropped (ring full)") \
+    X(HIT_ACCEPTED,         "HIT pad %u vel %u hires %u baseline %u") \
+    X(HIT_CROSSTALK,        "X-TALK pad %u (vel %u) suppressed by pad %u (vel %u)") \
+    X(HIT_DEBOUNCE,         "DEBOUNCE pad %u retrigger after %u ms") \
+    X(DETECTOR_NO_QUEUE,    "[TriggerDetector] hit queue not initialized, lost pad %u") \
+    X(DETECTOR_QUEUE_FULL,  "[TriggerDetector] hit queue full, lost pad %u vel %u") \
+    X(DETECTOR_THRESHOLD,   "[Pad %u] threshold crossed: signal=%u threshold=%u dynamic=%u") \
+    X(DETECTOR_REJECTED,    "[Pad %u] rejected (crosstalk): peak=%u vel=%u") \
+    X(DETECTOR_HIT,         "[Pad %u] hit: peak=%u vel=%u rise=%u us") \
+    X(DETECTOR_REARMED,     "[Pad %u] re-armed") \
+    X(DETECTOR_CROSSTALK,   "[Crosstalk] pad %u vel=%u < pad %u vel=%u * ratio") \
+    X(DETECTOR_HIT_EVENT,   "[HitEvent] pad=%u vel=%u time=%u") \
+    X(MENU_PAD,             "[MENU] Selected pad: %u") \
+    X(MENU_THRESHOLD,       "[MENU] Threshold: %u") \
+    X(MENU_SENSITIVITY,     "[MENU] Sensitivity: %u") \
+    X(MENU_MAX_PEAK,        "[MENU] Max Peak: %u") \
+    X(MENU_OPTION,          "[MENU] Option: %u") \
+    X(MENU_SAMPLE,          "[MENU] Sample: %u of %u") \
+    X(UART_THRESHOLD,       "[UART] Threshold updated: pad %u = %u") \
+    X(UART_VELOCITY_RANGE,  "[UART] Velocity range updated: pad %u = [%u-%u]") \
+    X(UART_VELOCITY_CURVE,  "[UART] Velocity curve updated: pad %u = %u/100") \
+    X(UART_MIDI_NOTE,       "[UART] MIDI note updated: pad %u = %u") \
+    X(UART_LED_COLORS,      "[UART] LED colors updated: pad %u") \
+    X(UART_CROSSTALK,       "[UART] Crosstalk updated: pad %u")
+
+constexpr uint32_t logFormatId(const char* fmt, uint32_t hash = 2166136261u) {
+    return *fmt ? logFormatId(fmt + 1, (hash ^ static_cast<uint8_t>(*fmt)) * 16777619u) : hash;
+}
+
+namespace LogFmt {
+#define LOG_FORMAT_ID(name, fmt) constexpr uint32_t name = logFormatId(fmt);
+LOG_FORMAT_TABLE(LOG_FORMAT_ID)
+#undef LOG_FORMAT_ID
+}
+
+inline const char* logFormatString(uint32_t id) {
+    switch (id) {
+#define LOG_FORMAT_CASE(name, fmt) case LogFmt::name: return fmt;
+    LOG_FORMAT_TABLE(LOG_FORMAT_CASE)
+#undef LOG_FORMAT_CASE
+    default: return nullptr;
+    }
+}
+
+struct LogRecord {
+    uint32_t timestampUs;  // micros() at the call site
+    uint32_t formatId;     // LogFmt::*
+    uint8_t argc;
+    uint32_t args[LOG_MAX_ARGS];
+};
+
+// Text form shared by the firmware drain task and the host decoder:
+// "[  12.345678] <formatted>". Returns the snprintf length.
+inline int logFormatRecord(const LogRecord& rec, char* out, size_t size) {
+    int n = snprintf(out, size, "[%4lu.%06lu] ",
+                     static_cast<unsigned long>(rec.timestampUs / 1000000u),
+                     static_cast<unsigned long>(rec.timestampUs % 1000000u));
+    if (n < 0 || static_cast<size_t>(n) >= size) return n;
+
+    const char* fmt = logFormatString(rec.formatId);
+    int m;
+    if (fmt) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-extra-args"
+        // Missing arguments were stored as 0; extra ones are ignored
+        m = snprintf(out + n, size - n, fmt, rec.args[0], rec.args[1], rec.args[2], rec.args[3]);
+#pragma GCC diagnostic pop
+    } else {
+        m = snprintf(out + n, size - n, "<unknown format 0x%08lx, %u args>",
+                     static_cast<unsigned long>(rec.formatId), rec.argc);
+    }
+    return m < 0 ? m : n + m;
+}
+
+// ============================================================================
+// WIRE FRAME (binary mode)
+// ============================================================================
+// [0xA5][0x5A][len][payload: timestampUs, formatId (LE), argc, args (LE)][xor]
+// Frames are interleaved with ordinary text on the same serial port; the
+// decoder passes through any byte that does not start a valid frame.
+
+#define LOG_FRAME_SYNC0 0xA5
+#define LOG_FRAME_SYNC1 0x5A
+#define LOG_FRAME_HEADER 3
+#define LOG_FRAME_MAX (LOG_FRAME_HEADER + 9 + 4 * LOG_MAX_ARGS + 1)
+
+inline void logPut32(uint8_t* p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+inline uint32_t logGet32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Returns the frame length (<= LOG_FRAME_MAX)
+inline size_t logEncodeFrame(const LogRecord& rec, uint8_t* out) {
+    uint8_t argc = rec.argc > LOG_MAX_ARGS ? LOG_MAX_ARGS : rec.argc;
+    uint8_t len = 9 + 4 * argc;
+    out[0] = LOG_FRAME_SYNC0;
+    out[1] = LOG_FRAME_SYNC1;
+    out[2] = len;
+    uint8_t* p = out + LOG_FRAME_HEADER;
+    logPut32(p, rec.timestampUs);
+    logPut32(p + 4, rec.formatId);
+    p[8] = argc;
+    for (uint8_t i = 0; i < argc; i++) logPut32(p + 9 + 4 * i, rec.args[i]);
+
+    uint8_t x = 0;
+    for (uint8_t i = 0; i < len; i++) x ^= p[i];
+    p[len] = x;
+    return LOG_FRAME_HEADER + len + 1;
+}
+
+// Decodes a frame at data[0]. Returns the bytes consumed, 0 if data does
+// not start a valid frame, or -1 if more bytes are needed to tell.
+inline int logDecodeFrame(const uint8_t* data, size_t avail, LogRecord& rec) {
+    if (avail < 1) return -1;
+    if (data[0] != LOG_FRAME_SYNC0) return 0;
+    if (avail < LOG_FRAME_HEADER) return -1;
+    if (data[1] != LOG_FRAME_SYNC1) return 0;
+
+    uint8_t len = data[2];
+    if (len < 9 || len > 9 + 4 * LOG_MAX_ARGS || (len - 9) % 4 != 0) return 0;
+    if (avail < static_cast<size_t>(LOG_FRAME_HEADER + len + 1)) return -1;
+
+    const uint8_t* p = data + LOG_FRAME_HEADER;
+    uint8_t x = 0;
+    for (uint8_t i = 0; i < len; i++) x ^= p[i];
+    if (x != p[len] || p[8] != (len - 9) / 4) return 0;
+
+    rec = {};
+    rec.timestampUs = logGet32(p);
+    rec.formatId = logGet32(p + 4);
+    rec.argc = p[8];
+    for (uint8_t i = 0; i < rec.argc; i++) rec.args[i] = logGet32(p + 9 + 4 * i);
+    return LOG_FRAME_HEADER + len + 1;
+}
+
+#endif // LOG_PROTOCOL_H
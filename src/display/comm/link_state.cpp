@@ -6,9 +6,13 @@ namespace display::comm {
 namespace {
 std::array<PadTelemetry, NUM_PADS> padTelemetry{};
 std::array<PadConfigSnapshot, NUM_PADS> padConfigs{};
+std::array<PadConfigWire, NUM_PADS> padConfigWire{};
+uint32_t configGen = 0;
+bool configSynced = false;
 SystemTelemetry systemTelemetry{};
 MenuSnapshot menuState{};
 SampleListSnapshot sampleList{};
+LoadProgressSnapshot loadProgress{};
 PadTelemetry padFallback{};
 PadConfigSnapshot configFallback{};
 MenuSnapshot menuFallback{};
@@ -26,6 +30,26 @@ void copyString(char* dest, size_t len, const char* src) {
     dest[len - 1] = '\0';
 }
 
+// The UI reads PadConfigSnapshot; the wire mirror holds what the main brain sent
+void publishPadConfig(uint8_t padId) {
+    const PadConfigWire& wire = padConfigWire[padId];
+    PadConfigSnapshot& cfg = padConfigs[padId];
+    cfg.padId = padId;
+    cfg.threshold = wire.threshold;
+    cfg.velocityMin = wire.velocityMin;
+    cfg.velocityMax = wire.velocityMax;
+    cfg.velocityCurve = wire.velocityCurve;
+    cfg.midiNote = wire.midiNote;
+    cfg.midiChannel = wire.midiChannel;
+    cfg.ledColorHit = wire.ledColorHit;
+    cfg.ledColorIdle = wire.ledColorIdle;
+    cfg.ledBrightness = wire.ledBrightness;
+    copyString(cfg.sampleName, sizeof(cfg.sampleName), wire.sampleName);
+    copyString(cfg.name, sizeof(cfg.name), wire.name);
+    cfg.enabled = wire.enabled != 0;
+    cfg.valid = true;
+}
+
 void ensureInit() {
     if (initialized) {
         return;
@@ -103,55 +127,55 @@ void LinkState::updateSystemStatus(const SystemStatusMsg& msg) {
     systemTelemetry.valid = true;
 }
 
-void LinkState::applyPadConfig(uint8_t padId, const JsonVariantConst& source) {
-    if (!source.is<JsonObjectConst>()) {
-        return;
-    }
-    if (padId >= padConfigs.size()) {
+void LinkState::updateConfigSnapshot(const ConfigSnapshotMsg& msg) {
+    ensureInit();
+    if (msg.version != CONFIG_SYNC_VERSION) {
+        Serial.printf("[Display][UART] Config snapshot version %u, expected %u\n", msg.version, CONFIG_SYNC_VERSION);
         return;
     }
 
-    PadConfigSnapshot& cfg = padConfigs[padId];
-    cfg.padId = padId;
-    if (source.containsKey("threshold")) cfg.threshold = source["threshold"];
-    if (source.containsKey("velocityMin")) cfg.velocityMin = source["velocityMin"];
-    if (source.containsKey("velocityMax")) cfg.velocityMax = source["velocityMax"];
-    if (source.containsKey("velocityCurve")) cfg.velocityCurve = source["velocityCurve"];
-    if (source.containsKey("midiNote")) cfg.midiNote = source["midiNote"];
-    if (source.containsKey("midiChannel")) cfg.midiChannel = source["midiChannel"];
-    if (source.containsKey("ledColorHit")) cfg.ledColorHit = source["ledColorHit"];
-    if (source.containsKey("ledColorIdle")) cfg.ledColorIdle = source["ledColorIdle"];
-    if (source.containsKey("ledBrightness")) cfg.ledBrightness = source["ledBrightness"];
-    if (source.containsKey("sampleName")) copyString(cfg.sampleName, sizeof(cfg.sampleName), source["sampleName"]);
-    if (source.containsKey("name")) copyString(cfg.name, sizeof(cfg.name), source["name"]);
-    if (source.containsKey("enabled")) cfg.enabled = source["enabled"];
-
-    cfg.valid = true;
+    for (uint8_t i = 0; i < msg.padCount && i < padConfigWire.size() && i < CONFIG_SNAPSHOT_PADS; ++i) {
+        padConfigWire[i] = msg.pads[i];
+        publishPadConfig(i);
+    }
+    configGen = msg.generation;
+    configSynced = true;
 }
 
-void LinkState::updateConfigJSON(const char* json) {
+bool LinkState::applyConfigDelta(const uint8_t* payload, uint16_t length) {
     ensureInit();
-    if (!json || json[0] == '\0') {
-        return;
+    // Until a snapshot arrives the mirror is zero-filled: publishing it
+    // would show threshold 0, note 0 and no name as valid config
+    if (!configSynced) {
+        return false;
     }
 
-    DynamicJsonDocument doc(2048);
-    DeserializationError err = deserializeJson(doc, json);
-    if (err) {
-        Serial.printf("[Display][UART] JSON parse error: %s\n", err.c_str());
-        return;
-    }
+    uint8_t touched = 0;  // Bit per pad
+    uint32_t generation = 0;
+    auto onField = [&touched](uint8_t padId, uint8_t field, const uint8_t* value, uint8_t size) {
+        if (padId < padConfigWire.size() && configApplyField(padConfigWire[padId], field, value, size)) {
+            touched |= 1u << padId;
+        }
+    };
+    bool wellFormed = forEachConfigDelta(payload, length, generation, onField);
 
-    if (doc.containsKey("pads")) {
-        JsonArrayConst pads = doc["pads"].as<JsonArrayConst>();
-        uint8_t idx = 0;
-        for (JsonVariantConst pad : pads) {
-            applyPadConfig(idx++, pad);
+    for (uint8_t i = 0; i < padConfigWire.size(); ++i) {
+        if (touched & (1u << i)) {
+            publishPadConfig(i);
         }
-    } else if (doc.containsKey("padId")) {
-        uint8_t padId = doc["padId"] | 0;
-        applyPadConfig(padId, doc.as<JsonVariantConst>());
     }
+
+    // Values are absolute, so applying out of order is harmless; a gap
+    // only means some other change was missed
+    bool inSequence = generation == configGen + 1;
+    if (wellFormed) {
+        configGen = generation;
+    }
+    return wellFormed && inSequence;
+}
+
+uint32_t LinkState::configGeneration() {
+    return configGen;
 }
 
 const PadTelemetry& LinkState::getPadTelemetry(uint8_t padId) {
@@ -202,6 +226,18 @@ void LinkState::updateSampleList(const SampleListMsg& msg) {
     sampleList.valid = true;
 }
 
+void LinkState::updateLoadProgress(const LoadProgressMsg& msg) {
+    ensureInit();
+    loadProgress.state = msg.state;
+    loadProgress.percent = msg.percent;
+    loadProgress.pending = msg.pending;
+    loadProgress.bytesDone = msg.bytesDone;
+    loadProgress.bytesTotal = msg.bytesTotal;
+    copyString(loadProgress.name, sizeof(loadProgress.name), msg.name);
+    loadProgress.lastUpdateMs = millis();
+    loadProgress.valid = true;
+}
+
 const MenuSnapshot& LinkState::getMenuState() {
     ensureInit();
     return menuState.valid ? menuState : menuFallback;
@@ -212,4 +248,9 @@ const SampleListSnapshot& LinkState::getSampleList() {
     return sampleList.valid ? sampleList : sampleListFallback;
 }
 
+const LoadProgressSnapshot& LinkState::getLoadProgress() {
+    ensureInit();
+    return loadProgress;
+}
+
 }  // namespace display::comm
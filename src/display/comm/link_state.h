@@ -2,7 +2,6 @@
 
 #include <Arduino.h>
 #include <array>
-#include <ArduinoJson.h>
 #include <gui_protocol.h>
 #include <edrum_config.h>
 
@@ -71,23 +70,39 @@ struct SampleListSnapshot {
     bool valid;
 };
 
+// Background sample load progress from main brain
+struct LoadProgressSnapshot {
+    uint8_t state;              // LoadStateType
+    uint8_t percent;
+    uint8_t pending;
+    uint32_t bytesDone;
+    uint32_t bytesTotal;
+    char name[48];
+    uint32_t lastUpdateMs;
+    bool valid;
+};
+
 class LinkState {
 public:
     static void init();
     static void updatePadState(const PadStateMsg& msg);
     static void updateSystemStatus(const SystemStatusMsg& msg);
-    static void updateConfigJSON(const char* json);
+    // Binary config mirror (config_sync.h). applyConfigDelta returns false
+    // when the mirror may be stale (no snapshot yet, generation gap, bad
+    // version, malformed delta) and a snapshot should be requested.
+    static void updateConfigSnapshot(const ConfigSnapshotMsg& msg);
+    static bool applyConfigDelta(const uint8_t* payload, uint16_t length);
+    static uint32_t configGeneration();
     static void updateMenuState(const MenuStateMsg& msg);
     static void updateSampleList(const SampleListMsg& msg);
+    static void updateLoadProgress(const LoadProgressMsg& msg);
 
     static const PadTelemetry& getPadTelemetry(uint8_t padId);
     static const SystemTelemetry& getSystemTelemetry();
     static const PadConfigSnapshot& getPadConfig(uint8_t padId);
     static const MenuSnapshot& getMenuState();
     static const SampleListSnapshot& getSampleList();
-
-private:
-    static void applyPadConfig(uint8_t padId, const JsonVariantConst& source);
+    static const LoadProgressSnapshot& getLoadProgress();
 };
 
 }  // namespace display::comm
@@ -3,6 +3,8 @@
 #include <gui_protocol.h>
 #include <edrum_config.h>
 
+#include <algorithm>
+
 #include "../ui/ui_manager.h"
 #include "../drivers/ring_led_controller.h"
 #include "link_state.h"
@@ -10,21 +12,15 @@
 namespace display::comm {
 namespace {
 HardwareSerial* linkSerial = nullptr;
-uint8_t rxBuffer[UART_MAX_PAYLOAD];
-
-void handleConfigJsonPayload(const uint8_t* payload, uint16_t length) {
-    if (!payload || length == 0) {
-        return;
-    }
+FrameParser<UART_MAX_PAYLOAD> rxParser;
+uint32_t lastRxMs = 0;
+uint32_t crcErrorsReported = 0;
 
-    String json;
-    json.reserve(length + 1);
-    for (uint16_t i = 0; i < length; ++i) {
-        json += static_cast<char>(payload[i]);
-    }
+// Commands are encoded whole here and written in one call (loop() only)
+uint8_t txBuffer[frameSize(UART_MAX_PAYLOAD)];
 
-    LinkState::updateConfigJSON(json.c_str());
-}
+uint32_t lastResyncRequestMs = 0;
+bool resyncRequested = false;
 }  // namespace
 
 void UARTLink::begin(HardwareSerial& serial, uint32_t baudrate) {
@@ -41,83 +37,35 @@ void UARTLink::process() {
         return;
     }
 
-    while (linkSerial->available() >= 4) {
-        uint8_t msgType = 0;
-        uint16_t length = 0;
+    auto onFrame = [](uint8_t msgType, const uint8_t* payload, uint16_t length) {
+        handleMessage(msgType, payload, length);
+    };
 
-        if (!receiveMessage(msgType, rxBuffer, length)) {
+    // Only what has already arrived: a partial frame waits in the parser
+    // for the next call instead of spinning here
+    uint8_t chunk[128];
+    size_t budget = UART_RX_BUDGET;
+    int available;
+    while (budget > 0 && (available = linkSerial->available()) > 0) {
+        size_t n = std::min({static_cast<size_t>(available), sizeof(chunk), budget});
+        n = linkSerial->read(chunk, n);
+        if (n == 0) {
             break;
         }
-
-        handleMessage(msgType, rxBuffer, length);
-    }
-}
-
-bool UARTLink::receiveMessage(uint8_t& msgType, uint8_t* payload, uint16_t& length) {
-    if (!linkSerial) {
-        return false;
-    }
-
-    uint32_t start = millis();
-    while (linkSerial->available() > 0 && linkSerial->peek() != UART_START_BYTE) {
-        linkSerial->read();
-        if (millis() - start > UART_TIMEOUT_MS) {
-            return false;
-        }
+        rxParser.parse(chunk, n, onFrame);
+        lastRxMs = millis();
+        budget -= n;
     }
 
-    if (linkSerial->available() < 4) {
-        return false;
-    }
-
-    uint8_t header[4];
-    linkSerial->readBytes(header, 4);
-
-    if (header[0] != UART_START_BYTE) {
-        return false;
-    }
-
-    msgType = header[1];
-    length = static_cast<uint16_t>(header[2] << 8) | header[3];
-    if (length > UART_MAX_PAYLOAD) {
-        return false;
-    }
-
-    start = millis();
-    while (linkSerial->available() < length + 2) {
-        if (millis() - start > UART_TIMEOUT_MS) {
-            return false;
-        }
-    }
-
-    linkSerial->readBytes(payload, length);
-    uint8_t crcHi = linkSerial->read();
-    uint8_t crcLo = linkSerial->read();
-    uint16_t frameCrc = (static_cast<uint16_t>(crcHi) << 8) | crcLo;
-
-    uint16_t calcCrc = calculateCRC16(header, 4);
-    calcCrc = calculateCRC16(payload, length, calcCrc);
-
-    if (frameCrc != calcCrc) {
-        Serial.println("[UART] CRC mismatch from main brain");
-        return false;
+    if (!rxParser.idle() && millis() - lastRxMs > UART_TIMEOUT_MS) {
+        rxParser.expire(onFrame);
     }
 
-    return true;
-}
-
-uint16_t UARTLink::calculateCRC16(const uint8_t* data, uint16_t length, uint16_t crc) {
-    while (length--) {
-        crc ^= *data++ << 8;
-        for (uint8_t i = 0; i < 8; ++i) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
-            }
-        }
+    uint32_t crcErrors = rxParser.stats().crcErrors;
+    if (crcErrors != crcErrorsReported) {
+        Serial.printf("[UART] CRC mismatch from main brain (%lu total)\n", static_cast<unsigned long>(crcErrors));
+        crcErrorsReported = crcErrors;
     }
-    return crc;
 }
 
 bool UARTLink::sendMessage(uint8_t msgType, const uint8_t* payload, uint16_t length) {
@@ -125,23 +73,11 @@ bool UARTLink::sendMessage(uint8_t msgType, const uint8_t* payload, uint16_t len
         return false;
     }
 
-    uint8_t header[4];
-    header[0] = UART_START_BYTE;
-    header[1] = msgType;
-    header[2] = (length >> 8) & 0xFF;
-    header[3] = length & 0xFF;
-
-    uint16_t crc = calculateCRC16(header, 4);
-    if (length > 0 && payload) {
-        crc = calculateCRC16(payload, length, crc);
-    }
-
-    linkSerial->write(header, 4);
-    if (length > 0 && payload) {
-        linkSerial->write(payload, length);
+    size_t frameLength = frameEncode(txBuffer, sizeof(txBuffer), msgType, payload, length);
+    if (frameLength == 0) {
+        return false;
     }
-    linkSerial->write((crc >> 8) & 0xFF);
-    linkSerial->write(crc & 0xFF);
+    linkSerial->write(txBuffer, frameLength);
     return true;
 }
 
@@ -155,42 +91,81 @@ bool UARTLink::sendCommand(uint8_t cmdType, const void* payload, uint16_t length
 
 void UARTLink::requestConfigDump() {
     if (sendCommand(CMD_GET_CONFIG)) {
-        Serial.println("[UART] Requested configuration dump from main brain");
+        resyncRequested = true;
+        lastResyncRequestMs = millis();
+        Serial.println("[UART] Requested configuration snapshot from main brain");
     }
 }
 
 void UARTLink::handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t length) {
     switch (msgType) {
         case MSG_HIT_EVENT:
-            if (length == sizeof(HitEventMsg)) {
-                const HitEventMsg* msg = reinterpret_cast<const HitEventMsg*>(payload);
+            if (const HitEventMsg* msg = decodeMessage<HitEventMsg>(msgType, payload, length)) {
                 ui::UIManager::instance().onPadHit(msg->padId, msg->velocity);
                 RingLEDController::pulsePad(msg->padId, msg->velocity);
             }
             break;
 
         case MSG_PAD_STATE:
-            if (length == sizeof(PadStateMsg)) {
-                const PadStateMsg* state = reinterpret_cast<const PadStateMsg*>(payload);
+            if (const PadStateMsg* state = decodeMessage<PadStateMsg>(msgType, payload, length)) {
                 LinkState::updatePadState(*state);
             }
             break;
 
         case MSG_SYSTEM_STATUS:
-            if (length == sizeof(SystemStatusMsg)) {
-                const SystemStatusMsg* status = reinterpret_cast<const SystemStatusMsg*>(payload);
+            if (const SystemStatusMsg* status = decodeMessage<SystemStatusMsg>(msgType, payload, length)) {
                 LinkState::updateSystemStatus(*status);
             }
             break;
 
-        case MSG_CONFIG_UPDATE:
-        case MSG_CONFIG_DUMP:
-            handleConfigJsonPayload(payload, length);
+        case MSG_LOAD_PROGRESS:
+            if (const LoadProgressMsg* progress = decodeMessage<LoadProgressMsg>(msgType, payload, length)) {
+                LinkState::updateLoadProgress(*progress);
+                ui::UIManager::instance().onLoadProgress(*progress);
+            }
+            break;
+
+        case MSG_MIXER_METERS:
+            if (const MixerMetersMsg* meters = decodeMessage<MixerMetersMsg>(msgType, payload, length)) {
+                ui::UIManager::instance().onMixerMeters(*meters);
+            }
+            break;
+
+        case MSG_TEMPO:
+            if (const TempoMsg* tempo = decodeMessage<TempoMsg>(msgType, payload, length)) {
+                ui::UIManager::instance().onTempo(*tempo);
+            }
+            break;
+
+        case MSG_TELEMETRY_BATCH: {
+            // Hits, pad states, meters... packed by the main brain's TX scheduler
+            auto onRecord = [](uint8_t type, const uint8_t* record, uint16_t size) {
+                handleMessage(type, record, size);
+            };
+            if (!forEachBatchRecord(payload, length, onRecord)) {
+                Serial.printf("[UART] Malformed telemetry batch (len=%u)\n", length);
+            }
+            break;
+        }
+
+        case MSG_CONFIG_SNAPSHOT:
+            if (const ConfigSnapshotMsg* snapshot = decodeMessage<ConfigSnapshotMsg>(msgType, payload, length)) {
+                LinkState::updateConfigSnapshot(*snapshot);
+                resyncRequested = false;
+            }
+            break;
+
+        case MSG_CONFIG_DELTA:
+            // Missed a change (or never synced): one snapshot request per
+            // CONFIG_RESYNC_RETRY_MS, not one per delta
+            if (!LinkState::applyConfigDelta(payload, length) &&
+                (!resyncRequested || millis() - lastResyncRequestMs > CONFIG_RESYNC_RETRY_MS)) {
+                requestConfigDump();
+            }
             break;
 
         case MSG_CALIBRATION_DATA:
-            if (length == sizeof(CalibrationDataMsg)) {
-                const CalibrationDataMsg* data = reinterpret_cast<const CalibrationDataMsg*>(payload);
+            if (const CalibrationDataMsg* data = decodeMessage<CalibrationDataMsg>(msgType, payload, length)) {
                 Serial.printf("[UART] Calibration pad %u: baseline=%u noise=%u suggested=%u\n",
                               data->padId,
                               data->baseline,
@@ -200,11 +175,13 @@ void UARTLink::handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t l
             break;
 
         case MSG_ACK:
+#ifdef DEBUG_UART_PROTOCOL
             if (length >= 1) {
                 Serial.printf("[UART] ACK for command 0x%02X\n", payload[0]);
             } else {
                 Serial.println("[UART] ACK received");
             }
+#endif
             break;
 
         case MSG_NACK:
@@ -217,23 +194,25 @@ void UARTLink::handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t l
             break;
 
         case MSG_MENU_STATE:
-            if (length == sizeof(MenuStateMsg)) {
-                const MenuStateMsg* menu = reinterpret_cast<const MenuStateMsg*>(payload);
+            if (const MenuStateMsg* menu = decodeMessage<MenuStateMsg>(msgType, payload, length)) {
                 LinkState::updateMenuState(*menu);
                 ui::UIManager::instance().onMenuState(*menu);
+#ifdef DEBUG_UART_PROTOCOL
                 Serial.printf("[UART] Menu state: %d, pad: %s, opt: %s\n",
                               menu->state, menu->padName, menu->optionName);
+#endif
             }
             break;
 
         case MSG_MENU_SAMPLES:
-            if (length == sizeof(SampleListMsg)) {
-                const SampleListMsg* samples = reinterpret_cast<const SampleListMsg*>(payload);
+            if (const SampleListMsg* samples = decodeMessage<SampleListMsg>(msgType, payload, length)) {
                 LinkState::updateSampleList(*samples);
                 ui::UIManager::instance().onSampleList(*samples);
+#ifdef DEBUG_UART_PROTOCOL
                 Serial.printf("[UART] Sample list: %d samples, showing %d-%d\n",
                               samples->totalCount, samples->startIndex,
                               samples->startIndex + samples->count - 1);
+#endif
             }
             break;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <gui_protocol.h>
 
 namespace display::comm {
 
@@ -9,12 +10,16 @@ public:
     static void begin(HardwareSerial& serial, uint32_t baudrate);
     static void process();
     static bool sendCommand(uint8_t cmdType, const void* payload = nullptr, uint16_t length = 0);
+
+    // Fixed-size commands: type id and size come from GUI_MESSAGE_TABLE
+    template <typename Msg>
+    static bool sendTyped(const Msg& msg) {
+        return sendCommand(MessageTraits<Msg>::TYPE, &msg, MessageTraits<Msg>::SIZE);
+    }
     static void requestConfigDump();
 
 private:
-    static bool receiveMessage(uint8_t& msgType, uint8_t* payload, uint16_t& length);
     static bool sendMessage(uint8_t msgType, const uint8_t* payload, uint16_t length);
-    static uint16_t calculateCRC16(const uint8_t* data, uint16_t length, uint16_t crc = 0xFFFF);
     static void handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t length);
 };
 
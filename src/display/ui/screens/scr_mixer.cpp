@@ -4,7 +4,12 @@
 
 namespace ui {
 
-MixerScreen::MixerScreen() : levelArcs{nullptr, nullptr, nullptr, nullptr}, labels{nullptr, nullptr, nullptr, nullptr}, selected(0) {
+MixerScreen::MixerScreen()
+    : levelArcs{nullptr, nullptr, nullptr, nullptr},
+      labels{nullptr, nullptr, nullptr, nullptr},
+      masterLabel(nullptr),
+      masterVolume(0xFF),
+      selected(0) {
     buildLayout();
 }
 
@@ -61,9 +66,32 @@ void MixerScreen::buildLayout() {
         labels[i] = label;
     }
 
+    // Master volume in the center
+    masterLabel = lv_label_create(root());
+    lv_label_set_text(masterLabel, "MASTER");
+    lv_obj_add_style(masterLabel, &UITheme::labelSmall(), LV_PART_MAIN);
+    lv_obj_center(masterLabel);
+
     updateSelectionColor();
 }
 
+void MixerScreen::updateMeters(const MixerMetersMsg &meters) {
+    for (size_t i = 0; i < levelArcs.size() && i < MIXER_METER_BUSES; i++) {
+        setLevel(i, meters.peak[i]);
+
+        // Muted pads (or pads silenced by another pad's solo) are dimmed
+        bool silenced = (meters.muteMask & (1 << i)) || (meters.soloMask && !(meters.soloMask & (1 << i)));
+        lv_obj_set_style_text_opa(labels[i], silenced ? LV_OPA_30 : LV_OPA_COVER, LV_PART_MAIN);
+    }
+
+    if (meters.masterVolume != masterVolume) {
+        masterVolume = meters.masterVolume;
+        char text[16];
+        snprintf(text, sizeof(text), "MASTER %u%%", static_cast<unsigned>(masterVolume * 100 / 127));
+        lv_label_set_text(masterLabel, text);
+    }
+}
+
 void MixerScreen::setLevel(uint8_t padIndex, uint8_t level) {
     if (padIndex >= levelArcs.size() || levelArcs[padIndex] == nullptr) {
         return;
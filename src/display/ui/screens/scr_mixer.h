@@ -13,6 +13,7 @@ public:
 
     void setLevel(uint8_t padIndex, uint8_t level);
     void setSelected(uint8_t padIndex);
+    void updateMeters(const MixerMetersMsg &meters);
 
     void onEncoderLeft(int32_t delta, bool pressed) override;
     void onEncoderRight(int32_t delta, bool pressed) override;
@@ -23,6 +24,8 @@ private:
 
     std::array<lv_obj_t *, 4> levelArcs;
     std::array<lv_obj_t *, 4> labels;
+    lv_obj_t *masterLabel;
+    uint8_t masterVolume;
     uint8_t selected;
 };
 
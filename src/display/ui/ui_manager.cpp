@@ -37,7 +37,8 @@ UIManager::UIManager()
       activeView(ViewId::Performance),
       activeScreen(nullptr),
       initialized(false),
-      toastBox(nullptr) {}
+      toastBox(nullptr),
+      loadBar(nullptr) {}
 
 UIManager &UIManager::instance() {
     static UIManager inst;
@@ -167,6 +168,49 @@ void UIManager::onSampleList(const SampleListMsg& samples) {
     }
 }
 
+void UIManager::onMixerMeters(const MixerMetersMsg& meters) {
+    // Meters arrive at a fixed rate; only the visible mixer redraws
+    if (activeView == ViewId::Mixer) {
+        MixerScreen* mixer = static_cast<MixerScreen*>(screens[static_cast<int>(ViewId::Mixer)]);
+        if (mixer) {
+            mixer->updateMeters(meters);
+        }
+    }
+}
+
+void UIManager::onTempo(const TempoMsg& tempo) {
+    // The performance screen keeps its label even while hidden
+    PerformanceScreen* performance = static_cast<PerformanceScreen*>(screens[static_cast<int>(ViewId::Performance)]);
+    if (performance) {
+        performance->setBpm(static_cast<uint16_t>((tempo.bpmX10 + 5) / 10));
+    }
+}
+
+void UIManager::onLoadProgress(const LoadProgressMsg& progress) {
+    if (progress.state == LOAD_STATE_LOADING) {
+        // Thin progress bar on the top layer, visible over any screen
+        if (!loadBar) {
+            loadBar = lv_bar_create(lv_layer_top());
+            lv_obj_set_size(loadBar, 160, 6);
+            lv_obj_align(loadBar, LV_ALIGN_BOTTOM_MID, 0, -24);
+            lv_bar_set_range(loadBar, 0, 100);
+            lv_obj_set_style_bg_color(loadBar, UITheme::palette().background, LV_PART_MAIN);
+            lv_obj_set_style_bg_color(loadBar, UITheme::palette().accent, LV_PART_INDICATOR);
+        }
+        lv_bar_set_value(loadBar, progress.percent, LV_ANIM_ON);
+        return;
+    }
+
+    // Keep the bar while more requests are queued behind this one
+    if (loadBar && progress.pending == 0) {
+        lv_obj_del(loadBar);
+        loadBar = nullptr;
+    }
+    if (progress.state == LOAD_STATE_FAILED) {
+        showToast("LOAD FAILED", 2000);
+    }
+}
+
 void UIManager::loadScreen(UIScreen *target, bool animated) {
     if (!target) {
         return;
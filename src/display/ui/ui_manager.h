@@ -49,6 +49,9 @@ public:
     // Menu state handlers from UART
     void onMenuState(const MenuStateMsg& state);
     void onSampleList(const SampleListMsg& samples);
+    void onLoadProgress(const LoadProgressMsg& progress);
+    void onMixerMeters(const MixerMetersMsg& meters);
+    void onTempo(const TempoMsg& tempo);
 
     // Show temporary toast notification
     void showToast(const char* message, uint16_t durationMs = 1500);
@@ -63,6 +66,7 @@ private:
     UIScreen *activeScreen;
     bool initialized;
     lv_obj_t *toastBox;
+    lv_obj_t *loadBar;
 };
 
 }  // namespace ui
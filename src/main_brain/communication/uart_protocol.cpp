@@ -1,7 +1,11 @@
 #include "uart_protocol.h"
 #include "pad_config.h"
-#include <ArduinoJson.h>
 #include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <algorithm>
+#include "../core/system_watchdog.h"
+#include "../core/log_ring.h"
 
 // Static member initialization
 HardwareSerial* UARTProtocol::uart = nullptr;
@@ -9,14 +13,75 @@ uint32_t UARTProtocol::txCount = 0;
 uint32_t UARTProtocol::rxCount = 0;
 uint32_t UARTProtocol::errorCount = 0;
 
+static FrameParser<UART_MAX_PAYLOAD> rxParser;
+static uint32_t lastRxMs = 0;
+
+// Frames are encoded whole into txBuffer and handed to the driver in one
+// write. The mutex serializes senders (loop() and the sample loader task),
+// which also keeps their frames from interleaving on the wire.
+static uint8_t txBuffer[frameSize(UART_MAX_PAYLOAD)];
+static SemaphoreHandle_t txMutex = nullptr;
+
+// Telemetry scheduler state (loop() only). Hits wait in a FIFO; everything
+// else is one latest-value slot per message (per pad for pad states).
+static HitEventMsg hitQueue[QUEUE_SIZE_UART_TX];
+static uint8_t hitHead = 0;
+static uint8_t hitCount = 0;
+
+struct LatestSlot {
+    uint8_t type;
+    uint8_t size;
+    bool pending;
+    uint32_t minIntervalUs;
+    uint32_t lastSentUs;
+    uint8_t payload[sizeof(SystemStatusMsg)];  // Largest slot message
+};
+
+enum : uint8_t {
+    SLOT_PAD_STATE = 0,          // One per pad
+    SLOT_TEMPO = NUM_PADS,
+    SLOT_SYSTEM_STATUS,
+    SLOT_MIXER_METERS,
+    SLOT_COUNT
+};
+
+static LatestSlot slots[SLOT_COUNT];
+
+// Display state sent as whole frames, latest value only (loop() only)
+struct FrameSlot {
+    uint8_t type;
+    uint16_t size;
+    bool pending;
+    uint8_t payload[sizeof(SampleListMsg)];  // Largest frame slot message
+};
+
+enum : uint8_t {
+    FRAME_MENU_STATE = 0,
+    FRAME_SAMPLE_LIST,           // After the menu state it belongs to
+    FRAME_LOAD_PROGRESS,
+    FRAME_SLOT_COUNT
+};
+
+static FrameSlot frameSlots[FRAME_SLOT_COUNT];
+static uint32_t lastTxTickUs = 0;
+static UARTProtocol::TxStats txStats = {};
+
+// Config mirror sequence: +1 per MSG_CONFIG_DELTA, carried by snapshots
+static uint32_t configSeq = 0;
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
 
 void UARTProtocol::begin(HardwareSerial& serial, uint32_t baudrate, int8_t rxPin, int8_t txPin) {
+    if (!txMutex) txMutex = xSemaphoreCreateMutex();
+    for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+        slots[i].minIntervalUs = i < SLOT_TEMPO ? UART_TX_PAD_STATE_PERIOD_US : 0;
+    }
     uart = &serial;
     uart->end();
     uart->setRxBufferSize(4096);  // Larger buffer for config messages
+    uart->setTxBufferSize(UART_TX_BUFFER_SIZE);  // Without it every write waits for the FIFO
     if (rxPin >= 0 || txPin >= 0) {
         uart->begin(baudrate, SERIAL_8N1, rxPin, txPin);
     } else {
@@ -29,57 +94,82 @@ void UARTProtocol::begin(HardwareSerial& serial, uint32_t baudrate, int8_t rxPin
 // SEND MESSAGES TO GUI
 // ============================================================================
 
-void UARTProtocol::sendHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp, uint16_t peakValue) {
-    HitEventMsg msg = {
-        .padId = padId,
-        .velocity = velocity,
-        .timestamp = timestamp,
-        .peakValue = peakValue
-    };
-    sendMessage(MSG_HIT_EVENT, &msg, sizeof(msg));
+static void toWire(const PadConfig& cfg, PadConfigWire& wire) {
+    wire.threshold = cfg.threshold;
+    wire.velocityMin = cfg.velocityMin;
+    wire.velocityMax = cfg.velocityMax;
+    wire.velocityCurve = cfg.velocityCurve;
+    wire.crosstalkEnabled = cfg.crosstalkEnabled ? 1 : 0;
+    wire.crosstalkWindow = cfg.crosstalkWindow;
+    wire.crosstalkRatio = cfg.crosstalkRatio;
+    wire.midiNote = cfg.midiNote;
+    wire.midiChannel = cfg.midiChannel;
+    memcpy(wire.sampleName, cfg.sampleName, sizeof(wire.sampleName));
+    wire.sampleName[sizeof(wire.sampleName) - 1] = '\0';
+    wire.sampleVolume = cfg.sampleVolume;
+    wire.chokeGroup = cfg.chokeGroup;
+    wire.rimChokeGroup = cfg.rimChokeGroup;
+    wire.ledColorHit = cfg.ledColorHit;
+    wire.ledColorIdle = cfg.ledColorIdle;
+    wire.ledBrightness = cfg.ledBrightness;
+    memcpy(wire.name, cfg.name, sizeof(wire.name));
+    wire.name[sizeof(wire.name) - 1] = '\0';
+    wire.enabled = cfg.enabled ? 1 : 0;
 }
 
-void UARTProtocol::sendPadState(uint8_t padId, uint8_t state, uint16_t signal, uint16_t baseline, uint16_t peak) {
-    PadStateMsg msg = {
-        .padId = padId,
-        .state = state,
-        .currentSignal = signal,
-        .baseline = baseline,
-        .peakValue = peak
-    };
-    sendMessage(MSG_PAD_STATE, &msg, sizeof(msg));
-}
-
-void UARTProtocol::sendSystemStatus() {
-    SystemStatusMsg msg = {
-        .cpuCore0 = 0,  // TODO: Implement CPU monitoring
-        .cpuCore1 = 0,
-        .freeHeap = ESP.getFreeHeap(),
-        .freePSRAM = ESP.getFreePsram(),
-        .temperature = (int16_t)(temperatureRead() * 10),
-        .uptime = (uint32_t)(millis() / 1000)
-    };
-    sendMessage(MSG_SYSTEM_STATUS, &msg, sizeof(msg));
+// Sends the fields PadConfigManager::markChanged() recorded since the last
+// tick: one delta for all touched pads, or a snapshot after a bulk change
+// (or if the delta would not be smaller). Waits while the TX buffer could
+// not take a snapshot, so the marks pile up instead of blocking loop().
+void UARTProtocol::syncConfig() {
+    if (uart->availableForWrite() < (int)frameSize(sizeof(ConfigSnapshotMsg))) return;
+
+    uint32_t pending[NUM_PADS];
+    bool any = false;
+    bool bulk = false;
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        pending[i] = PadConfigManager::takePendingFields(i);
+        any |= pending[i] != 0;
+        bulk |= pending[i] == CONFIG_FIELDS_ALL;
+    }
+    if (!any) return;
+
+    if (!bulk) {
+        uint8_t payload[sizeof(ConfigSnapshotMsg)];
+        size_t used = configDeltaBegin(payload, configSeq + 1);
+        bool fits = true;
+        for (uint8_t pad = 0; pad < NUM_PADS && fits; pad++) {
+            if (!pending[pad]) continue;
+            PadConfigWire wire;
+            toWire(PadConfigManager::getConfig(pad), wire);
+            ConfigFieldInfo info;
+            for (uint8_t field = 0; field < 32 && fits; field++) {
+                if (!(pending[pad] & configFieldBit(field)) || !configFieldInfo(field, info)) continue;
+                size_t next = configDeltaAppend(payload, used, sizeof(payload), pad, field, wire);
+                fits = next != used;
+                used = next;
+            }
+        }
+        if (fits) {
+            configSeq++;
+            sendMessage(MSG_CONFIG_DELTA, payload, used);
+            return;
+        }
+    }
+    sendConfigSnapshot();
 }
 
-void UARTProtocol::sendConfigUpdate(uint8_t padId) {
-    // Send individual pad config as JSON
-    DynamicJsonDocument doc(256);
-    PadConfig& cfg = PadConfigManager::getConfig(padId);
-
-    doc["padId"] = padId;
-    doc["threshold"] = cfg.threshold;
-    doc["velocityMin"] = cfg.velocityMin;
-    doc["velocityMax"] = cfg.velocityMax;
-    doc["velocityCurve"] = cfg.velocityCurve;
-    doc["midiNote"] = cfg.midiNote;
-    doc["sampleName"] = cfg.sampleName;
-    doc["ledColorHit"] = cfg.ledColorHit;
-    doc["ledColorIdle"] = cfg.ledColorIdle;
-
-    String json;
-    serializeJson(doc, json);
-    sendMessage(MSG_CONFIG_UPDATE, json.c_str(), json.length() + 1);
+void UARTProtocol::sendConfigSnapshot() {
+    static_assert(NUM_PADS <= CONFIG_SNAPSHOT_PADS, "snapshot holds fewer pads than NUM_PADS");
+    ConfigSnapshotMsg msg = {};
+    msg.version = CONFIG_SYNC_VERSION;
+    msg.generation = configSeq;
+    msg.padCount = NUM_PADS;
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        PadConfigManager::takePendingFields(i);  // Covered by this snapshot
+        toWire(PadConfigManager::getConfig(i), msg.pads[i]);
+    }
+    sendTyped(msg);
 }
 
 void UARTProtocol::sendConfigDump() {
@@ -94,7 +184,7 @@ void UARTProtocol::sendCalibrationData(uint8_t padId, uint16_t baseline, uint16_
         .noiseFloor = noise,
         .suggestedThreshold = suggested
     };
-    sendMessage(MSG_CALIBRATION_DATA, &msg, sizeof(msg));
+    sendTyped(msg);
 }
 
 void UARTProtocol::sendAck(uint8_t cmdType) {
@@ -113,204 +203,327 @@ void UARTProtocol::sendRawCommand(uint8_t cmdType, const uint8_t* data, uint16_t
     sendMessage(cmdType, data, length);
 }
 
-void UARTProtocol::sendMenuState(const MenuStateMsg& msg) {
-    sendMessage(MSG_MENU_STATE, &msg, sizeof(msg));
-}
-
-void UARTProtocol::sendSampleList(const SampleListMsg& msg) {
-    sendMessage(MSG_MENU_SAMPLES, &msg, sizeof(msg));
-}
-
 // ============================================================================
-// PROCESS INCOMING MESSAGES FROM GUI
+// TELEMETRY SCHEDULER
 // ============================================================================
 
-void UARTProtocol::processIncoming() {
-    if (!uart || uart->available() < 5) return;  // Need at least header
-
-    uint8_t msgType;
-    uint8_t payload[UART_MAX_PAYLOAD];
-    uint16_t length;
-
-    if (receiveMessage(msgType, payload, length)) {
-        rxCount++;
-
-        // Dispatch to handlers
-        switch (msgType) {
-            case CMD_SET_THRESHOLD:
-                if (length == sizeof(SetThresholdCmd)) {
-                    handleSetThreshold(*(SetThresholdCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_VELOCITY_RANGE:
-                if (length == sizeof(SetVelocityRangeCmd)) {
-                    handleSetVelocityRange(*(SetVelocityRangeCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_VELOCITY_CURVE:
-                if (length == sizeof(SetVelocityCurveCmd)) {
-                    handleSetVelocityCurve(*(SetVelocityCurveCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_MIDI_NOTE:
-                if (length == sizeof(SetMidiNoteCmd)) {
-                    handleSetMidiNote(*(SetMidiNoteCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_SAMPLE:
-                if (length == sizeof(SetSampleCmd)) {
-                    handleSetSample(*(SetSampleCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_LED_COLOR:
-                if (length == sizeof(SetLEDColorCmd)) {
-                    handleSetLEDColor(*(SetLEDColorCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_CROSSTALK:
-                if (length == sizeof(SetCrosstalkCmd)) {
-                    handleSetCrosstalk(*(SetCrosstalkCmd*)payload);
-                }
-                break;
-
-            case CMD_SET_FULL_CONFIG:
-                handleSetFullConfig((char*)payload);
-                break;
-
-            case CMD_GET_CONFIG:
-                handleGetConfig();
-                break;
-
-            case CMD_SAVE_CONFIG:
-                handleSaveConfig();
-                break;
-
-            case CMD_LOAD_CONFIG:
-                handleLoadConfig();
-                break;
-
-            case CMD_RESET_CONFIG:
-                if (length >= 1) {
-                    handleResetConfig(payload[0]);
-                }
-                break;
-
-            case CMD_REBOOT:
-                sendAck(CMD_REBOOT);
-                delay(100);
-                ESP.restart();
-                break;
-
-            default:
-                sendNack(msgType, "Unknown command");
-                errorCount++;
-                break;
-        }
+template <typename Msg>
+static void storeLatest(uint8_t slotIndex, const Msg& msg) {
+    static_assert(sizeof(Msg) <= sizeof(LatestSlot::payload), "slot payload too small");
+    LatestSlot& slot = slots[slotIndex];
+    if (slot.pending) txStats.superseded++;
+    slot.type = MessageTraits<Msg>::TYPE;
+    slot.size = MessageTraits<Msg>::SIZE;
+    memcpy(slot.payload, &msg, sizeof(Msg));
+    slot.pending = true;
+}
+
+void UARTProtocol::queueHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp, uint16_t peakValue) {
+    if (hitCount == QUEUE_SIZE_UART_TX) {
+        // Link stalled: the display loses the oldest flash, playback is unaffected
+        hitHead = (hitHead + 1) % QUEUE_SIZE_UART_TX;
+        hitCount--;
+        txStats.hitsDropped++;
     }
+    HitEventMsg& msg = hitQueue[(hitHead + hitCount) % QUEUE_SIZE_UART_TX];
+    msg.padId = padId;
+    msg.velocity = velocity;
+    msg.timestamp = timestamp;
+    msg.peakValue = peakValue;
+    hitCount++;
 }
 
-// ============================================================================
-// LOW-LEVEL PROTOCOL
-// ============================================================================
+void UARTProtocol::queuePadState(uint8_t padId, uint8_t state, uint16_t signal, uint16_t baseline, uint16_t peak) {
+    if (padId >= NUM_PADS) return;
+    PadStateMsg msg = {
+        .padId = padId,
+        .state = state,
+        .currentSignal = signal,
+        .baseline = baseline,
+        .peakValue = peak
+    };
+    storeLatest(SLOT_PAD_STATE + padId, msg);
+}
 
-void UARTProtocol::sendMessage(uint8_t msgType, const void* payload, uint16_t length) {
-    if (!uart || length > UART_MAX_PAYLOAD) return;
+void UARTProtocol::queueSystemStatus() {
+    SystemWatchdog::SystemHealth health = SystemWatchdog::getHealth();
+    SystemStatusMsg msg = {
+        // Load = 100 - idle; 0 while the measurement is off
+        .cpuCore0 = (uint8_t)(health.cpuMeasured ? 100 - health.cpuIdlePct[0] : 0),
+        .cpuCore1 = (uint8_t)(health.cpuMeasured ? 100 - health.cpuIdlePct[1] : 0),
+        .freeHeap = ESP.getFreeHeap(),
+        .freePSRAM = ESP.getFreePsram(),
+        .temperature = (int16_t)(temperatureRead() * 10),
+        .uptime = (uint32_t)(millis() / 1000)
+    };
+    storeLatest(SLOT_SYSTEM_STATUS, msg);
+}
 
-    uint8_t header[4];
-    header[0] = UART_START_BYTE;
-    header[1] = msgType;
-    header[2] = (length >> 8) & 0xFF;
-    header[3] = length & 0xFF;
+void UARTProtocol::queueMixerMeters(const MixerMetersMsg& msg) {
+    storeLatest(SLOT_MIXER_METERS, msg);
+}
 
-    // Calculate CRC over header + payload
-    uint16_t crc = calculateCRC16(header, 4);
-    crc = calculateCRC16((const uint8_t*)payload, length, crc);
+void UARTProtocol::queueTempo(const TempoMsg& msg) {
+    storeLatest(SLOT_TEMPO, msg);
+}
+
+template <typename Msg>
+static void storeFrame(uint8_t slotIndex, const Msg& msg) {
+    static_assert(sizeof(Msg) <= sizeof(FrameSlot::payload), "frame slot payload too small");
+    FrameSlot& slot = frameSlots[slotIndex];
+    if (slot.pending) txStats.superseded++;
+    slot.type = MessageTraits<Msg>::TYPE;
+    slot.size = MessageTraits<Msg>::SIZE;
+    memcpy(slot.payload, &msg, sizeof(Msg));
+    slot.pending = true;
+}
 
-    // Send: [HEADER][PAYLOAD][CRC]
-    uart->write(header, 4);
-    uart->write((const uint8_t*)payload, length);
-    uart->write((crc >> 8) & 0xFF);
-    uart->write(crc & 0xFF);
+void UARTProtocol::queueMenuState(const MenuStateMsg& msg) {
+    storeFrame(FRAME_MENU_STATE, msg);
+}
 
-    txCount++;
+void UARTProtocol::queueSampleList(const SampleListMsg& msg) {
+    storeFrame(FRAME_SAMPLE_LIST, msg);
 }
 
-bool UARTProtocol::receiveMessage(uint8_t& msgType, uint8_t* payload, uint16_t& length) {
-    if (!uart) return false;
+void UARTProtocol::queueLoadProgress(const LoadProgressMsg& msg) {
+    storeFrame(FRAME_LOAD_PROGRESS, msg);
+}
 
-    // Wait for start byte
-    uint32_t startTime = millis();
-    while (uart->available() > 0 && uart->peek() != UART_START_BYTE) {
-        uart->read();  // Discard garbage
-        if (millis() - startTime > UART_TIMEOUT_MS) return false;
+// Writes pending frame slots in order while the TX buffer takes each whole
+// frame; the first one that does not fit waits (and keeps the ones behind
+// it waiting) for the next tick
+void UARTProtocol::flushFrameSlots() {
+    for (FrameSlot& slot : frameSlots) {
+        if (!slot.pending) continue;
+        if (uart->availableForWrite() < (int)frameSize(slot.size)) {
+            txStats.deferredTicks++;
+            return;
+        }
+        slot.pending = false;
+        sendMessage(slot.type, slot.payload, slot.size);
     }
+}
 
-    if (uart->available() < 4) return false;
+void UARTProtocol::flushTelemetry() {
+    if (!uart || !txMutex) return;
 
-    // Read header
-    uint8_t header[4];
-    uart->readBytes(header, 4);
+    uint32_t nowUs = micros();
+    if (nowUs - lastTxTickUs < UART_TX_TICK_US) return;
+    lastTxTickUs = nowUs;
 
-    if (header[0] != UART_START_BYTE) {
-        errorCount++;
-        return false;
-    }
+    syncConfig();
+    flushFrameSlots();
 
-    msgType = header[1];
-    length = (header[2] << 8) | header[3];
+    bool latestPending = false;
+    for (const LatestSlot& slot : slots) latestPending |= slot.pending;
+    if (hitCount == 0 && !latestPending) return;
 
-    if (length > UART_MAX_PAYLOAD) {
-        errorCount++;
-        return false;
+    // Only what the driver's TX buffer takes right now: the write below
+    // returns at once and the UART ISR drains it in the background
+    int freeBytes = uart->availableForWrite();
+    if (freeBytes <= FRAME_OVERHEAD) {
+        txStats.deferredTicks++;
+        return;
+    }
+    size_t capacity = std::min<size_t>(freeBytes - FRAME_OVERHEAD, UART_MAX_PAYLOAD);
+
+    xSemaphoreTake(txMutex, portMAX_DELAY);
+    uint8_t* body = frameBody(txBuffer);
+    size_t used = 0;
+
+    // Hits first and all of them that fit; the rest wait for the next tick
+    while (hitCount > 0) {
+        size_t next = batchAppend(body, used, capacity, hitQueue[hitHead]);
+        if (next == used) break;
+        used = next;
+        hitHead = (hitHead + 1) % QUEUE_SIZE_UART_TX;
+        hitCount--;
+        txStats.hitsSent++;
     }
 
-    // Wait for payload + CRC
-    startTime = millis();
-    while (uart->available() < length + 2) {
-        if (millis() - startTime > UART_TIMEOUT_MS) {
-            errorCount++;
-            return false;
+    // Non-essential: rate limited per slot, and held back entirely while
+    // the link is backed up (a newer value replaces the held one)
+    if (freeBytes < UART_TX_LOW_WATER) {
+        if (latestPending) txStats.lowWaterTicks++;
+    } else {
+        for (LatestSlot& slot : slots) {
+            if (!slot.pending || nowUs - slot.lastSentUs < slot.minIntervalUs) continue;
+            size_t next = batchAppend(body, used, capacity, slot.type, slot.payload, slot.size);
+            if (next == used) break;
+            used = next;
+            slot.pending = false;
+            slot.lastSentUs = nowUs;
         }
-        delay(1);
     }
 
-    // Read payload
-    uart->readBytes(payload, length);
+    if (used > 0) {
+        uart->write(txBuffer, frameSeal(txBuffer, MSG_TELEMETRY_BATCH, used));
+        txCount++;
+        txStats.batches++;
+        if (used > txStats.maxBatchBytes) txStats.maxBatchBytes = used;
+    } else if (hitCount > 0) {
+        txStats.deferredTicks++;
+    }
+    xSemaphoreGive(txMutex);
+}
+
+UARTProtocol::TxStats UARTProtocol::getTxStats() {
+    return txStats;
+}
+
+void UARTProtocol::printTxStats() {
+    Serial.printf("[UART] TX: %lu frames, %lu batches (max %u B), hits %lu sent / %lu dropped, "
+                  "%lu superseded, %lu deferred, %lu low-water ticks, %lu blocked writes, %d B free\n",
+                  (unsigned long)txCount, (unsigned long)txStats.batches, txStats.maxBatchBytes,
+                  (unsigned long)txStats.hitsSent, (unsigned long)txStats.hitsDropped,
+                  (unsigned long)txStats.superseded, (unsigned long)txStats.deferredTicks,
+                  (unsigned long)txStats.lowWaterTicks, (unsigned long)txStats.blockedWrites,
+                  uart ? uart->availableForWrite() : 0);
+}
+
+// ============================================================================
+// PROCESS INCOMING MESSAGES FROM GUI
+// ============================================================================
+
+void UARTProtocol::processIncoming() {
+    if (!uart) return;
 
-    // Read CRC
-    uint16_t receivedCRC = (uart->read() << 8) | uart->read();
+    auto onFrame = [](uint8_t msgType, const uint8_t* payload, uint16_t length) {
+        handleMessage(msgType, payload, length);
+    };
 
-    // Verify CRC
-    uint16_t calculatedCRC = calculateCRC16(header, 4);
-    calculatedCRC = calculateCRC16(payload, length, calculatedCRC);
+    uint8_t chunk[128];
+    size_t budget = UART_RX_BUDGET;
+    int available;
+    while (budget > 0 && (available = uart->available()) > 0) {
+        size_t n = std::min({(size_t)available, sizeof(chunk), budget});
+        n = uart->read(chunk, n);
+        if (n == 0) break;
+        rxParser.parse(chunk, n, onFrame);
+        lastRxMs = millis();
+        budget -= n;
+    }
 
-    if (receivedCRC != calculatedCRC) {
-        errorCount++;
-        return false;
+    // A frame that stopped mid-way (link glitch, noise byte that looked like
+    // a header) is rescanned instead of stalling the parser
+    if (!rxParser.idle() && millis() - lastRxMs > UART_TIMEOUT_MS) {
+        rxParser.expire(onFrame);
     }
+}
 
-    return true;
+uint32_t UARTProtocol::getErrorCount() {
+    const auto& stats = rxParser.stats();
+    return errorCount + stats.crcErrors + stats.lengthErrors + stats.timeouts;
 }
 
-uint16_t UARTProtocol::calculateCRC16(const uint8_t* data, uint16_t length, uint16_t crc) {
-    // CRC-16-CCITT (polynomial 0x1021)
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= (uint16_t)data[i] << 8;
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
+void UARTProtocol::handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t length) {
+    rxCount++;
+
+    // Dispatch to handlers
+    switch (msgType) {
+        case CMD_SET_THRESHOLD:
+            if (auto cmd = decodeMessage<SetThresholdCmd>(msgType, payload, length)) {
+                handleSetThreshold(*cmd);
             }
-        }
+            break;
+
+        case CMD_SET_VELOCITY_RANGE:
+            if (auto cmd = decodeMessage<SetVelocityRangeCmd>(msgType, payload, length)) {
+                handleSetVelocityRange(*cmd);
+            }
+            break;
+
+        case CMD_SET_VELOCITY_CURVE:
+            if (auto cmd = decodeMessage<SetVelocityCurveCmd>(msgType, payload, length)) {
+                handleSetVelocityCurve(*cmd);
+            }
+            break;
+
+        case CMD_SET_MIDI_NOTE:
+            if (auto cmd = decodeMessage<SetMidiNoteCmd>(msgType, payload, length)) {
+                handleSetMidiNote(*cmd);
+            }
+            break;
+
+        case CMD_SET_SAMPLE:
+            if (auto cmd = decodeMessage<SetSampleCmd>(msgType, payload, length)) {
+                handleSetSample(*cmd);
+            }
+            break;
+
+        case CMD_SET_LED_COLOR:
+            if (auto cmd = decodeMessage<SetLEDColorCmd>(msgType, payload, length)) {
+                handleSetLEDColor(*cmd);
+            }
+            break;
+
+        case CMD_SET_CROSSTALK:
+            if (auto cmd = decodeMessage<SetCrosstalkCmd>(msgType, payload, length)) {
+                handleSetCrosstalk(*cmd);
+            }
+            break;
+
+        case CMD_SET_FULL_CONFIG:
+            // The JSON comes NUL-terminated; the payload lives in the parser window
+            if (length > 0 && payload[length - 1] == '\0') {
+                handleSetFullConfig((const char*)payload);
+            }
+            break;
+
+        case CMD_GET_CONFIG:
+            handleGetConfig();
+            break;
+
+        case CMD_EXPORT_CONFIG:
+            handleExportConfig();
+            break;
+
+        case CMD_SAVE_CONFIG:
+            handleSaveConfig();
+            break;
+
+        case CMD_LOAD_CONFIG:
+            handleLoadConfig();
+            break;
+
+        case CMD_RESET_CONFIG:
+            if (length >= 1) {
+                handleResetConfig(payload[0]);
+            }
+            break;
+
+        case CMD_REBOOT:
+            sendAck(CMD_REBOOT);
+            delay(100);
+            ESP.restart();
+            break;
+
+        default:
+            sendNack(msgType, "Unknown command");
+            errorCount++;
+            break;
+    }
+}
+
+// ============================================================================
+// LOW-LEVEL PROTOCOL
+// ============================================================================
+
+void UARTProtocol::sendMessage(uint8_t msgType, const void* payload, uint16_t length) {
+    if (!uart || !txMutex || length > UART_MAX_PAYLOAD) return;
+
+    xSemaphoreTake(txMutex, portMAX_DELAY);
+    size_t frameLength = frameEncode(txBuffer, sizeof(txBuffer), msgType, payload, length);
+    if (frameLength > 0) {
+        // Queued messages wait in flushTelemetry() until they fit; only the
+        // immediate sends (replies, config dump) get here short of room, and
+        // then this write blocks until the UART drains enough
+        if (uart->availableForWrite() < (int)frameLength) txStats.blockedWrites++;
+        uart->write(txBuffer, frameLength);
+        txCount++;
     }
-    return crc;
+    xSemaphoreGive(txMutex);
 }
 
 // ============================================================================
@@ -320,63 +533,58 @@ uint16_t UARTProtocol::calculateCRC16(const uint8_t* data, uint16_t length, uint
 void UARTProtocol::handleSetThreshold(const SetThresholdCmd& cmd) {
     PadConfigManager::setThreshold(cmd.padId, cmd.threshold);
     sendAck(CMD_SET_THRESHOLD);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] Threshold updated: Pad %d = %d\n", cmd.padId, cmd.threshold);
+    LOG_EVENT(UART_THRESHOLD, cmd.padId, cmd.threshold);
 }
 
 void UARTProtocol::handleSetVelocityRange(const SetVelocityRangeCmd& cmd) {
     PadConfigManager::setVelocityRange(cmd.padId, cmd.velocityMin, cmd.velocityMax);
     sendAck(CMD_SET_VELOCITY_RANGE);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] Velocity range updated: Pad %d = [%d-%d]\n",
-                  cmd.padId, cmd.velocityMin, cmd.velocityMax);
+    LOG_EVENT(UART_VELOCITY_RANGE, cmd.padId, cmd.velocityMin, cmd.velocityMax);
 }
 
 void UARTProtocol::handleSetVelocityCurve(const SetVelocityCurveCmd& cmd) {
     PadConfigManager::setVelocityCurve(cmd.padId, cmd.curve);
     sendAck(CMD_SET_VELOCITY_CURVE);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] Velocity curve updated: Pad %d = %.2f\n", cmd.padId, cmd.curve);
+    LOG_EVENT(UART_VELOCITY_CURVE, cmd.padId, lroundf(cmd.curve * 100.0f));
 }
 
 void UARTProtocol::handleSetMidiNote(const SetMidiNoteCmd& cmd) {
     PadConfigManager::setMidiNote(cmd.padId, cmd.midiNote);
     sendAck(CMD_SET_MIDI_NOTE);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] MIDI note updated: Pad %d = %d\n", cmd.padId, cmd.midiNote);
+    LOG_EVENT(UART_MIDI_NOTE, cmd.padId, cmd.midiNote);
 }
 
 void UARTProtocol::handleSetSample(const SetSampleCmd& cmd) {
     PadConfigManager::setSample(cmd.padId, cmd.sampleName);
     sendAck(CMD_SET_SAMPLE);
-    sendConfigUpdate(cmd.padId);
     Serial.printf("[UART] Sample updated: Pad %d = %s\n", cmd.padId, cmd.sampleName);
 }
 
 void UARTProtocol::handleSetLEDColor(const SetLEDColorCmd& cmd) {
     PadConfigManager::setLEDColor(cmd.padId, cmd.colorHit, cmd.colorIdle);
     sendAck(CMD_SET_LED_COLOR);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] LED colors updated: Pad %d\n", cmd.padId);
+    LOG_EVENT(UART_LED_COLORS, cmd.padId);
 }
 
 void UARTProtocol::handleSetCrosstalk(const SetCrosstalkCmd& cmd) {
     PadConfigManager::setCrosstalk(cmd.padId, cmd.enabled, cmd.window, cmd.ratio);
     sendAck(CMD_SET_CROSSTALK);
-    sendConfigUpdate(cmd.padId);
-    Serial.printf("[UART] Crosstalk updated: Pad %d\n", cmd.padId);
+    LOG_EVENT(UART_CROSSTALK, cmd.padId);
 }
 
 void UARTProtocol::handleSetFullConfig(const char* json) {
     if (PadConfigManager::importJSON(json)) {
         sendAck(CMD_SET_FULL_CONFIG);
-        sendConfigDump();
     } else {
         sendNack(CMD_SET_FULL_CONFIG, "Invalid JSON");
     }
 }
 
 void UARTProtocol::handleGetConfig() {
+    sendConfigSnapshot();
+}
+
+void UARTProtocol::handleExportConfig() {
     sendConfigDump();
 }
 
@@ -391,7 +599,6 @@ void UARTProtocol::handleSaveConfig() {
 void UARTProtocol::handleLoadConfig() {
     if (PadConfigManager::loadFromNVS()) {
         sendAck(CMD_LOAD_CONFIG);
-        sendConfigDump();
     } else {
         sendNack(CMD_LOAD_CONFIG, "NVS read failed");
     }
@@ -404,5 +611,4 @@ void UARTProtocol::handleResetConfig(uint8_t padId) {
         PadConfigManager::resetToDefaults(padId);
     }
     sendAck(CMD_RESET_CONFIG);
-    sendConfigDump();
 }
@@ -14,12 +14,46 @@ public:
     static void begin(HardwareSerial& serial, uint32_t baudrate = 921600,
                       int8_t rxPin = -1, int8_t txPin = -1);
 
-    // Send messages to GUI
-    static void sendHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp, uint16_t peakValue);
-    static void sendPadState(uint8_t padId, uint8_t state, uint16_t signal, uint16_t baseline, uint16_t peak);
-    static void sendSystemStatus();
-    static void sendConfigUpdate(uint8_t padId);
-    static void sendConfigDump();
+    // Telemetry (loop() only). Nothing is written here: flushTelemetry()
+    // packs everything queued during one UART_TX_TICK_US into a single
+    // MSG_TELEMETRY_BATCH frame and never writes more than the driver's TX
+    // buffer can take, so loop() does not block on the link. Hits are never
+    // rate limited and go first; pad states, meters, tempo and status keep
+    // only their latest value and wait while the TX buffer is low.
+    static void queueHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp, uint16_t peakValue);
+    static void queuePadState(uint8_t padId, uint8_t state, uint16_t signal, uint16_t baseline, uint16_t peak);
+    static void queueSystemStatus();
+    static void queueMixerMeters(const MixerMetersMsg& msg);
+    static void queueTempo(const TempoMsg& msg);
+    // Display state too big to batch (menu state, sample list, load
+    // progress): latest value wins, and flushTelemetry() writes it as its
+    // own frame once the TX buffer can take the whole frame
+    static void queueMenuState(const MenuStateMsg& msg);
+    static void queueSampleList(const SampleListMsg& msg);
+    static void queueLoadProgress(const LoadProgressMsg& msg);
+    static void flushTelemetry();
+
+    struct TxStats {
+        uint32_t batches;         // MSG_TELEMETRY_BATCH frames written
+        uint32_t hitsSent;
+        uint32_t hitsDropped;     // Hit queue overflowed (link stalled for QUEUE_SIZE_UART_TX hits)
+        uint32_t superseded;      // Non-essential updates replaced before they went out
+        uint32_t deferredTicks;   // Ticks with pending data but no room in the TX buffer
+        uint32_t lowWaterTicks;   // Ticks that held back non-essential telemetry
+        uint32_t blockedWrites;   // Immediate sends that had to wait for TX buffer room
+        uint16_t maxBatchBytes;
+    };
+    static TxStats getTxStats();
+    static void printTxStats();
+
+    // Send messages to GUI (written immediately). Replies to GUI commands:
+    // if the TX buffer is short the write waits for room, and the wait is
+    // counted in TxStats::blockedWrites.
+    // Config mirror (config_sync.h): every pad, for CMD_GET_CONFIG. Edits
+    // need no call here: flushTelemetry() sends whatever
+    // PadConfigManager::markChanged() recorded as a delta or a snapshot.
+    static void sendConfigSnapshot();
+    static void sendConfigDump();  // JSON backup (CMD_EXPORT_CONFIG)
     static void sendCalibrationData(uint8_t padId, uint16_t baseline, uint16_t noise, uint16_t suggested);
     static void sendAck(uint8_t cmdType);
     static void sendNack(uint8_t cmdType, const char* error);
@@ -27,17 +61,15 @@ public:
     // Send raw command for menu display
     static void sendRawCommand(uint8_t cmdType, const uint8_t* data, uint16_t length);
 
-    // Send menu state to display
-    static void sendMenuState(const MenuStateMsg& msg);
-    static void sendSampleList(const SampleListMsg& msg);
-
-    // Process incoming messages from GUI
+    // Process incoming messages from GUI. Never waits: parses what the UART
+    // already holds (at most UART_RX_BUDGET bytes) and keeps partial frames
+    // for the next call.
     static void processIncoming();
 
     // Statistics
     static uint32_t getTxCount() { return txCount; }
     static uint32_t getRxCount() { return rxCount; }
-    static uint32_t getErrorCount() { return errorCount; }
+    static uint32_t getErrorCount();  // Unknown commands + CRC/length/timeout errors
 
 private:
     static HardwareSerial* uart;
@@ -47,8 +79,15 @@ private:
 
     // Low-level protocol
     static void sendMessage(uint8_t msgType, const void* payload, uint16_t length);
-    static bool receiveMessage(uint8_t& msgType, uint8_t* payload, uint16_t& length);
-    static uint16_t calculateCRC16(const uint8_t* data, uint16_t length, uint16_t crc = 0xFFFF);
+    static void syncConfig();
+    static void flushFrameSlots();
+    static void handleMessage(uint8_t msgType, const uint8_t* payload, uint16_t length);
+
+    // Fixed-size messages: type id and size come from GUI_MESSAGE_TABLE
+    template <typename Msg>
+    static void sendTyped(const Msg& msg) {
+        sendMessage(MessageTraits<Msg>::TYPE, &msg, MessageTraits<Msg>::SIZE);
+    }
 
     // Command handlers
     static void handleSetThreshold(const SetThresholdCmd& cmd);
@@ -60,6 +99,7 @@ private:
     static void handleSetCrosstalk(const SetCrosstalkCmd& cmd);
     static void handleSetFullConfig(const char* json);
     static void handleGetConfig();
+    static void handleExportConfig();
     static void handleSaveConfig();
     static void handleLoadConfig();
     static void handleResetConfig(uint8_t padId);
@@ -224,8 +224,9 @@ void finishCalibration() {
         Serial.println("\n✗ Failed to save to NVS");
     }
 
-    // Send to GUI
-    UARTProtocol::sendConfigUpdate(currentPad);
+    // Send to GUI (next UART tick)
+    PadConfigManager::markChanged(currentPad, configFieldBit(CFG_THRESHOLD) | configFieldBit(CFG_VELOCITY_MIN) |
+                                                  configFieldBit(CFG_VELOCITY_MAX));
 
     // Cleanup
     isCalibrating = false;
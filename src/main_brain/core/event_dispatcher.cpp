@@ -1,156 +1,213 @@
 #include "event_dispatcher.h"
 #include "pad_config.h"
-#include <edrum_config.h>
 #include "../output/audio_engine.h"
-#include "../communication/uart_protocol.h"
-#include "../ui/neopixel_controller.h"
-#include "../ui/sk9822_controller.h"
 #include "../output/midi_controller.h"
-#include <algorithm>
 #include <cstring>
 
 // Static members
-QueueHandle_t EventDispatcher::hitQueue = nullptr;
-QueueHandle_t EventDispatcher::ledQueue = nullptr;
-QueueHandle_t EventDispatcher::audioQueue = nullptr;
-QueueHandle_t EventDispatcher::midiQueue = nullptr;
+EventDispatcher::Subscriber EventDispatcher::subscribers[BUS_MAX_SUBSCRIBERS];
+uint8_t EventDispatcher::fanout[BUS_MAX_SUBSCRIBERS];
+uint8_t EventDispatcher::numSubscribers = 0;
 
-TaskHandle_t EventDispatcher::ledTaskHandle = nullptr;
-TaskHandle_t EventDispatcher::audioTaskHandle = nullptr;
-TaskHandle_t EventDispatcher::midiTaskHandle = nullptr;
-
-volatile uint32_t EventDispatcher::processedCount = 0;
-volatile uint32_t EventDispatcher::droppedCount = 0;
+std::atomic<uint32_t> EventDispatcher::processedCount{0};
+std::atomic<uint32_t> EventDispatcher::droppedCount{0};
 
 // ============================================================================
-// INITIALIZATION
+// BUILT-IN SUBSCRIBERS
 // ============================================================================
 
-void EventDispatcher::begin() {
-    // Create queues (non-blocking)
-    hitQueue = xQueueCreate(32, sizeof(HitEvent));      // 32 hit buffer
-    ledQueue = xQueueCreate(16, sizeof(LEDRequest));    // 16 LED commands
-    audioQueue = xQueueCreate(16, sizeof(AudioRequest)); // Increased audio buffer
-    midiQueue = xQueueCreate(32, sizeof(MIDIRequest));  // 32 MIDI buffer
+// Audio task: hit -> pad zone sample -> voice. Highest subscriber priority,
+// so the voice starts before any other subscriber runs.
+static void onAudioEvent(const BusEvent& event) {
+    if (event.type == BUS_EVENT_PLAY_SAMPLE) {
+        AudioEngine::play(event.sampleName, event.velocity, 127, 0, event.padId, event.velocityHiRes);
+        return;
+    }
 
-    // Initialize subsystems (if not already init in main)
-    // Note: AudioEngine and MIDIController should be init in main.cpp for explicit ordering
-    
-    // Create worker tasks on Core 1 (application core)
-    xTaskCreatePinnedToCore(
-        ledTask,
-        "LED_Task",
-        2048,           // Stack size
-        nullptr,
-        5,              // Priority (Low)
-        &ledTaskHandle,
-        1               // Core 1
-    );
-
-    xTaskCreatePinnedToCore(
-        audioTask,
-        "Audio_Task",
-        2048,           // Reduced stack as heavy lifting is in AudioEngine
-        nullptr,
-        15,             // Priority (High - audio dispatch must be fast)
-        &audioTaskHandle,
-        1
-    );
-
-    xTaskCreatePinnedToCore(
-        midiTask,
-        "MIDI_Task",
-        2048,
-        nullptr,
-        5,
-        &midiTaskHandle,
-        1
-    );
-
-    Serial.println("[DISPATCHER] Event dispatcher initialized");
+    if (event.padId >= NUM_PADS) return;
+    bool rim = event.zone != 0;
+    const PadConfig& cfg = PadConfigManager::getConfig(event.padId);
+    // Máscara de choke resuelta al cambiar la configuración del pad
+    AudioEngine::play(rim ? cfg.rimSampleName : cfg.sampleName, event.velocity, 127,
+                      PadConfigManager::getChokeMask(event.padId, rim), event.padId, event.velocityHiRes);
+}
+
+// MIDI task: the handler posts into MIDIController's ring and the service
+// hook drains it in the same task, so the ring keeps a single producer
+static void onMidiEvent(const BusEvent& event) {
+    if (event.type != BUS_EVENT_HIT || event.padId >= NUM_PADS) return;
+
+    const PadConfig& cfg = PadConfigManager::getConfig(event.padId);
+    uint8_t note = event.zone != 0 ? cfg.rimMidiNote : cfg.midiNote;
+    // Con alta resolución activa sale con el prefijo CC88
+    if (event.velocityHiRes) {
+        MIDIController::sendNoteOnHiRes(note, event.velocityHiRes);
+    } else {
+        MIDIController::sendNoteOn(note, event.velocity);
+    }
+}
+
+// Runs in the MIDI task: note -> pad zone -> voice, without a trip through loop()
+static bool playMidiNote(uint8_t channel, uint8_t note, uint8_t velocity, uint16_t velocityHiRes) {
+    (void)channel;
+    uint8_t padId;
+    bool rim;
+    if (!PadConfigManager::padForNote(note, padId, rim)) return false;
+
+    const PadConfig& cfg = PadConfigManager::getConfig(padId);
+    return AudioEngine::play(rim ? cfg.rimSampleName : cfg.sampleName, velocity, 127,
+                             PadConfigManager::getChokeMask(padId, rim), padId, velocityHiRes);
 }
 
 // ============================================================================
-// MAIN EVENT PROCESSOR (Called from main loop)
+// INITIALIZATION
 // ============================================================================
 
-void EventDispatcher::processEvents() {
-    // Legacy function - kept for compatibility but main logic moved to tasks
-    // Or used if you want to poll from loop() instead of tasks
+void EventDispatcher::begin() {
+    // Note: AudioEngine and MIDIController should be init in main.cpp for explicit ordering
+    subscribe("audio", onAudioEvent, TASK_PRIORITY_AUDIO_TRIGGER, BUS_DROP_NEWEST,
+              TASK_STACK_AUDIO_TRIGGER);
+
+    // The MIDI subscriber task is the MIDI output task: every bus event,
+    // ring post and USB receive wakes it, and service() tells it how long
+    // it may sleep until the next note-off tick
+    int8_t midi = subscribe("midi", onMidiEvent, TASK_PRIORITY_MIDI_OUTPUT, BUS_DROP_NEWEST,
+                            TASK_STACK_MIDI_OUTPUT, MIDIController::service);
+    if (midi >= 0) {
+        MIDIController::attachTask(subscribers[midi].task);
+    }
+
+    MIDIController::setNoteInputHandler(playMidiNote);
+
+    Serial.println("[DISPATCHER] Event bus initialized");
 }
 
 // ============================================================================
-// MANUAL DISPATCH
+// SUBSCRIPTION
 // ============================================================================
 
-void EventDispatcher::dispatchLED(const LEDRequest& request) {
-    xQueueSend(ledQueue, &request, 0);
-}
+int8_t EventDispatcher::subscribe(const char* name, BusHandler handler, uint8_t priority,
+                                  BusDropPolicy policy, uint32_t stackSize, BusServiceHook service) {
+    if (!handler || numSubscribers >= BUS_MAX_SUBSCRIBERS) {
+        Serial.printf("[DISPATCHER] Cannot subscribe '%s'\n", name ? name : "?");
+        return -1;
+    }
 
-void EventDispatcher::dispatchAudio(const AudioRequest& request) {
-    xQueueSend(audioQueue, &request, 0);
-}
+    uint8_t id = numSubscribers;
+    Subscriber& sub = subscribers[id];
+    sub.stats = {};
+    sub.stats.name = name;
+    sub.stats.priority = priority;
+    sub.stats.policy = policy;
+    sub.handler = handler;
+    sub.service = service;
+    sub.task = nullptr;
+
+    // Insert into the fan-out order, stable for equal priorities
+    uint8_t pos = id;
+    while (pos > 0 && subscribers[fanout[pos - 1]].stats.priority < priority) {
+        fanout[pos] = fanout[pos - 1];
+        pos--;
+    }
+    fanout[pos] = id;
+
+    if (priority != BUS_PRIORITY_LOOP) {
+        xTaskCreatePinnedToCore(
+            subscriberTask,
+            name,
+            stackSize,
+            &sub,
+            priority,
+            &sub.task,
+            1               // Core 1
+        );
+    }
 
-void EventDispatcher::dispatchMIDI(const MIDIRequest& request) {
-    xQueueSend(midiQueue, &request, 0);
+    // Published last: publish() only walks subscribers that are fully set up
+    numSubscribers++;
+    return id;
 }
 
 // ============================================================================
-// PROCESS AUDIO IN MAIN LOOP
+// PUBLISH (Called from main loop)
 // ============================================================================
 
-// Helper to drain the queue in the main loop if tasks are not used for this
-void EventDispatcher::processAudio() {
-    AudioRequest req;
-    while (xQueueReceive(audioQueue, &req, 0) == pdTRUE) {
-        
-        // Determinar Choke Group
-        // TODO: Mover esta lógica a PadConfigManager
-        uint8_t chokeGroup = 0;
-        
-        // HiHat logic (simple hardcoded logic for now)
-        // If "closed hihat" or "pedal", choke group 1
-        if (strstr(req.sampleName, "hihat") != nullptr) {
-            chokeGroup = 1;
+bool EventDispatcher::publish(BusEvent& event) {
+    event.publishedUs = micros();
+    processedCount.fetch_add(1, std::memory_order_relaxed);
+
+    bool allDelivered = true;
+    for (uint8_t i = 0; i < numSubscribers; i++) {
+        Subscriber& sub = subscribers[fanout[i]];
+
+        bool kept = sub.stats.policy == BUS_DROP_OLDEST ? sub.inbox.pushOverwrite(event)
+                                                        : sub.inbox.push(event);
+        if (!kept) {
+            sub.stats.dropped++;
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            allDelivered = false;
         }
 
-        AudioEngine::play(req.sampleName, req.velocity, req.volume, chokeGroup);
+        uint16_t depth = sub.inbox.size();
+        if (depth > sub.stats.maxDepth) sub.stats.maxDepth = depth;
+
+        if (sub.task) xTaskNotifyGive(sub.task);
+    }
+    return allDelivered;
+}
+
+void EventDispatcher::pollLoopSubscribers() {
+    for (uint8_t i = 0; i < numSubscribers; i++) {
+        Subscriber& sub = subscribers[fanout[i]];
+        if (!sub.task) drain(sub);
     }
 }
 
 // ============================================================================
-// WORKER TASKS
+// CONSUMERS
 // ============================================================================
 
-void EventDispatcher::ledTask(void* parameter) {
-    LEDRequest request;
-    while (true) {
-        if (xQueueReceive(ledQueue, &request, pdMS_TO_TICKS(100)) == pdTRUE) {
-            NeoPixelController::flashPad(request.padId, request.color, request.brightness, request.fadeDuration);
-        }
-        vTaskDelay(1);
+void EventDispatcher::drain(Subscriber& sub) {
+    BusEvent event;
+    while (sub.inbox.pop(event)) {
+        sub.handler(event);
+
+        uint32_t latency = micros() - event.publishedUs;
+        sub.stats.delivered++;
+        sub.stats.totalLatencyUs += latency;
+        if (latency > sub.stats.maxLatencyUs) sub.stats.maxLatencyUs = latency;
     }
 }
 
-void EventDispatcher::audioTask(void* parameter) {
-    // Not strictly needed if processAudio() is called in loop, 
-    // but useful if we want to decouple completely.
-    // For now, let's just yield as we are using processAudio() in loop() for lower latency jitter.
+void EventDispatcher::subscriberTask(void* parameter) {
+    Subscriber& sub = *static_cast<Subscriber*>(parameter);
     while (true) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        drain(sub);
+        // Woken by every publish; otherwise sleeps until the hook's next tick
+        uint32_t waitMs = sub.service ? sub.service() : 1000;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
     }
 }
 
-void EventDispatcher::midiTask(void* parameter) {
-    MIDIRequest request;
-    while (true) {
-        if (xQueueReceive(midiQueue, &request, pdMS_TO_TICKS(100)) == pdTRUE) {
-            if (request.noteOn) {
-                MIDIController::sendNoteOn(request.note, request.velocity);
-            } else {
-                MIDIController::sendNoteOff(request.note);
-            }
-        }
-        vTaskDelay(1);
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+BusSubscriberStats EventDispatcher::getSubscriberStats(uint8_t id) {
+    if (id >= numSubscribers) return BusSubscriberStats{};
+    return subscribers[id].stats;
+}
+
+void EventDispatcher::printStats() {
+    Serial.printf("[BUS] %lu events published, %lu inbox drops\n",
+                  (unsigned long)getProcessedCount(), (unsigned long)getDroppedCount());
+    for (uint8_t i = 0; i < numSubscribers; i++) {
+        const BusSubscriberStats& s = subscribers[fanout[i]].stats;
+        uint32_t meanUs = s.delivered ? (uint32_t)(s.totalLatencyUs / s.delivered) : 0;
+        Serial.printf("[BUS]   %-10s prio %2u %s: %lu delivered, %lu dropped, depth max %u, "
+                      "latency %lu us avg / %lu us max\n",
+                      s.name, s.priority, s.policy == BUS_DROP_OLDEST ? "drop-oldest" : "drop-newest",
+                      (unsigned long)s.delivered, (unsigned long)s.dropped, s.maxDepth,
+                      (unsigned long)meanUs, (unsigned long)s.maxLatencyUs);
     }
-}
\ No newline at end of file
+}
@@ -2,41 +2,67 @@
 #define EVENT_DISPATCHER_H
 
 #include <Arduino.h>
+#include <atomic>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
 #include <freertos/task.h>
+#include <edrum_config.h>
 
+#include "spsc_ring.h"
 #include "../input/hit_event.h"
 
 
 // ============================================================================
-// EVENT DISPATCHER - NON-BLOCKING ARCHITECTURE
+// EVENT DISPATCHER - TYPED PUBLISH/SUBSCRIBE BUS
 // ============================================================================
-// Routes hit events to multiple subsystems without blocking the scanner
-// Uses separate FreeRTOS tasks for each heavy operation
-
-// LED animation request
-struct LEDRequest {
-    uint8_t padId;
-    uint32_t color;
-    uint8_t brightness;
-    uint16_t fadeDuration;
+// loop() publishes one fixed-size record per hit; publish() copies it into
+// every subscriber's lock-free inbox and returns without waiting for any of
+// them. Each subscriber picks its own priority and drop policy, so a full
+// LED or UART inbox only costs that subscriber an event and never delays
+// the audio one. Single producer: publish() is only called from loop().
+
+#define AUDIO_REQUEST_NO_PAD 0xFF  // Not triggered by a pad (no choke group)
+
+enum BusEventType : uint8_t {
+    BUS_EVENT_HIT = 0,          // Pad hit that survived crosstalk and debounce
+    BUS_EVENT_PLAY_SAMPLE = 1   // Play sampleName directly (serial test commands)
+};
+
+struct BusEvent {
+    uint8_t type;            // BusEventType
+    uint8_t padId;           // Source pad, or AUDIO_REQUEST_NO_PAD
+    uint8_t velocity;        // 1-127
+    uint8_t zone;            // 0=head, 1=rim
+    uint16_t velocityHiRes;  // 16-bit velocity from the detector, 0 = use velocity
+    uint16_t peakValue;      // Raw ADC peak
+    uint32_t timestamp;      // Detector timestamp (µs)
+    uint32_t publishedUs;    // Stamped by publish(), for per-subscriber latency
+    char sampleName[32];     // BUS_EVENT_PLAY_SAMPLE only
 };
 
-// Audio playback request
-struct AudioRequest {
-    char sampleName[32];
-    uint8_t velocity;
-    uint8_t volume;
-    int8_t pitch;
+// Runs in the subscriber's own context (its task, or loop() for priority 0)
+typedef void (*BusHandler)(const BusEvent& event);
+
+// Optional periodic work for a task subscriber. Runs after every drain and
+// returns how long the task may sleep (ms) if no event wakes it first.
+typedef uint32_t (*BusServiceHook)();
+
+enum BusDropPolicy : uint8_t {
+    BUS_DROP_NEWEST = 0,  // Full inbox rejects the new event (keeps order: audio, MIDI)
+    BUS_DROP_OLDEST = 1   // Full inbox discards its oldest event (only the latest matters: LEDs, UI)
 };
 
-// MIDI output request
-struct MIDIRequest {
-    uint8_t channel;
-    uint8_t note;
-    uint8_t velocity;
-    bool noteOn;  // true=noteOn, false=noteOff
+// Drained from loop() by pollLoopSubscribers() instead of a dedicated task
+#define BUS_PRIORITY_LOOP 0
+
+struct BusSubscriberStats {
+    const char* name;
+    uint8_t priority;
+    BusDropPolicy policy;
+    uint32_t delivered;       // Events handed to the handler
+    uint32_t dropped;         // Events lost to a full inbox
+    uint16_t maxDepth;        // Highest inbox occupancy seen at publish
+    uint32_t maxLatencyUs;    // publish() → handler returned, worst case
+    uint64_t totalLatencyUs;  // Sum (mean = total / delivered)
 };
 
 // ============================================================================
@@ -45,72 +71,50 @@ struct MIDIRequest {
 
 class EventDispatcher {
 public:
-    // Initialize all subsystem tasks
+    // Register the built-in audio and MIDI subscribers and their tasks
     static void begin();
 
-    // Main event handler (call from loop)
-    static void processEvents();
+    // Register a subscriber. priority > 0 gets a task of that FreeRTOS
+    // priority on core 1, woken by every publish; BUS_PRIORITY_LOOP is
+    // drained by pollLoopSubscribers(). Fan-out goes in descending priority.
+    // Returns the subscriber id, or -1 if the table is full.
+    static int8_t subscribe(const char* name, BusHandler handler, uint8_t priority,
+                            BusDropPolicy policy, uint32_t stackSize = 4096,
+                            BusServiceHook service = nullptr);
 
-    // Manual dispatch (for testing)
-    static void dispatchLED(const LEDRequest& request);
-    static void dispatchAudio(const AudioRequest& request);
-    static void dispatchMIDI(const MIDIRequest& request);
+    // Fan one event out to every inbox (loop() only). Returns false if any
+    // subscriber dropped an event.
+    static bool publish(BusEvent& event);
 
-    // Process audio queue (call from main loop for low-latency)
-    static void processAudio();
+    // Drain the priority-0 inboxes (call from loop)
+    static void pollLoopSubscribers();
 
     // Statistics
-    static uint32_t getProcessedCount() { return processedCount; }
-    static uint32_t getDroppedCount() { return droppedCount; }
+    static uint32_t getProcessedCount() { return processedCount.load(std::memory_order_relaxed); }
+    static uint32_t getDroppedCount() { return droppedCount.load(std::memory_order_relaxed); }
+    static uint8_t subscriberCount() { return numSubscribers; }
+    static BusSubscriberStats getSubscriberStats(uint8_t id);
+    static void printStats();
 
 private:
-    // FreeRTOS queues (non-blocking)
-    static QueueHandle_t hitQueue;
-    static QueueHandle_t ledQueue;
-    static QueueHandle_t audioQueue;
-    static QueueHandle_t midiQueue;
-
-    // Task handles
-    static TaskHandle_t ledTaskHandle;
-    static TaskHandle_t audioTaskHandle;
-    static TaskHandle_t midiTaskHandle;
-
-    // Task functions (run on Core 1)
-    static void ledTask(void* parameter);
-    static void audioTask(void* parameter);
-    static void midiTask(void* parameter);
+    struct Subscriber {
+        BusSubscriberStats stats;
+        BusHandler handler;
+        BusServiceHook service;
+        TaskHandle_t task;
+        SpscRing<BusEvent, QUEUE_SIZE_BUS_INBOX> inbox;
+    };
 
-    // Statistics
-    static volatile uint32_t processedCount;
-    static volatile uint32_t droppedCount;
-};
+    static void drain(Subscriber& sub);
+    static void subscriberTask(void* parameter);
 
-// ============================================================================
-// SUBSYSTEM MODULES (to be implemented)
-// ============================================================================
+    static Subscriber subscribers[BUS_MAX_SUBSCRIBERS];
+    static uint8_t fanout[BUS_MAX_SUBSCRIBERS];  // Subscriber ids by descending priority
+    static uint8_t numSubscribers;
 
-// LED Controller
-namespace LEDController {
-    void begin();
-    void setColor(uint8_t padId, uint32_t color, uint8_t brightness);
-    void fade(uint8_t padId, uint16_t duration);
-    void update();  // Call from loop for smooth fading
-}
-
-// Audio Player
-namespace AudioPlayer {
-    void begin();
-    bool playSample(const char* filename, uint8_t velocity, uint8_t volume, int8_t pitch);
-    void stop(uint8_t padId);
-    bool isPlaying();
-}
-
-// MIDI Controller
-namespace MIDIController {
-    void begin();
-    void sendNoteOn(uint8_t channel, uint8_t note, uint8_t velocity);
-    void sendNoteOff(uint8_t channel, uint8_t note);
-    void sendCC(uint8_t channel, uint8_t cc, uint8_t value);
-}
+    // Statistics
+    static std::atomic<uint32_t> processedCount;  // Events published
+    static std::atomic<uint32_t> droppedCount;    // Inbox drops, all subscribers
+};
 
 #endif // EVENT_DISPATCHER_H
@@ -0,0 +1,168 @@
+#include "log_ring.h"
+#include <edrum_config.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+
+namespace LogRing {
+
+static_assert((QUEUE_SIZE_LOG_RECORDS & (QUEUE_SIZE_LOG_RECORDS - 1)) == 0,
+              "QUEUE_SIZE_LOG_RECORDS must be a power of two");
+
+// Bounded multi-producer queue: each cell carries a sequence number that
+// says whose turn it is. A producer claims a position with one
+// compare-exchange on enqueuePos, fills the cell and publishes it by
+// bumping the sequence; the single consumer (drain task) frees it the same
+// way. No producer ever waits for another one or for the consumer.
+struct Cell {
+    std::atomic<uint32_t> sequence;
+    LogRecord record;
+};
+
+static Cell cells[QUEUE_SIZE_LOG_RECORDS];
+static std::atomic<uint32_t> enqueuePos{0};
+static uint32_t dequeuePos = 0;  // Drain task only
+
+// Seeded at static init, so records written before begin() are kept
+static struct CellInit {
+    CellInit() {
+        for (uint32_t i = 0; i < QUEUE_SIZE_LOG_RECORDS; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+} cellInit;
+
+static std::atomic<uint32_t> written{0};
+static std::atomic<uint32_t> dropped{0};
+static uint32_t drained = 0;
+static uint16_t maxDepth = 0;
+static uint32_t droppedReported = 0;
+static volatile bool binaryMode = LOG_BINARY_DEFAULT;
+static TaskHandle_t drainTaskHandle = nullptr;
+
+static void drainTask(void* parameter);
+
+void begin() {
+    if (drainTaskHandle) return;
+
+    xTaskCreatePinnedToCore(
+        drainTask,
+        "LogDrain",
+        TASK_STACK_LOG_DRAIN,
+        nullptr,
+        TASK_PRIORITY_LOG_DRAIN,
+        &drainTaskHandle,
+        TASK_CORE_LOG_DRAIN
+    );
+}
+
+// ============================================================================
+// PRODUCERS
+// ============================================================================
+
+void write(uint32_t formatId, uint8_t argc, const uint32_t* args) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & (QUEUE_SIZE_LOG_RECORDS - 1)];
+        int32_t diff = static_cast<int32_t>(cell->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);  // Full: the drain task is behind
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord& rec = cell->record;
+    rec.timestampUs = static_cast<uint32_t>(micros());
+    rec.formatId = formatId;
+    rec.argc = argc > LOG_MAX_ARGS ? LOG_MAX_ARGS : argc;
+    for (uint8_t i = 0; i < LOG_MAX_ARGS; i++) rec.args[i] = i < rec.argc ? args[i] : 0;
+
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    written.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// DRAIN TASK
+// ============================================================================
+
+static bool pop(LogRecord& rec) {
+    Cell& cell = cells[dequeuePos & (QUEUE_SIZE_LOG_RECORDS - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) return false;
+    rec = cell.record;
+    cell.sequence.store(dequeuePos + QUEUE_SIZE_LOG_RECORDS, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+static void emit(const LogRecord& rec) {
+    if (binaryMode) {
+        uint8_t frame[LOG_FRAME_MAX];
+        Serial.write(frame, logEncodeFrame(rec, frame));
+    } else {
+        char line[160];
+        if (logFormatRecord(rec, line, sizeof(line)) > 0) Serial.println(line);
+    }
+}
+
+static void drainTask(void* parameter) {
+    (void)parameter;
+    LogRecord rec;
+    while (true) {
+        uint16_t depth = enqueuePos.load(std::memory_order_relaxed) - dequeuePos;
+        if (depth > maxDepth) maxDepth = depth;
+
+        while (pop(rec)) {
+            emit(rec);
+            drained++;
+        }
+
+        // Losses are reported in-band, once per drain pass
+        uint32_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost != droppedReported) {
+            LogRecord note = {};
+            note.timestampUs = static_cast<uint32_t>(micros());
+            note.formatId = LogFmt::LOG_DROPPED;
+            note.argc = 1;
+            note.args[0] = lost - droppedReported;
+            droppedReported = lost;
+            emit(note);
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
+
+// ============================================================================
+// CONFIGURATION / STATISTICS
+// ============================================================================
+
+void setBinary(bool enabled) {
+    binaryMode = enabled;
+}
+
+bool binary() {
+    return binaryMode;
+}
+
+Stats getStats() {
+    Stats s;
+    s.written = written.load(std::memory_order_relaxed);
+    s.dropped = dropped.load(std::memory_order_relaxed);
+    s.drained = drained;
+    s.maxDepth = maxDepth;
+    return s;
+}
+
+void printStats() {
+    Stats s = getStats();
+    Serial.printf("[LOG] %lu records, %lu dropped, max depth %u/%u, %s output\n",
+                  (unsigned long)s.written, (unsigned long)s.dropped, s.maxDepth,
+                  (unsigned)QUEUE_SIZE_LOG_RECORDS, binaryMode ? "binary" : "text");
+}
+
+}  // namespace LogRing
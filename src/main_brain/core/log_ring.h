@@ -0,0 +1,50 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <Arduino.h>
+#include <log_protocol.h>
+
+// ============================================================================
+// LOG RING - DEFERRED LOGGING FOR HOT PATHS
+// ============================================================================
+// LOG_EVENT(NAME, args...) stores a LogRecord (format id from
+// log_protocol.h, timestamp, up to 4 integer args) in a lock-free
+// multi-producer ring and returns: no formatting, no Serial, no task
+// switch. It is safe from loop(), FreeRTOS tasks and the esp_timer scanner
+// at the same time. A low-priority drain task prints the records as text,
+// or as binary frames for tools/log_decode, so a full UART TX buffer only
+// ever stalls that task. A full ring drops the new record and counts it.
+
+namespace LogRing {
+
+struct Stats {
+    uint32_t written;    // Records accepted
+    uint32_t dropped;    // Records lost to a full ring
+    uint32_t drained;    // Records printed or shipped
+    uint16_t maxDepth;   // Highest occupancy seen by the drain task
+};
+
+void begin();
+
+// Producer side (any context)
+void write(uint32_t formatId, uint8_t argc, const uint32_t* args);
+
+template <typename... Args>
+inline void log(uint32_t formatId, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    const uint32_t values[LOG_MAX_ARGS + 1] = {static_cast<uint32_t>(args)...};
+    write(formatId, sizeof...(Args), values);
+}
+
+// Binary frames instead of text on Serial (decode with tools/log_decode)
+void setBinary(bool enabled);
+bool binary();
+
+Stats getStats();
+void printStats();
+
+}  // namespace LogRing
+
+#define LOG_EVENT(name, ...) LogRing::log(LogFmt::name, ##__VA_ARGS__)
+
+#endif // LOG_RING_H
@@ -0,0 +1,86 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// ============================================================================
+// SPSC RING - LOCK-FREE SINGLE PRODUCER / SINGLE CONSUMER QUEUE
+// ============================================================================
+// Fixed-capacity ring for handing events from one task to another without
+// a mutex or a FreeRTOS queue copy. Exactly one task may call push() or
+// pushOverwrite() and exactly one (possibly different) task may call pop();
+// the indices are published with release/acquire ordering so the consumer
+// never sees a slot before its contents. Capacity must be a power of two;
+// one slot is never used to tell full from empty.
+//
+// pushOverwrite() lets the producer discard the oldest item instead of the
+// new one. Both sides then advance tail with compare-exchange: a consumer
+// that copied a slot the producer recycled meanwhile loses the exchange and
+// retries, so T must be trivially copyable.
+
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops the item) when full.
+    bool push(const T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t next = (head + 1) & (Capacity - 1);
+        if (next == tail_.load(std::memory_order_acquire)) return false;
+        items_[head] = item;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side. Always stores the item; returns false if the oldest
+    // one had to be dropped to make room.
+    bool pushOverwrite(const T& item) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t next = (head + 1) & (Capacity - 1);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        bool kept = true;
+        while (next == tail) {
+            if (tail_.compare_exchange_weak(tail, (tail + 1) & (Capacity - 1),
+                                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                kept = false;
+                break;
+            }
+        }
+        items_[head] = item;
+        head_.store(next, std::memory_order_release);
+        return kept;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        while (tail != head_.load(std::memory_order_acquire)) {
+            item = items_[tail];
+            if (tail_.compare_exchange_weak(tail, (tail + 1) & (Capacity - 1),
+                                            std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Approximate when called from a third task
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return (head - tail) & (Capacity - 1);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity - 1; }
+
+private:
+    T items_[Capacity];
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+};
+
+#endif // SPSC_RING_H
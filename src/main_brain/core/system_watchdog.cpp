@@ -1,6 +1,10 @@
 #include "system_watchdog.h"
 #include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_freertos_hooks.h>
+#include <algorithm>
 #include "pad_config.h"
+#include "../output/sample_arena.h"
 
 namespace SystemWatchdog {
 
@@ -15,6 +19,27 @@ static const uint32_t WARNING_COOLDOWN_MS = 5000;  // Don't spam warnings
 static uint32_t totalWarnings = 0;
 static uint32_t totalRecoveries = 0;
 
+// CPU idle measurement: the idle hooks are called back to back while a core has
+// nothing to run, so a short gap between two calls is idle time and a long gap
+// means a task ran in between. The hooks return false to keep the idle task
+// spinning (no WFI) so the gaps stay short; that burns both cores, so the
+// hooks are only registered while measuring (setCpuMeasurement).
+static const uint32_t CPU_IDLE_GAP_US = 50;
+static bool cpuMeasureEnabled = false;
+static volatile uint32_t idleUs[2] = {0, 0};
+static uint32_t lastIdleCallUs[2] = {0, 0};
+static uint32_t idleWindowStartUs = 0;
+
+static inline void accountIdle(int core) {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t gap = now - lastIdleCallUs[core];
+    if (gap < CPU_IDLE_GAP_US) idleUs[core] = idleUs[core] + gap;
+    lastIdleCallUs[core] = now;
+}
+
+static bool idleHookCore0() { accountIdle(0); return false; }
+static bool idleHookCore1() { accountIdle(1); return false; }
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -25,12 +50,15 @@ void begin(const WatchdogConfig& cfg) {
     // Initialize ESP32 task watchdog
     esp_task_wdt_init(30, true);  // 30s timeout, panic on timeout
 
+    setCpuMeasurement(CPU_LOAD_MEASURE_DEFAULT);
+
     Serial.println("[WATCHDOG] System watchdog initialized");
     Serial.printf("  Scanner timeout:   %u µs\n", config.scannerTimeoutUs);
     Serial.printf("  Heap warning:      %u bytes\n", config.heapWarningBytes);
     Serial.printf("  PSRAM warning:     %u bytes\n", config.psramWarningBytes);
     Serial.printf("  Temp warning:      %d °C\n", config.tempWarningCelsius);
     Serial.printf("  Temp critical:     %d °C\n", config.tempCriticalCelsius);
+    Serial.printf("  Arena frag warning: %u %%\n", config.arenaFragWarningPct);
 }
 
 // ============================================================================
@@ -49,6 +77,28 @@ void update() {
     health.uptimeSeconds = now / 1000;
     health.isHealthy = true;
 
+    uint32_t previousFailedAllocs = health.arenaFailedAllocs;
+    SampleArena::Stats arena = SampleArena::getStats();
+    health.arenaUsed = arena.usedBytes;
+    health.arenaFree = arena.freeBytes;
+    health.arenaLargestBlock = arena.largestFreeBlock;
+    health.arenaFragmentationPct = arena.fragmentationPct;
+    health.arenaFailedAllocs = arena.failedAllocs;
+
+    // CPU idle over the last window (the reset may lose a few µs counted
+    // concurrently on core 0; irrelevant at 1 s windows)
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint32_t windowUs = nowUs - idleWindowStartUs;
+    idleWindowStartUs = nowUs;
+    health.cpuMeasured = cpuMeasureEnabled;
+    for (int core = 0; core < 2; core++) {
+        uint32_t idle = idleUs[core];
+        idleUs[core] = 0;
+        health.cpuIdlePct[core] = (cpuMeasureEnabled && windowUs)
+                                      ? (uint8_t)std::min<uint64_t>(100, (uint64_t)idle * 100 / windowUs)
+                                      : 0;
+    }
+
     // Check heap
     if (health.freeHeap < config.heapWarningBytes) {
         if (now - lastWarningTime > WARNING_COOLDOWN_MS) {
@@ -69,6 +119,19 @@ void update() {
         health.isHealthy = false;
     }
 
+    // Check sample arena: fragmentation limits the largest sample/kit that fits
+    if (health.arenaFragmentationPct > config.arenaFragWarningPct ||
+        health.arenaFailedAllocs != previousFailedAllocs) {
+        if (now - lastWarningTime > WARNING_COOLDOWN_MS) {
+            Serial.printf("[WATCHDOG] ⚠️  SAMPLE ARENA: %u%% fragmented, largest block %u KB, %u failed allocs\n",
+                          health.arenaFragmentationPct, health.arenaLargestBlock / 1024,
+                          health.arenaFailedAllocs);
+            lastWarningTime = now;
+            totalWarnings++;
+        }
+        health.isHealthy = false;
+    }
+
     // Check temperature
     if (health.temperatureCelsius > config.tempCriticalCelsius) {
         triggerRecovery("CRITICAL TEMPERATURE");
@@ -96,6 +159,29 @@ void update() {
     esp_task_wdt_reset();
 }
 
+// ============================================================================
+// CPU MEASUREMENT
+// ============================================================================
+
+void setCpuMeasurement(bool enabled) {
+    if (enabled == cpuMeasureEnabled) return;
+    if (enabled) {
+        idleUs[0] = 0;
+        idleUs[1] = 0;
+        idleWindowStartUs = (uint32_t)esp_timer_get_time();
+        esp_register_freertos_idle_hook_for_cpu(idleHookCore0, 0);
+        esp_register_freertos_idle_hook_for_cpu(idleHookCore1, 1);
+    } else {
+        esp_deregister_freertos_idle_hook_for_cpu(idleHookCore0, 0);
+        esp_deregister_freertos_idle_hook_for_cpu(idleHookCore1, 1);
+    }
+    cpuMeasureEnabled = enabled;
+}
+
+bool cpuMeasurement() {
+    return cpuMeasureEnabled;
+}
+
 // ============================================================================
 // SCANNER MONITORING
 // ============================================================================
@@ -129,6 +215,18 @@ void printHealth() {
     Serial.printf("║ Free PSRAM:    %6u KB             ║\n", health.freePSRAM / 1024);
     Serial.printf("║ Temperature:   %4d °C              ║\n", health.temperatureCelsius);
     Serial.printf("║ Uptime:        %6u s              ║\n", health.uptimeSeconds);
+    if (health.cpuMeasured) {
+        Serial.printf("║ Idle core 0:   %6u %%              ║\n", health.cpuIdlePct[0]);
+        Serial.printf("║ Idle core 1:   %6u %%              ║\n", health.cpuIdlePct[1]);
+    } else {
+        Serial.println("║ CPU idle:      off ('u' to measure)    ║");
+    }
+    Serial.println("╟────────────────────────────────────────╢");
+    Serial.printf("║ Arena used:    %6u KB             ║\n", health.arenaUsed / 1024);
+    Serial.printf("║ Arena free:    %6u KB             ║\n", health.arenaFree / 1024);
+    Serial.printf("║ Largest block: %6u KB             ║\n", health.arenaLargestBlock / 1024);
+    Serial.printf("║ Fragmentation: %6u %%              ║\n", health.arenaFragmentationPct);
+    Serial.printf("║ Failed allocs: %6u                ║\n", health.arenaFailedAllocs);
     Serial.println("╟────────────────────────────────────────╢");
     Serial.printf("║ Scanner max:   %6u µs             ║\n", health.scannerMaxTime);
     Serial.printf("║ Missed deadlines: %6u            ║\n", health.scannerMissedDeadlines);
@@ -19,6 +19,7 @@ struct WatchdogConfig {
     uint32_t psramWarningBytes;      // Warn if free PSRAM below this
     int16_t tempWarningCelsius;      // Warn if temperature above this
     int16_t tempCriticalCelsius;     // Critical temperature (reboot)
+    uint8_t arenaFragWarningPct;     // Warn if sample arena fragmentation above this
 };
 
 // System health status
@@ -29,6 +30,13 @@ struct SystemHealth {
     uint32_t scannerMaxTime;
     uint32_t scannerMissedDeadlines;
     uint32_t uptimeSeconds;
+    uint32_t arenaUsed;              // Sample arena (PSRAM) in use
+    uint32_t arenaFree;
+    uint32_t arenaLargestBlock;      // Largest sample that still fits
+    uint8_t arenaFragmentationPct;
+    uint32_t arenaFailedAllocs;
+    uint8_t cpuIdlePct[2];           // Idle time per core over the last second
+    bool cpuMeasured;                // cpuIdlePct valid (measurement enabled)
     bool isHealthy;
 };
 
@@ -47,6 +55,10 @@ SystemHealth getHealth();
 // Print health report
 void printHealth();
 
+// Per-core idle measurement (off by default: it keeps the idle tasks out of WFI)
+void setCpuMeasurement(bool enabled);
+bool cpuMeasurement();
+
 // Manual recovery trigger
 void triggerRecovery(const char* reason);
 
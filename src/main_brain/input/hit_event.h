@@ -5,13 +5,14 @@
 
 struct HitEvent {
     uint8_t padId;
-    uint8_t velocity;
+    uint8_t velocity;        // MIDI 1-127 (= velocityHiRes >> 9)
     uint32_t timestamp;
     uint16_t peakValue;
+    uint16_t velocityHiRes;  // 16-bit velocity from the same curve (0 = unknown)
 
-    HitEvent() : padId(0), velocity(0), timestamp(0), peakValue(0) {}
-    HitEvent(uint8_t id, uint8_t vel, uint32_t time, uint16_t peak = 0)
-        : padId(id), velocity(vel), timestamp(time), peakValue(peak) {}
+    HitEvent() : padId(0), velocity(0), timestamp(0), peakValue(0), velocityHiRes(0) {}
+    HitEvent(uint8_t id, uint8_t vel, uint32_t time, uint16_t peak = 0, uint16_t velHiRes = 0)
+        : padId(id), velocity(vel), timestamp(time), peakValue(peak), velocityHiRes(velHiRes) {}
 };
 
 #endif // HIT_EVENT_H
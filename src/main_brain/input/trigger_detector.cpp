@@ -6,6 +6,7 @@
  */
 
 #include "trigger_detector.h"
+#include "../core/log_ring.h"
 #include <math.h>
 
 // Global instance
@@ -29,6 +30,10 @@ TriggerDetector::TriggerDetector() : hitEventQueue(nullptr) {
 void TriggerDetector::begin(QueueHandle_t hitQueue) {
     hitEventQueue = hitQueue;
 
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        buildVelocityLut(i);
+    }
+
     Serial.println("[TriggerDetector] Initialized");
     Serial.println("  Per-Pad Thresholds:");
     for (int i = 0; i < NUM_PADS; i++) {
@@ -111,8 +116,7 @@ void TriggerDetector::processSample(uint8_t padId, uint16_t rawValue, uint32_t t
                 pad.risingStartTime = timestamp;
 
                 #ifdef DEBUG_TRIGGER_EVENTS
-                Serial.printf("[Pad %d] Threshold crossed: signal=%d (threshold=%d, dynamic=%d)\n",
-                              padId, signal, threshold, dynamicThreshold);
+                LOG_EVENT(DETECTOR_THRESHOLD, padId, signal, threshold, dynamicThreshold);
                 #endif
             }
             break;
@@ -136,8 +140,9 @@ void TriggerDetector::processSample(uint8_t padId, uint16_t rawValue, uint32_t t
                 pad.state = STATE_DECAY;  // Enter decay/mask state
                 pad.peakTime = timestamp;
 
-                // Convert peak to MIDI velocity
-                uint8_t velocity = peakToVelocity(pad.peakValue, padId);
+                // Convert peak to velocity (16-bit; MIDI velocity = upper 7 bits)
+                uint16_t velocityHiRes = peakToVelocityHiRes(pad.peakValue, padId);
+                uint8_t velocity = velocityHiRes >> 9;
 
                 // AGGRESSIVE CROSSTALK CHECK: Multiple conditions
                 bool rejected = false;
@@ -185,18 +190,16 @@ void TriggerDetector::processSample(uint8_t padId, uint16_t rawValue, uint32_t t
 
                 if (rejected) {
                     #ifdef DEBUG_TRIGGER_EVENTS
-                    Serial.printf("[Pad %d] REJECTED (crosstalk): peak=%d, vel=%d\n",
-                                  padId, pad.peakValue, velocity);
+                    LOG_EVENT(DETECTOR_REJECTED, padId, pad.peakValue, velocity);
                     #endif
                 } else {
                     // Valid hit - send event
-                    sendHitEvent(padId, velocity, timestamp);
+                    sendHitEvent(padId, velocity, velocityHiRes, timestamp);
                     pad.lastVelocity = velocity;
                     pad.lastHitTime = timestamp;
 
                     #ifdef DEBUG_TRIGGER_EVENTS
-                    Serial.printf("[Pad %d] HIT: peak=%d, vel=%d, time=%d µs\n",
-                                  padId, pad.peakValue, velocity, elapsed);
+                    LOG_EVENT(DETECTOR_HIT, padId, pad.peakValue, velocity, elapsed);
                     #endif
                 }
             }
@@ -215,7 +218,7 @@ void TriggerDetector::processSample(uint8_t padId, uint16_t rawValue, uint32_t t
                 pad.state = STATE_IDLE;
 
                 #ifdef DEBUG_TRIGGER_EVENTS
-                Serial.printf("[Pad %d] Re-armed\n", padId);
+                LOG_EVENT(DETECTOR_REARMED, padId);
                 #endif
             }
             break;
@@ -245,32 +248,38 @@ void TriggerDetector::updateBaseline(uint8_t padId, uint16_t rawValue) {
 // VELOCITY MAPPING
 // ============================================================
 
-uint8_t TriggerDetector::peakToVelocity(uint16_t peakValue, uint8_t padId) {
+void TriggerDetector::buildVelocityLut(uint8_t padId) {
+    const uint32_t segments = 1u << VELOCITY_LUT_BITS;
+    const float span = 65535.0f - VELOCITY_HIRES_MIN;
+
+    for (uint32_t i = 0; i <= segments; i++) {
+        // Apply velocity curve
+        // Exponent < 1.0 = compression (easier to reach high velocities)
+        // Exponent > 1.0 = expansion (harder to reach high velocities)
+        // 0.5 = square root (natural drum feel)
+        float curved = powf((float)i / segments, VELOCITY_CURVE_EXPONENT);
+
+        // Lowest point keeps MIDI velocity 1: 0 is reserved for note-off
+        velocityLut[padId][i] = (uint16_t)(VELOCITY_HIRES_MIN + curved * span + 0.5f);
+    }
+}
+
+uint16_t TriggerDetector::peakToVelocityHiRes(uint16_t peakValue, uint8_t padId) const {
     // Get calibration values for this pad
     uint16_t minPeak = VELOCITY_MIN_PEAK[padId];
     uint16_t maxPeak = VELOCITY_MAX_PEAK[padId];
+    const uint16_t* lut = velocityLut[padId];
 
     // Clamp to calibrated range
-    if (peakValue < minPeak) return MIDI_VELOCITY_MIN;
-    if (peakValue > maxPeak) return MIDI_VELOCITY_MAX;
-
-    // Normalize to 0.0-1.0 range
-    float normalized = (float)(peakValue - minPeak) / (float)(maxPeak - minPeak);
-
-    // Apply velocity curve
-    // Exponent < 1.0 = compression (easier to reach high velocities)
-    // Exponent > 1.0 = expansion (harder to reach high velocities)
-    // 0.5 = square root (natural drum feel)
-    float curved = pow(normalized, VELOCITY_CURVE_EXPONENT);
-
-    // Map to MIDI velocity range (1-127)
-    // Note: 0 is reserved for note-off in MIDI
-    uint8_t velocity = (uint8_t)(curved * (MIDI_VELOCITY_MAX - MIDI_VELOCITY_MIN)) + MIDI_VELOCITY_MIN;
-
-    // Clamp to valid range
-    velocity = CLAMP(velocity, MIDI_VELOCITY_MIN, MIDI_VELOCITY_MAX);
-
-    return velocity;
+    if (peakValue <= minPeak) return lut[0];
+    if (peakValue >= maxPeak) return lut[1u << VELOCITY_LUT_BITS];
+
+    // Position in the range as LUT segment + 8-bit fraction, then interpolate.
+    // Every ADC step lands on a distinct point, so ghost notes keep their detail.
+    uint32_t pos = ((uint32_t)(peakValue - minPeak) << (VELOCITY_LUT_BITS + 8)) / (maxPeak - minPeak);
+    uint32_t i = pos >> 8;
+    uint32_t frac = pos & 0xFF;
+    return lut[i] + (((uint32_t)(lut[i + 1] - lut[i]) * frac) >> 8);
 }
 
 // ============================================================
@@ -292,9 +301,7 @@ bool TriggerDetector::isCrosstalk(uint8_t currentPad, uint32_t timestamp, uint8_
             if (velocity < (otherVelocity * TRIGGER_CROSSTALK_RATIO)) {
                 // Current hit is significantly weaker - likely crosstalk
                 #ifdef DEBUG_TRIGGER_EVENTS
-                Serial.printf("[Crosstalk] Pad %d vel=%d < Pad %d vel=%d * %.2f\n",
-                              currentPad, velocity, otherPad, otherVelocity,
-                              TRIGGER_CROSSTALK_RATIO);
+                LOG_EVENT(DETECTOR_CROSSTALK, currentPad, velocity, otherPad, otherVelocity);
                 #endif
                 return true;
             }
@@ -308,9 +315,11 @@ bool TriggerDetector::isCrosstalk(uint8_t currentPad, uint32_t timestamp, uint8_
 // EVENT SENDING
 // ============================================================
 
-void TriggerDetector::sendHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp) {
+// Runs in the scanner's esp_timer context: logging goes through the
+// deferred ring, never straight to Serial
+void TriggerDetector::sendHitEvent(uint8_t padId, uint8_t velocity, uint16_t velocityHiRes, uint32_t timestamp) {
     if (hitEventQueue == nullptr) {
-        Serial.println("[ERROR] Hit event queue not initialized!");
+        LOG_EVENT(DETECTOR_NO_QUEUE, padId);
         return;
     }
 
@@ -319,17 +328,17 @@ void TriggerDetector::sendHitEvent(uint8_t padId, uint8_t velocity, uint32_t tim
         peak = padStates[padId].peakValue;
     }
 
-    HitEvent event(padId, velocity, timestamp, peak);
+    HitEvent event(padId, velocity, timestamp, peak, velocityHiRes);
 
     // Send to queue (don't block if queue is full)
     BaseType_t result = xQueueSend(hitEventQueue, &event, 0);
 
     if (result != pdPASS) {
-        Serial.printf("[WARNING] Hit event queue full! Lost event from Pad %d\n", padId);
+        LOG_EVENT(DETECTOR_QUEUE_FULL, padId, velocity);
     }
 
     #ifdef DEBUG_TRIGGER_EVENTS
-    Serial.printf("[HitEvent] Pad=%d, Vel=%d, Time=%lu\n", padId, velocity, timestamp);
+    LOG_EVENT(DETECTOR_HIT_EVENT, padId, velocity, timestamp);
     #endif
 }
 
@@ -11,8 +11,8 @@
  * - DECAY: Mask time to prevent retriggering
  *
  * Features:
- * - Velocity-sensitive detection (MIDI 1-127)
- * - Logarithmic velocity curve (natural feel)
+ * - Velocity-sensitive detection (MIDI 1-127 and 16-bit high resolution)
+ * - Per-pad velocity curve LUT (natural feel, no pow() on the hit path)
  * - Crosstalk rejection between adjacent pads
  * - Adaptive baseline tracking
  * - Retrigger suppression
@@ -125,6 +125,10 @@ private:
     PadState padStates[NUM_PADS];  // State for each pad
     QueueHandle_t hitEventQueue;   // Queue to send hit events
 
+    // Velocity curve per pad: 16-bit velocity at 2^VELOCITY_LUT_BITS + 1
+    // evenly spaced points of the calibrated peak range
+    uint16_t velocityLut[NUM_PADS][(1 << VELOCITY_LUT_BITS) + 1];
+
     /**
      * @brief Update baseline tracking (exponential moving average)
      * @param padId Pad ID
@@ -133,12 +137,18 @@ private:
     void updateBaseline(uint8_t padId, uint16_t rawValue);
 
     /**
-     * @brief Convert peak ADC value to MIDI velocity
+     * @brief Fill the velocity curve LUT of a pad from its calibrated range
+     * @param padId Pad ID
+     */
+    void buildVelocityLut(uint8_t padId);
+
+    /**
+     * @brief Convert peak ADC value to 16-bit velocity (LUT + linear interpolation)
      * @param peakValue Peak ADC reading
      * @param padId Pad ID (for per-pad calibration)
-     * @return MIDI velocity (1-127)
+     * @return Velocity VELOCITY_HIRES_MIN-65535; the MIDI velocity is this >> 9
      */
-    uint8_t peakToVelocity(uint16_t peakValue, uint8_t padId);
+    uint16_t peakToVelocityHiRes(uint16_t peakValue, uint8_t padId) const;
 
     /**
      * @brief Check if current hit is likely crosstalk
@@ -154,9 +164,10 @@ private:
      * @brief Send hit event to queue
      * @param padId Pad ID
      * @param velocity MIDI velocity
+     * @param velocityHiRes 16-bit velocity
      * @param timestamp Timestamp
      */
-    void sendHitEvent(uint8_t padId, uint8_t velocity, uint32_t timestamp);
+    void sendHitEvent(uint8_t padId, uint8_t velocity, uint16_t velocityHiRes, uint32_t timestamp);
 };
 
 // ============================================================
@@ -32,7 +32,11 @@
 #include "output/midi_controller.h"
 #include "output/audio_engine.h"
 #include "output/audio_samples.h"
+#include "output/sample_loader.h"
+#include "output/sample_arena.h"
 #include "core/event_dispatcher.h"
+#include "core/system_watchdog.h"
+#include "core/log_ring.h"
 #include "communication/uart_protocol.h"
 
 // ============================================================
@@ -63,7 +67,6 @@ const uint16_t VELOCITY_MAX_PEAK[4] = {
     3500, 3500, 3000, 3500
 };
 
-const uint8_t PAD_MIDI_NOTES[4] = {36, 38, 42, 48};
 const CRGB PAD_LED_IDLE_COLOR = CRGB(10, 10, 10);
 const CRGB PAD_LED_HIT_COLORS[4] = {
     CRGB(0, 255, 255),
@@ -84,7 +87,11 @@ uint16_t calibrationMins[4] = {4095, 4095, 4095, 4095};
 uint32_t totalHitsDetected = 0;
 bool audioEngineInitialized = false;
 bool samplesLoaded = false;
+bool sdConfigLoaded = false;   // /config/pads.cfg aplicado (MenuSystem::loadConfiguration)
 uint32_t lastStatusBroadcastMs = 0;
+uint32_t lastMeterBroadcastUs = 0;
+uint32_t lastTempoBroadcastMs = 0;
+TempoMsg lastTempoSent = {};
 
 // ============================================================
 // FORWARD DECLARATIONS
@@ -101,7 +108,11 @@ void startCalibration();
 void processCalibration();
 void checkADCSafety(uint16_t value, uint8_t padId);
 void queueSamplePlayback(const char* name, uint8_t velocity = 120);
-void queuePadSample(uint8_t padId, uint8_t velocity);
+void onHitLed(const BusEvent& event);
+void onHitTelemetry(const BusEvent& event);
+void onSamplesLoaded(const char* path, bool success, void* ctx);
+void broadcastMixerMeters();
+void broadcastTempo();
 
 // ============================================================
 // SETUP
@@ -121,6 +132,10 @@ void setup() {
     Serial.printf("Firmware: %s\n", FIRMWARE_VERSION);
     Serial.println();
 
+    // Log diferido: las rutas calientes (scanner, golpes, menú) solo escriben
+    // en el anillo; la tarea de drenado imprime cuando el UART tiene sitio
+    LogRing::begin();
+
     // =========================================================
     // CRITICAL: Stabilize ALL GPIO pins BEFORE SD card init
     // GPIO21 and GPIO47 (SK9822 LEDs) cause SPI interference
@@ -143,14 +158,28 @@ void setup() {
 
     PadConfigManager::init();
 
-    // Initialize SD card FIRST (before I2S which also uses DMA)
-    Serial.println("[SD] Loading samples from SD card...");
-    size_t loadedSamples = SampleManager::beginAndLoadDefaults();
-    if (loadedSamples > 0) {
+    // Reserve the PSRAM sample arena before anything else fragments PSRAM
+    bool arenaReady = SampleArena::begin();
+
+    // Built-in kit from the flash partition: playable right away, no SD needed.
+    // A kit bundle on the SD card replaces it once loaded.
+    if (arenaReady && SampleManager::loadFlashKit() > 0) {
         samplesLoaded = true;
-        Serial.printf("[SD] Loaded %u samples\n", (unsigned)loadedSamples);
+    }
+
+    // Sin kit de flash: montar la SD antes del I2S (ambos usan DMA), no hay nada
+    // que tocar mientras tanto. Con kit de flash el audio arranca ya y la tarea
+    // de carga monta la SD y negocia su reloj en segundo plano (requestDefaults).
+    bool cardMounted = false;
+    if (!samplesLoaded) {
+        Serial.println("[SD] Mounting SD card...");
+        cardMounted = SampleManager::mountCard();
+        sdConfigLoaded = cardMounted;  // MenuSystem::begin() lo lee
+        if (!cardMounted) {
+            Serial.println("[SD] No card - check SD card");
+        }
     } else {
-        Serial.println("[SD] No samples loaded - check SD card");
+        Serial.println("[SD] Built-in kit ready - SD card mounts in background");
     }
 
     Serial.println("[UART] Initializing display link...");
@@ -165,8 +194,32 @@ void setup() {
         Serial.println("[AUDIO] Audio engine init failed");
     }
 
+    // Fader de cada bus a partir del volumen configurado del pad (0-100)
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        AudioEngine::setBusVolume(i, PadConfigManager::getConfig(i).sampleVolume * 127 / 100);
+    }
+
     Serial.println("[Dispatcher] Initializing subsystems...");
     EventDispatcher::begin();
+    // LEDs y telemetría comparten loop() con NeoPixelController::update() y
+    // el UART: solo importa el último golpe, así que pierden el más antiguo
+    EventDispatcher::subscribe("leds", onHitLed, BUS_PRIORITY_LOOP, BUS_DROP_OLDEST);
+    EventDispatcher::subscribe("telemetry", onHitTelemetry, BUS_PRIORITY_LOOP, BUS_DROP_OLDEST);
+
+    SystemWatchdog::WatchdogConfig watchdogConfig = {
+        SCAN_PERIOD_US,
+        HEAP_WARNING_BYTES,
+        PSRAM_WARNING_BYTES,
+        TEMP_WARNING_CELSIUS,
+        TEMP_SHUTDOWN_CELSIUS,
+        SAMPLE_ARENA_FRAG_WARNING_PCT
+    };
+    SystemWatchdog::begin(watchdogConfig);
+
+    if ((cardMounted || samplesLoaded) && arenaReady && SampleLoader::begin()) {
+        Serial.println("[SD] Loading samples in background...");
+        SampleLoader::requestDefaults(onSamplesLoaded);
+    }
 
     setupHardware();
 
@@ -222,8 +275,9 @@ void loop() {
     processHitEvents();
     processUIInputs();
     MenuSystem::update();  // Update menu state machine
-    EventDispatcher::processAudio();  // Process queued audio samples
-    MIDIController::update();
+    EventDispatcher::pollLoopSubscribers();  // LEDs + UART telemetry from the event bus
+    SampleLoader::update();  // Load completions + progress to display
+    SystemWatchdog::update();  // Heap/PSRAM/arena health at 1 Hz
     NeoPixelController::update();
     handleSerialCommands();
 
@@ -232,10 +286,27 @@ void loop() {
     }
 
     if (millis() - lastStatusBroadcastMs > 1000) {
-        UARTProtocol::sendSystemStatus();
+        UARTProtocol::queueSystemStatus();
         lastStatusBroadcastMs = millis();
     }
 
+    // Medidores del mezclador a ritmo fijo (sin acumular retraso si loop() se atasca)
+    uint32_t nowUs = micros();
+    if (nowUs - lastMeterBroadcastUs >= MIXER_METER_PERIOD_US) {
+        lastMeterBroadcastUs = (nowUs - lastMeterBroadcastUs >= 2 * MIXER_METER_PERIOD_US)
+                                   ? nowUs
+                                   : lastMeterBroadcastUs + MIXER_METER_PERIOD_US;
+        broadcastMixerMeters();
+    }
+
+    if (MIDI_CLOCK_DRIVES_BPM && millis() - lastTempoBroadcastMs >= TEMPO_BROADCAST_PERIOD_MS) {
+        lastTempoBroadcastMs = millis();
+        broadcastTempo();
+    }
+
+    // Todo lo encolado en este tick sale en un solo frame hacia la pantalla
+    UARTProtocol::flushTelemetry();
+
     delay(1);
 }
 
@@ -313,11 +384,11 @@ void flushPendingHits() {
 
                 if (pendingHits[i].event.velocity < (maxVelocity * ratio)) {
                     pendingHits[i].valid = false;
-                    Serial.printf("🚫 X-TALK: Pad %s (Vel %d) suppressed by %s (Vel %d)\n",
-                        PAD_NAMES[pendingHits[i].event.padId],
-                        pendingHits[i].event.velocity,
-                        PAD_NAMES[pendingHits[strongestIdx].event.padId],
-                        maxVelocity);
+                    LOG_EVENT(HIT_CROSSTALK,
+                              pendingHits[i].event.padId,
+                              pendingHits[i].event.velocity,
+                              pendingHits[strongestIdx].event.padId,
+                              maxVelocity);
                 }
             }
         }
@@ -332,8 +403,7 @@ void flushPendingHits() {
         
         // DEBOUNCE CHECK: Ignore if hit too recently
         if (now - lastHitTimeMs[event.padId] < MIN_INTER_HIT_TIME_MS) {
-            Serial.printf("🛡️ DEBOUNCE: Ignored rapid retrigger on %s (%d ms)\n", 
-                          PAD_NAMES[event.padId], now - lastHitTimeMs[event.padId]);
+            LOG_EVENT(HIT_DEBOUNCE, event.padId, now - lastHitTimeMs[event.padId]);
             continue;
         }
         lastHitTimeMs[event.padId] = now;
@@ -342,30 +412,20 @@ void flushPendingHits() {
 
         uint8_t velocity = CLAMP(event.velocity, 1, 127);
 
-        Serial.printf("🥁 HIT: %s | Velocity=%3d | Baseline=%3d | Total=%u\n",
-                      PAD_NAMES[event.padId],
-                      velocity,
-                      triggerDetector.getBaseline(event.padId),
-                      totalHitsDetected);
-
-        uint8_t midiNote = PAD_MIDI_NOTES[event.padId];
-        MIDIController::sendNoteOn(midiNote, velocity);
-
-        CRGB color = PAD_LED_HIT_COLORS[event.padId];
-        uint32_t hitColor = ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
-        uint8_t brightness = map(velocity, 0, 127, 100, 255);
-        NeoPixelController::flashPad(event.padId, hitColor, brightness, 300);
-
-        queuePadSample(event.padId, velocity);
-
-        UARTProtocol::sendHitEvent(event.padId, velocity, event.timestamp, event.peakValue);
-        const PadState& padState = triggerDetector.getPadState(event.padId);
-        UARTProtocol::sendPadState(
-            event.padId,
-            static_cast<uint8_t>(padState.state),
-            padState.peakValue,
-            padState.baselineValue,
-            event.peakValue);
+        LOG_EVENT(HIT_ACCEPTED, event.padId, velocity, event.velocityHiRes,
+                  triggerDetector.getBaseline(event.padId));
+
+        // Un solo publish: audio, MIDI, LEDs y telemetría lo reciben cada uno
+        // en su bandeja, sin que uno lento retrase a los demás
+        BusEvent hit = {};
+        hit.type = BUS_EVENT_HIT;
+        hit.padId = event.padId;
+        hit.velocity = velocity;
+        hit.zone = 0;
+        hit.velocityHiRes = event.velocityHiRes;
+        hit.peakValue = event.peakValue;
+        hit.timestamp = event.timestamp;
+        EventDispatcher::publish(hit);
     }
 
     // Reset buffer
@@ -443,14 +503,15 @@ void processUIInputs() {
     // ========== RIGHT ENCODER (Secondary - volume/etc) ==========
     EncoderHandler::EncoderEvent encRightEvent = EncoderHandler::pollEvent(ENC_RIGHT);
     if (encRightEvent != EncoderHandler::EVENT_NONE) {
-        // Right encoder for future volume control
+        // Right encoder = master volume (smoothed in the mixer)
         // Switch is disabled (GPIO45)
+        int volume = AudioEngine::getMasterVolume();
         switch (encRightEvent) {
             case EncoderHandler::EVENT_ROTATED_CW:
-                // TODO: Master volume up
+                AudioEngine::setMasterVolume(CLAMP(volume + MASTER_VOLUME_STEP, 0, 127));
                 break;
             case EncoderHandler::EVENT_ROTATED_CCW:
-                // TODO: Master volume down
+                AudioEngine::setMasterVolume(CLAMP(volume - MASTER_VOLUME_STEP, 0, 127));
                 break;
             default:
                 break;
@@ -531,6 +592,53 @@ void handleSerialCommands() {
         case '3':
             queueSamplePlayback(SAMPLE_PATH_TOM, 120);
             break;
+        case 'k': case 'K':
+            SampleLoader::requestKitBundle(KIT_BUNDLE_DEFAULT_PATH, onSamplesLoaded);
+            break;
+        case 'l': case 'L': SampleManager::printTrimReport(); break;
+        case 'w': case 'W':
+            SystemWatchdog::printHealth();
+            SampleManager::printCacheStats();
+            Serial.printf("[AUDIO] Voices culled (inaudible): %lu, stolen: %lu\n",
+                          (unsigned long)AudioEngine::culledVoices(),
+                          (unsigned long)AudioEngine::stolenVoices());
+            Serial.printf("[AUDIO] Mixer %s, %lu wakeups from idle\n",
+                          AudioEngine::isIdle() ? "idle" : "rendering",
+                          (unsigned long)AudioEngine::idleWakeups());
+            {
+                MasterLimiterStats lim = AudioEngine::limiterStats();
+                Serial.printf("[AUDIO] Limiter: GR %.1f dB (max %.1f dB), clipped %lu, worst block %lu cycles\n",
+                              -masterLimiterReductionDb(lim.gain), -masterLimiterReductionDb(lim.minGain),
+                              (unsigned long)lim.clippedSamples, (unsigned long)AudioEngine::limiterCycles());
+            }
+            EventDispatcher::printStats();
+            UARTProtocol::printTxStats();
+            LogRing::printStats();
+            break;
+        case 'b': case 'B':
+            LogRing::setBinary(!LogRing::binary());
+            Serial.printf("[LOG] Salida del log: %s\n",
+                          LogRing::binary() ? "binaria (tools/log_decode)" : "texto");
+            break;
+        case 'n': case 'N':
+            MIDIController::printStats();
+            MIDIController::resetStats();
+            break;
+        case 'i': case 'I':
+            MIDIController::setSoundModule(!MIDIController::soundModule());
+            Serial.printf("[MIDI] Módulo de sonido (MIDI in -> kit): %s\n",
+                          MIDIController::soundModule() ? "ON" : "OFF");
+            break;
+        case 'v': case 'V':
+            MIDIController::setHighResVelocity(!MIDIController::highResVelocity());
+            Serial.printf("[MIDI] Velocity alta resolución (CC%d): %s\n", MIDI_CC_HIRES_VELOCITY,
+                          MIDIController::highResVelocity() ? "ON" : "OFF");
+            break;
+        case 'u': case 'U':
+            SystemWatchdog::setCpuMeasurement(!SystemWatchdog::cpuMeasurement());
+            Serial.printf("[WATCHDOG] Medición de carga por núcleo: %s\n",
+                          SystemWatchdog::cpuMeasurement() ? "ON (sin WFI en idle)" : "OFF");
+            break;
         case 'h': case 'H': printHelp(); break;
         default: break;
     }
@@ -591,6 +699,14 @@ void printHelp() {
     Serial.println("  'd' - Mostrar estado del detector (baselines, states)");
     Serial.println("  'c' - Calibrar thresholds (30s automático)");
     Serial.println("  'r' - Reset sistema completo");
+    Serial.println("  'k' - Recargar kit bundle (" KIT_BUNDLE_DEFAULT_PATH ")");
+    Serial.println("  'l' - Listar samples cargados (silencio recortado)");
+    Serial.println("  'w' - Salud del sistema (heap, PSRAM, arena, caché, bus de eventos, UART TX, log)");
+    Serial.println("  'n' - Estadísticas MIDI (lotes USB, retraso de note-offs)");
+    Serial.println("  'v' - Alternar velocity MIDI de alta resolución (prefijo CC88)");
+    Serial.println("  'i' - Alternar módulo de sonido (notas MIDI entrantes tocan el kit)");
+    Serial.println("  'b' - Alternar log diferido texto/binario (decodificar con tools/log_decode)");
+    Serial.println("  'u' - Alternar medición de carga por núcleo (depuración, impide WFI)");
     Serial.println("  'h' - Mostrar esta ayuda");
     Serial.println();
 }
@@ -715,17 +831,89 @@ void queueSamplePlayback(const char* name, uint8_t velocity) {
         return;
     }
 
-    AudioRequest req = {};
+    BusEvent req = {};
+    req.type = BUS_EVENT_PLAY_SAMPLE;
     if (name) {
         strncpy(req.sampleName, name, sizeof(req.sampleName) - 1);
     }
     req.velocity = velocity;
-    req.volume = 127;
-    req.pitch = 0;
-    EventDispatcher::dispatchAudio(req);
+    req.padId = AUDIO_REQUEST_NO_PAD;
+    EventDispatcher::publish(req);
+}
+
+// Suscriptores del bus que corren en loop() (pollLoopSubscribers)
+void onHitLed(const BusEvent& event) {
+    if (event.type != BUS_EVENT_HIT || event.padId >= NUM_PADS) return;
+
+    CRGB color = PAD_LED_HIT_COLORS[event.padId];
+    uint32_t hitColor = ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | color.b;
+    uint8_t brightness = map(event.velocity, 0, 127, 100, 255);
+    NeoPixelController::flashPad(event.padId, hitColor, brightness, 300);
+}
+
+void onHitTelemetry(const BusEvent& event) {
+    if (event.type != BUS_EVENT_HIT || event.padId >= NUM_PADS) return;
+
+    UARTProtocol::queueHitEvent(event.padId, event.velocity, event.timestamp, event.peakValue);
+    const PadState& padState = triggerDetector.getPadState(event.padId);
+    UARTProtocol::queuePadState(
+        event.padId,
+        static_cast<uint8_t>(padState.state),
+        padState.peakValue,
+        padState.baselineValue,
+        event.peakValue);
+}
+
+// Tempo del reloj MIDI entrante hacia la pantalla, solo cuando cambia
+void broadcastTempo() {
+    TempoMsg msg = {};
+    msg.bpmX10 = MIDIController::clockBpmX10();
+    msg.running = MIDIController::clockRunning() ? 1 : 0;
+    if (msg.bpmX10 == 0) return;  // Sin reloj: la pantalla conserva su valor
+    if (msg.bpmX10 == lastTempoSent.bpmX10 && msg.running == lastTempoSent.running) return;
+    lastTempoSent = msg;
+    UARTProtocol::queueTempo(msg);
 }
 
-void queuePadSample(uint8_t padId, uint8_t velocity) {
-    PadConfig& cfg = PadConfigManager::getConfig(padId % NUM_PADS);
-    queueSamplePlayback(cfg.sampleName, velocity);
+// Nivel de medidor 0-127 en escala dB (MIXER_METER_FLOOR_DB .. 0 dBFS)
+static uint8_t meterLevel(uint16_t linear) {
+    if (linear == 0) return 0;
+    float db = 20.0f * log10f(linear / 32767.0f);
+    if (db <= MIXER_METER_FLOOR_DB) return 0;
+    if (db >= 0.0f) return 127;
+    return (uint8_t)(127.0f * (1.0f - db / MIXER_METER_FLOOR_DB));
+}
+
+void broadcastMixerMeters() {
+    MixerMeters meters;
+    if (!audioEngineInitialized || !AudioEngine::readMeters(meters)) return;
+
+    MixerMetersMsg msg = {};
+    for (uint8_t i = 0; i < MIXER_METER_BUSES && i < AUDIO_BUS_COUNT; i++) {
+        msg.peak[i] = meterLevel(meters.bus[i].peak);
+        msg.rms[i] = meterLevel(meters.bus[i].rms);
+    }
+    msg.masterPeak = meterLevel(meters.master.peak);
+    msg.masterRms = meterLevel(meters.master.rms);
+    msg.masterVolume = AudioEngine::getMasterVolume();
+    msg.muteMask = AudioEngine::muteMask();
+    msg.soloMask = AudioEngine::soloMask();
+    UARTProtocol::queueMixerMeters(msg);
+}
+
+// SampleLoader completion (runs in loop() via SampleLoader::update)
+void onSamplesLoaded(const char* path, bool success, void* ctx) {
+    (void)ctx;
+    // SD montada en segundo plano: la config de /config/pads.cfg no se leyó al arrancar
+    if (!sdConfigLoaded && SampleManager::cardClockHz() != 0) {
+        sdConfigLoaded = true;
+        MenuSystem::loadConfiguration();
+    }
+    if (success) {
+        samplesLoaded = true;
+        Serial.printf("[SD] %u samples available\n", (unsigned)SampleManager::loadedCount());
+    } else {
+        Serial.printf("[SD] No samples loaded from %s - check SD card%s\n", path[0] ? path : "defaults",
+                      samplesLoaded ? " (built-in kit still playing)" : "");
+    }
 }
@@ -3,7 +3,9 @@
 #include <edrum_config.h>
 #include <driver/i2s.h>
 #include <math.h>
-#include <algorithm>
+#include <atomic>
+
+static_assert(SAMPLE_ENVELOPE_BLOCK == MIX_ENVELOPE_BLOCK, "Sample envelope must match the mixer envelope block");
 
 namespace AudioEngine {
 
@@ -11,15 +13,42 @@ namespace AudioEngine {
 // VARIABLES INTERNAS
 // ============================================================
 
-static AudioVoice voices[AUDIO_MAX_VOICES];
+// Voces, buses, medidores y limitador. Todo acceso se hace con mixerMutex tomado.
+static AudioMixEngine engine(AUDIO_SAMPLE_RATE);
 static TaskHandle_t mixerTaskHandle = nullptr;
 static SemaphoreHandle_t mixerMutex = nullptr;
 static bool initialized = false;
+static std::atomic<uint32_t> epoch{0};
+
+// Reposo: sin voces y con la salida en silencio el mezclador deja de renderizar
+// y duerme en una notificación. El DMA (tx_desc_auto_clear) emite ceros mientras.
+// Se escribe siempre con mixerMutex tomado.
+static volatile bool mixerIdle = false;
+static uint32_t wakeupCount = 0;
 
-// Buffer de mezcla (Stereo Interleaved)
+// Buffer de salida (Stereo Interleaved)
 // 2 canales * AUDIO_BUFFER_SIZE muestras
 static int16_t outputBuffer[AUDIO_BUFFER_SIZE * 2];
 
+// Despierta el mezclador si está en reposo (con mixerMutex tomado)
+static void wakeMixer() {
+    if (mixerIdle) {
+        mixerIdle = false;
+        wakeupCount++;
+        xTaskNotifyGive(mixerTaskHandle);
+    }
+}
+
+// El motor suelta una voz: devolver la referencia al sample (con mixerMutex tomado)
+static void releaseSample(const void* handle, void* ctx) {
+    (void)ctx;
+    if (handle) SampleManager::releaseSample(static_cast<const Sample*>(handle));
+}
+
+static uint32_t cycleCount() {
+    return ESP.getCycleCount();
+}
+
 // ============================================================
 // TAREA DE MEZCLA (Core 1)
 // ============================================================
@@ -30,71 +59,40 @@ void mixerTask(void* parameter) {
     uint32_t lastDebugTime = 0;
 
     while (true) {
-        // Limpiar buffer (silencio)
-        memset(outputBuffer, 0, sizeof(outputBuffer));
-
         bool signalPresent = false;
+        bool goIdle = false;
 
         // Tomar el mutex para leer las voces de forma segura
         if (xSemaphoreTake(mixerMutex, portMAX_DELAY)) {
-            // ... (rest of logic) ...
-            
-            // Iterar sobre cada muestra del buffer
-            for (int i = 0; i < AUDIO_BUFFER_SIZE; i++) {
-                int32_t leftAccumulator = 0;
-                int32_t rightAccumulator = 0;
-
-                // Mezclar todas las voces activas
-                for (int v = 0; v < AUDIO_MAX_VOICES; v++) {
-                    AudioVoice& voice = voices[v];
-
-                    if (voice.active) {
-                        // Leer muestra actual (Mono source -> Stereo output)
-                        // TODO: Si los samples son stereo, ajustar aquí. Asumimos mono por ahora.
-                        int16_t sample = voice.data[voice.position];
-                        
-                        // Aplicar volumen y velocidad
-                        // Optimización: Usar punto fijo si fuera necesario, pero ESP32 tiene FPU rápida
-                        float gain = voice.volume * voice.velocity;
-                        int32_t processedSample = (int32_t)(sample * gain);
-
-                        leftAccumulator += processedSample;
-                        rightAccumulator += processedSample; // Mono a Stereo
-
-                        // Avanzar posición
-                        voice.position++;
-                        if (voice.position >= voice.length) {
-                            voice.active = false; // Fin del sample
-                        }
-                    }
-                }
-
-                // Soft Clipping / Limiting
-                // Evitar wrap-around distorsion
-                leftAccumulator = std::max(-32767, std::min(32767, leftAccumulator));
-                rightAccumulator = std::max(-32767, std::min(32767, rightAccumulator));
-                
-                if (leftAccumulator != 0 || rightAccumulator != 0) signalPresent = true;
-
-                outputBuffer[i * 2] = (int16_t)leftAccumulator;
-                outputBuffer[i * 2 + 1] = (int16_t)rightAccumulator;
-            }
-
+            // ¿REPOSO? Sin voces, entrada del master en silencio (la línea de
+            // retardo del limitador queda vacía) y bloque de salida en silencio
+            goIdle = engine.render(outputBuffer);
+            signalPresent = engine.hadSignal();
+            if (goIdle) mixerIdle = true;
             xSemaphoreGive(mixerMutex);
         }
-        
+
+        // Bloque cerrado: ninguna voz soltada antes de este punto se vuelve a leer
+        epoch++;
+
         // Debug print once per second if signal is flowing
         if (signalPresent && (millis() - lastDebugTime > 1000)) {
             Serial.println("[AUDIO] Signal flowing to I2S...");
             lastDebugTime = millis();
         }
 
+        if (goIdle) {
+            // El bloque es silencio: no hace falta escribirlo, el DMA ya emite ceros.
+            // play() notifica al arrancar una voz; al despertar se renderiza el bloque
+            // en el acto y, con todos los buffers DMA libres, entra en el siguiente
+            // descriptor: el primer golpe tras el reposo no llega tarde.
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
         // Escribir al I2S (Bloqueante si el buffer DMA está lleno, lo cual regula la velocidad)
         size_t bytesWritten;
         i2s_write(I2S_NUM_0, outputBuffer, sizeof(outputBuffer), &bytesWritten, portMAX_DELAY);
-        
-        // Pequeño yield para evitar starvation si I2S es muy rápido
-        // pero normalmente i2s_write regula el tiempo
     }
 }
 
@@ -104,31 +102,24 @@ void mixerTask(void* parameter) {
 
 void playTestTone() {
     Serial.println("[AUDIO] Playing synthetic test tone (440Hz)...");
-    
-    // Create a temporary synthetic voice in slot 0
-    if (xSemaphoreTake(mixerMutex, 100) == pdTRUE) {
-        AudioVoice& v = voices[0];
-        // We can't use a data pointer since we generate it, 
-        // but for this quick test we will hijack the loop slightly or just
-        // inject directly into buffer.
-        // Better: let's create a small static sine wave buffer
-        static int16_t sineWave[1000];
-        static bool sineInit = false;
-        if (!sineInit) {
-            for(int i=0; i<1000; i++) {
-                sineWave[i] = (int16_t)(sin(2 * M_PI * i * 440.0 / 44100.0) * 10000);
-            }
-            sineInit = true;
+
+    static int16_t sineWave[1000];
+    static bool sineInit = false;
+    if (!sineInit) {
+        for (int i = 0; i < 1000; i++) {
+            sineWave[i] = (int16_t)(sin(2 * M_PI * i * 440.0 / 44100.0) * 10000);
         }
-        
-        v.data = sineWave;
-        v.length = 1000;
-        v.position = 0;
-        v.volume = 1.0f;
-        v.velocity = 1.0f;
-        v.active = true;
-        v.chokeGroup = 0;
-        
+        sineInit = true;
+    }
+
+    // Sin envolvente ni referencia: el motor lo trata como nivel máximo y no lo suelta
+    MixSource tone = {};
+    tone.data = sineWave;
+    tone.frames = 1000;
+    tone.channels = 1;
+
+    if (xSemaphoreTake(mixerMutex, 100) == pdTRUE) {
+        if (engine.start(tone, 127, 127, 0, AUDIO_BUS_NONE)) wakeMixer();
         xSemaphoreGive(mixerMutex);
     }
 }
@@ -143,6 +134,10 @@ bool begin() {
         return false;
     }
 
+    engine.setReleaseHook(releaseSample, nullptr);
+    engine.setCycleCounter(cycleCount);
+    engine.setMasterVolume(MASTER_VOLUME_DEFAULT);
+
     // Configurar I2S
     i2s_config_t config = {};
     config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX);
@@ -192,73 +187,49 @@ bool begin() {
     return true;
 }
 
-void play(const char* sampleName, uint8_t velocity, uint8_t volume, uint8_t chokeGroup) {
-    if (!initialized || !sampleName) return;
-
-    // Obtener datos del sample desde SampleManager
-    const Sample* s = SampleManager::getSample(sampleName);
-    if (!s || !s->data || s->frames == 0) return;
+bool play(const char* sampleName, uint8_t velocity, uint8_t volume, uint8_t chokeMask, uint8_t bus,
+          uint16_t velocityHiRes) {
+    if (!initialized || !sampleName) return false;
 
+    bool started = false;
     if (xSemaphoreTake(mixerMutex, 10) == pdTRUE) { // Esperar máx 10 ticks
-        
-        // 1. CHOKE GROUP LOGIC
-        // Si el sonido pertenece a un grupo, detener otros de ese grupo
-        if (chokeGroup > 0) {
-            for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
-                if (voices[i].active && voices[i].chokeGroup == chokeGroup) {
-                    voices[i].active = false; // Hard cut (TODO: Fade out rápido)
-                }
-            }
-        }
-
-        // 2. BUSCAR VOZ LIBRE
-        int voiceIndex = -1;
-        
-        // Primero buscar una inactiva
-        for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
-            if (!voices[i].active) {
-                voiceIndex = i;
-                break;
-            }
-        }
 
-        // Si no hay libres, robar la más vieja (o la más avanzada en reproducción)
-        // Estrategia simple: robar la que tenga mayor posición (más cerca del final)
-        if (voiceIndex == -1) {
-            uint32_t maxPos = 0;
-            for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
-                if (voices[i].position > maxPos) {
-                    maxPos = voices[i].position;
-                    voiceIndex = i;
-                }
-            }
+        // Tomar referencia bajo el mutex del mezclador: mientras la voz la tenga,
+        // SampleManager no libera los datos aunque se descargue el sample
+        const Sample* s = SampleManager::acquireSample(sampleName);
+        if (!s) {
+            xSemaphoreGive(mixerMutex);
+            return false;
         }
 
-        // 3. CONFIGURAR VOZ
-        if (voiceIndex != -1) {
-            AudioVoice& v = voices[voiceIndex];
-            v.data = s->data;
-            v.length = s->frames;
-            v.position = 0;
-            v.volume = (float)volume / 127.0f;
-            v.velocity = (float)velocity / 127.0f;
-            v.chokeGroup = chokeGroup; // Asignar grupo para futuros chokes
-            v.active = true;
+        MixSource src;
+        src.data = s->data;
+        src.coded = s->coded;
+        src.format = s->format;
+        src.frames = s->frames;
+        src.channels = s->channels;
+        src.envelope = s->envelope;
+        src.envelopeBlocks = s->envelopeBlocks;
+        src.handle = s;
+
+        // Choke por grupos, búsqueda/robo de voz y arranque: ver MixEngine::start
+        started = engine.start(src, velocity, volume, chokeMask, bus, velocityHiRes);
+        if (started) {
+            wakeMixer();
+        } else {
+            SampleManager::releaseSample(s);  // Vacío o formato no soportado
         }
 
         xSemaphoreGive(mixerMutex);
     }
+    return started;
 }
 
-void choke(uint8_t chokeGroup) {
-    if (!initialized || chokeGroup == 0) return;
+void choke(uint8_t chokeMask) {
+    if (!initialized || chokeMask == 0) return;
 
     if (xSemaphoreTake(mixerMutex, 10) == pdTRUE) {
-        for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
-            if (voices[i].active && voices[i].chokeGroup == chokeGroup) {
-                voices[i].active = false;
-            }
-        }
+        engine.choke(chokeMask);
         xSemaphoreGive(mixerMutex);
     }
 }
@@ -267,11 +238,104 @@ void stopAll() {
     if (!initialized) return;
     
     if (xSemaphoreTake(mixerMutex, 10) == pdTRUE) {
-        for (int i = 0; i < AUDIO_MAX_VOICES; i++) {
-            voices[i].active = false;
-        }
+        engine.stopAll();
         xSemaphoreGive(mixerMutex);
     }
 }
 
-} // namespace AudioEngine
\ No newline at end of file
+// ============================================================
+// MEZCLADOR
+// ============================================================
+
+// Los parámetros se cambian con el mutex tomado; el motor aplica la rampa en
+// el siguiente bloque, así que pueden llamarse desde cualquier tarea
+static bool lockMixer() {
+    return initialized && xSemaphoreTake(mixerMutex, 10) == pdTRUE;
+}
+
+void setBusVolume(uint8_t bus, uint8_t volume) {
+    if (!lockMixer()) return;
+    engine.setBusVolume(bus, volume);
+    xSemaphoreGive(mixerMutex);
+}
+
+void setBusPan(uint8_t bus, int8_t pan) {
+    if (!lockMixer()) return;
+    engine.setBusPan(bus, pan);
+    xSemaphoreGive(mixerMutex);
+}
+
+void setBusMute(uint8_t bus, bool mute) {
+    if (!lockMixer()) return;
+    engine.setBusMute(bus, mute);
+    xSemaphoreGive(mixerMutex);
+}
+
+void setBusSolo(uint8_t bus, bool solo) {
+    if (!lockMixer()) return;
+    engine.setBusSolo(bus, solo);
+    xSemaphoreGive(mixerMutex);
+}
+
+uint8_t getBusVolume(uint8_t bus) {
+    return engine.busVolume(bus);
+}
+
+uint8_t muteMask() {
+    return engine.muteMask();
+}
+
+uint8_t soloMask() {
+    return engine.soloMask();
+}
+
+void setMasterVolume(uint8_t volume) {
+    if (!lockMixer()) return;
+    engine.setMasterVolume(volume);
+    xSemaphoreGive(mixerMutex);
+}
+
+uint8_t getMasterVolume() {
+    return engine.getMasterVolume();
+}
+
+bool readMeters(MixerMeters& out) {
+    if (!lockMixer()) return false;
+    engine.readMeters(out);
+    xSemaphoreGive(mixerMutex);
+    return true;
+}
+
+MasterLimiterStats limiterStats() {
+    return engine.limiterStats();
+}
+
+uint32_t limiterCycles() {
+    return engine.limiterCycles();
+}
+
+uint32_t culledVoices() {
+    return engine.culledVoices();
+}
+
+uint32_t stolenVoices() {
+    return engine.stolenVoices();
+}
+
+uint32_t mixEpoch() {
+    return epoch.load();
+}
+
+bool isRunning() {
+    return initialized && !mixerIdle;
+}
+
+bool isIdle() {
+    return mixerIdle;
+}
+
+uint32_t idleWakeups() {
+    return wakeupCount;
+}
+
+} // namespace AudioEngine
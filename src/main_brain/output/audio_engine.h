@@ -5,23 +5,20 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <edrum_config.h>
+#include <mix_engine.h>
 
 // Configuración del motor
 #define AUDIO_MAX_VOICES 12        // Polifonía máxima (12 sonidos simultáneos)
-#define AUDIO_BUFFER_SIZE 256      // Tamaño del buffer de mezcla (muestras por frame)
+#define AUDIO_BUFFER_SIZE 256      // Tamaño del buffer de mezcla (frames por bloque)
 #define AUDIO_SAMPLE_RATE 44100
+#define AUDIO_BUS_COUNT NUM_PADS   // Un bus de mezcla por pad
+#define AUDIO_BUS_NONE MIX_BUS_NONE // Sin pad: va directo al master (tono de prueba, previews)
 
-// Estructura de una voz individual
-struct AudioVoice {
-    bool active = false;           // Si está sonando o no
-    const int16_t* data = nullptr; // Puntero al inicio del sample en PSRAM
-    uint32_t length = 0;           // Longitud total en muestras
-    uint32_t position = 0;         // Posición actual de reproducción
-    float volume = 1.0f;           // Volumen (0.0 a 1.0) base
-    float velocity = 1.0f;         // Velocidad del golpe (0.0 a 1.0)
-    uint8_t chokeGroup = 0;        // Grupo de exclusión (0 = ninguno)
-    bool loop = false;             // (Futuro) Para loops
-};
+// Motor de mezcla (shared/audio/mix_engine.h): voces -> buses por pad -> master -> limitador.
+// Salida estéreo; los samples pueden ser mono o estéreo.
+typedef MixEngine<AUDIO_MAX_VOICES, AUDIO_BUFFER_SIZE, 2, AUDIO_BUS_COUNT> AudioMixEngine;
+typedef AudioMixEngine::Meters MixerMeters;
 
 namespace AudioEngine {
 
@@ -34,15 +31,54 @@ namespace AudioEngine {
     // Dispara un sonido (Non-blocking)
     // sampleName: nombre del archivo cargado
     // velocity: fuerza del golpe (0-127)
-    // chokeGroup: ID de grupo de exclusión (ej. 1 para HiHat). 0 = sin exclusión.
-    void play(const char* sampleName, uint8_t velocity, uint8_t volume = 127, uint8_t chokeGroup = 0);
+    // chokeMask: grupos de choke del pad (PadConfigManager::getChokeMask). Las voces
+    //            que compartan algún grupo se apagan con un fade corto. 0 = sin exclusión.
+    // bus: pad que lo dispara (AUDIO_BUS_NONE = directo al master)
+    // velocityHiRes: velocity de 16 bits del detector (0 = usar la de 7 bits)
+    // Devuelve true si arrancó una voz (sample cargado y mezclador disponible)
+    bool play(const char* sampleName, uint8_t velocity, uint8_t volume = 127, uint8_t chokeMask = 0,
+              uint8_t bus = AUDIO_BUS_NONE, uint16_t velocityHiRes = 0);
 
-    // Detiene todos los sonidos de un grupo específico (ej. cerrar HiHat)
-    void choke(uint8_t chokeGroup);
+    // Apaga con fade corto los sonidos de los grupos indicados (ej. cerrar HiHat)
+    void choke(uint8_t chokeMask);
 
     // Detiene todo (Panic)
     void stopAll();
 
+    // Mezclador: volumen 0-127, paneo -64..+64. Los cambios se aplican con rampa
+    // en el siguiente bloque, así que pueden llamarse desde cualquier tarea.
+    void setBusVolume(uint8_t bus, uint8_t volume);
+    void setBusPan(uint8_t bus, int8_t pan);
+    void setBusMute(uint8_t bus, bool mute);
+    void setBusSolo(uint8_t bus, bool solo);
+    uint8_t getBusVolume(uint8_t bus);
+    uint8_t muteMask();   // bit n = bus n
+    uint8_t soloMask();
+    void setMasterVolume(uint8_t volume);
+    uint8_t getMasterVolume();
+
+    // Pico/RMS por bus y master desde la lectura anterior. false si no hay lectura.
+    bool readMeters(MixerMeters& out);
+
+    // Limitador del master: ganancia actual/mínima y peor coste en ciclos por bloque
+    MasterLimiterStats limiterStats();
+    uint32_t limiterCycles();
+
+    // Voces cortadas por inaudibles / robadas desde el arranque
+    uint32_t culledVoices();
+    uint32_t stolenVoices();
+
+    // Época del mezclador: se incrementa al terminar cada bloque de AUDIO_BUFFER_SIZE.
+    // SampleManager la usa para saber cuándo puede liberar un sample retirado.
+    uint32_t mixEpoch();
+
+    // true si la tarea de mezcla está renderizando (false si no existe o está en reposo)
+    bool isRunning();
+
+    // Reposo: sin voces el mezclador duerme hasta que play() lo despierta
+    bool isIdle();
+    uint32_t idleWakeups();
+
 }  // namespace AudioEngine
 
 #endif  // AUDIO_ENGINE_H
\ No newline at end of file
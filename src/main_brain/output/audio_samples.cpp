@@ -1,22 +1,106 @@
 #include "audio_samples.h"
 #include <esp_heap_caps.h>
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <edrum_config.h>
 #include <cstring>
+#include <math.h>
 #include "pad_config.h"
-
-// Use SD card for samples (requires pull-up resistors on GPIO45/46)
-#define USE_EMBEDDED_SAMPLES 0
+#include "kit_bundle.h"
+#include "sample_trim.h"
+#include "sample_codec.h"
+#include "audio_engine.h"
+#include "sample_arena.h"
+#include <esp_rom_crc.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 namespace {
 
-struct LoadedSample {
-    String name;
-    Sample sample;
+// ============================================================
+// TABLA DE SAMPLES + CACHÉ POR CONTENIDO
+// ============================================================
+// Dos tablas de tamaño fijo:
+//   - slots: un bloque de audio en PSRAM, identificado por su huella de
+//     contenido (kitSampleFingerprint). Los punteros a Sample son estables.
+//   - nombres: ruta/nombre -> slot. Un mismo sample usado por varios kits
+//     (o como WAV suelto) se carga una vez y lo comparten todos sus nombres.
+//
+// Un slot con algún nombre está fijado (kit activo, samples de PadConfig).
+// Descargar o cambiar de kit sólo quita nombres: el slot pasa a la caché,
+// sigue en PSRAM y se reutiliza si se vuelve a pedir el mismo contenido.
+// La caché se desaloja por LRU cuando supera el presupuesto o cuando falta
+// memoria para una carga, y nunca antes de que
+//   1. ninguna voz lo referencie (refcount, liberado por el mezclador), y
+//   2. el mezclador haya terminado al menos un bloque desde que perdió su
+//      último nombre (época publicada por AudioEngine::mixEpoch()), o esté
+//      en reposo (sin voces no lee ningún sample).
+// Así un kit se puede cambiar en caliente sin cortar las colas que suenan.
+
+enum SlotState : uint8_t {
+    SLOT_FREE = 0,
+    SLOT_USED
+};
+
+struct SlotMeta {
+    SlotState state;
+    uint32_t fingerprint;
+    uint32_t bytes;             // Memoria ocupada (tras recortar)
+    SampleArena::BankId bank;   // Banco de kit; NO_BANK = reserva propia (WAV suelto)
+    uint16_t names;             // Nombres que apuntan al slot (> 0 = fijado)
+    uint32_t lastUse;           // Reloj LRU
+    uint32_t unpinEpoch;        // Época del mezclador al perder el último nombre
+};
+
+struct NameEntry {
+    char name[SAMPLE_NAME_LEN] = {};
+    int16_t slot = -1;          // -1 = entrada libre
+    bool fromKit = false;       // Registrado por un kit bundle
+};
+
+Sample slotSamples[SAMPLE_MAX_SLOTS];
+SlotMeta slotMeta[SAMPLE_MAX_SLOTS];
+std::atomic<uint16_t> slotRefs[SAMPLE_MAX_SLOTS];
+NameEntry nameTable[SAMPLE_MAX_NAMES];
+uint32_t useClock = 0;
+
+uint32_t cacheBudget = SAMPLE_CACHE_BUDGET_BYTES;
+uint32_t cacheHits = 0;
+uint32_t cacheMisses = 0;
+uint32_t cacheEvictions = 0;
+
+// Slots que apuntan a cada banco de la arena. Un banco cerrado se libera
+// entero cuando se desaloja su último slot.
+uint16_t bankSlots[SAMPLE_ARENA_MAX_BANKS] = {};
+
+// Protege ambas tablas y los bancos: el loader escribe desde su tarea
+// mientras loop()/AudioEngine buscan samples. La lectura de SD se hace
+// siempre fuera del lock; sólo la búsqueda y el registro lo toman.
+SemaphoreHandle_t samplesMutex = nullptr;
+
+struct SampleLock {
+    SampleLock() { xSemaphoreTake(samplesMutex, portMAX_DELAY); }
+    ~SampleLock() { xSemaphoreGive(samplesMutex); }
 };
 
-std::vector<LoadedSample> loaded;
+void ensureMutex() {
+    if (!samplesMutex) samplesMutex = xSemaphoreCreateMutex();
+}
+
+// Lecturas grandes = transferencias multi-sector SPI
+constexpr size_t SD_READ_CHUNK = 32 * 1024;
+
+uint32_t negotiatedClockHz = 0;
+
+// Kit de la partición de flash: mapeado una vez y para siempre (las voces
+// leen directamente de la caché de flash)
+const uint8_t* flashKitBase = nullptr;
+spi_flash_mmap_handle_t flashKitHandle;
+
+// Candidatos de reloj SPI por encima de SD_SAFE_CLOCK_HZ, del más rápido al más lento
+const uint32_t SD_CLOCK_CANDIDATES_HZ[] = {40000000, 26000000, 20000000, 16000000, 10000000, 8000000};
 
 uint32_t readLE32(File& f) {
     uint8_t b[4];
@@ -30,38 +114,47 @@ uint16_t readLE16(File& f) {
     return (uint16_t)b[0] | ((uint16_t)b[1] << 8);
 }
 
-bool loadWavToPSRAM(const char* path, Sample& out) {
-    if (!SD.exists(path)) {
-        Serial.printf("[SAMPLE] File not found: %s\n", path);
-        return false;
+// Lee 'bytes' en bloques de SD_READ_CHUNK informando el progreso
+bool readChunked(File& f, uint8_t* dst, size_t bytes, SampleManager::LoadProgressFn progress, void* ctx) {
+    size_t done = 0;
+    while (done < bytes) {
+        size_t chunk = std::min(SD_READ_CHUNK, bytes - done);
+        size_t got = f.read(dst + done, chunk);
+        done += got;
+        if (progress) progress(done, bytes, ctx);
+        if (got != chunk) return false;
     }
+    return true;
+}
 
-    File f = SD.open(path, FILE_READ);
-    if (!f) {
-        Serial.printf("[SAMPLE] Cannot open %s\n", path);
-        return false;
-    }
+// ============================================================
+// WAV
+// ============================================================
 
+struct WavInfo {
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t dataPos;
+    uint32_t dataSize;
+};
+
+// Valida la cabecera RIFF/WAVE y localiza el chunk de datos (PCM 16-bit)
+bool parseWav(File& f, const char* path, WavInfo& info) {
     char riff[4];
     if (f.read((uint8_t*)riff, 4) != 4 || strncmp(riff, "RIFF", 4) != 0) {
         Serial.printf("[SAMPLE] %s missing RIFF\n", path);
-        f.close();
         return false;
     }
     f.seek(8); // skip RIFF size
     char wave[4];
     if (f.read((uint8_t*)wave, 4) != 4 || strncmp(wave, "WAVE", 4) != 0) {
         Serial.printf("[SAMPLE] %s not WAVE\n", path);
-        f.close();
         return false;
     }
 
     uint16_t audioFormat = 0;
-    uint16_t numChannels = 0;
-    uint32_t sampleRate = 0;
     uint16_t bitsPerSample = 0;
-    uint32_t dataSize = 0;
-    uint32_t dataPos = 0;
+    info = WavInfo();
 
     // Parse chunks
     while (f.available()) {
@@ -71,88 +164,806 @@ bool loadWavToPSRAM(const char* path, Sample& out) {
 
         if (strncmp(chunkId, "fmt ", 4) == 0) {
             audioFormat = readLE16(f);
-            numChannels = readLE16(f);
-            sampleRate = readLE32(f);
+            info.channels = readLE16(f);
+            info.sampleRate = readLE32(f);
             f.seek(f.position() + 6); // skip byteRate + blockAlign
             bitsPerSample = readLE16(f);
             if (chunkSize > 16) f.seek(f.position() + (chunkSize - 16));
         } else if (strncmp(chunkId, "data", 4) == 0) {
-            dataSize = chunkSize;
-            dataPos = f.position();
+            info.dataSize = chunkSize;
+            info.dataPos = f.position();
             f.seek(f.position() + chunkSize);
         } else {
             f.seek(f.position() + chunkSize);
         }
     }
 
-    if (audioFormat != 1 || bitsPerSample != 16 || dataSize == 0) {
+    if (audioFormat != 1 || bitsPerSample != 16 || info.dataSize == 0 || info.channels == 0) {
         Serial.printf("[SAMPLE] %s unsupported format (fmt=%u bits=%u data=%u)\n",
-                      path, audioFormat, bitsPerSample, dataSize);
-        f.close();
+                      path, audioFormat, bitsPerSample, info.dataSize);
         return false;
     }
+    return true;
+}
 
-    f.seek(dataPos);
-    size_t bytes = dataSize;
-    int16_t* buf = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
-    if (!buf) {
-        buf = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_DEFAULT);
+// Huella de contenido leyendo sólo los extremos del chunk de datos
+bool fingerprintWav(File& f, const WavInfo& info, uint32_t& fingerprint) {
+    uint32_t span = kitFingerprintSpan(info.dataSize);
+    uint8_t* buf = (uint8_t*)heap_caps_malloc(span, MALLOC_CAP_DEFAULT);
+    if (!buf) return false;
+
+    uint32_t hash = kitFingerprintBegin(info.dataSize, info.sampleRate, (uint8_t)info.channels);
+    bool ok = f.seek(info.dataPos) && f.read(buf, span) == span;
+    if (ok) {
+        hash = kitFingerprintUpdate(hash, buf, span);
+        ok = f.seek(info.dataPos + info.dataSize - span) && f.read(buf, span) == span;
     }
-    if (!buf) {
-        Serial.printf("[SAMPLE] No memory for %s\n", path);
-        f.close();
-        return false;
+    if (ok) {
+        fingerprint = kitFingerprintUpdate(hash, buf, span);
     }
+    heap_caps_free(buf);
+    return ok;
+}
 
-    size_t read = f.read((uint8_t*)buf, bytes);
-    f.close();
-    
-    if (read != bytes) {
-        Serial.printf("[SAMPLE] Short read %s (%u/%u)\n", path, (unsigned)read, (unsigned)bytes);
-        free(buf);
-        return false;
+// --- Helpers de las tablas (llamar con SampleLock tomado) ---
+
+int findName(const char* name) {
+    for (int i = 0; i < SAMPLE_MAX_NAMES; i++) {
+        if (nameTable[i].slot >= 0 && strcmp(nameTable[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+int findLive(const char* name) {
+    int entry = findName(name);
+    return entry >= 0 ? nameTable[entry].slot : -1;
+}
+
+// La huella es del contenido original (antes de recortar) e incluye su tamaño
+int findContent(uint32_t fingerprint, uint32_t sampleRate, uint8_t channels) {
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        const SlotMeta& meta = slotMeta[i];
+        if (meta.state == SLOT_USED && meta.fingerprint == fingerprint &&
+            slotSamples[i].sampleRate == sampleRate && slotSamples[i].channels == channels) {
+            return i;
+        }
     }
+    return -1;
+}
+
+void touch(int slot) {
+    slotMeta[slot].lastUse = ++useClock;
+}
+
+int freeSlotCount() {
+    int count = 0;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (slotMeta[i].state == SLOT_FREE) count++;
+    }
+    return count;
+}
 
-    out.data = buf;
-    out.frames = dataSize / (numChannels * sizeof(int16_t));
-    out.sampleRate = sampleRate;
-    out.channels = numChannels;
+void unmapName(int entry) {
+    SlotMeta& meta = slotMeta[nameTable[entry].slot];
+    if (--meta.names == 0) {
+        meta.unpinEpoch = AudioEngine::mixEpoch();
+    }
+    nameTable[entry].slot = -1;
+    nameTable[entry].name[0] = '\0';
+    nameTable[entry].fromKit = false;
+}
 
-    Serial.printf("[SAMPLE] Loaded %s: %lu frames, %u ch, %lu Hz\n",
-                  path, (unsigned long)out.frames, out.channels, (unsigned long)out.sampleRate);
+// Asocia un nombre a un slot; si apuntaba a otro slot lo suelta (hot reload)
+bool mapName(const char* name, int slot, bool fromKit) {
+    int entry = findName(name);
+    if (entry >= 0 && nameTable[entry].slot == slot) {
+        nameTable[entry].fromKit = fromKit;
+        touch(slot);
+        return true;
+    }
+    if (entry >= 0) {
+        unmapName(entry);
+    } else {
+        for (int i = 0; i < SAMPLE_MAX_NAMES; i++) {
+            if (nameTable[i].slot < 0) {
+                entry = i;
+                break;
+            }
+        }
+        if (entry < 0) return false;
+    }
+
+    NameEntry& n = nameTable[entry];
+    strncpy(n.name, name, sizeof(n.name) - 1);
+    n.name[sizeof(n.name) - 1] = '\0';
+    n.fromKit = fromKit;
+    n.slot = slot;
+    slotMeta[slot].names++;
+    touch(slot);
     return true;
 }
 
+// Suelta todos los nombres registrados por kit bundles
+void unmapKitNames() {
+    for (int i = 0; i < SAMPLE_MAX_NAMES; i++) {
+        if (nameTable[i].slot >= 0 && nameTable[i].fromKit) unmapName(i);
+    }
+}
+
+int allocSlot(const Sample& sample, uint32_t fingerprint, uint32_t bytes, SampleArena::BankId bank) {
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (slotMeta[i].state != SLOT_FREE) continue;
+
+        SlotMeta& meta = slotMeta[i];
+        meta.fingerprint = fingerprint;
+        meta.bytes = bytes;
+        meta.bank = bank;
+        meta.names = 0;
+        meta.unpinEpoch = AudioEngine::mixEpoch();
+        slotRefs[i] = 0;
+        slotSamples[i] = sample;
+        if (bank != SampleArena::NO_BANK) bankSlots[bank]++;
+        touch(i);
+        meta.state = SLOT_USED;
+        return i;
+    }
+    return -1;
+}
+
+// Cierra un banco tras cargar su kit; si ningún slot lo usa se libera ya
+void finishBank(SampleArena::BankId bank) {
+    SampleArena::sealBank(bank);
+    if (bankSlots[bank] == 0) SampleArena::releaseBank(bank);
+}
+
+void freeSlot(int i) {
+    SlotMeta& meta = slotMeta[i];
+    if (meta.bank == SampleArena::NO_BANK) {
+        SampleArena::release(slotSamples[i].data);
+    } else if (--bankSlots[meta.bank] == 0 && SampleArena::isSealed(meta.bank)) {
+        // Un banco aún abierto lo libera finishBank()
+        SampleArena::releaseBank(meta.bank);
+    }
+    slotSamples[i] = Sample();
+    meta.bank = SampleArena::NO_BANK;
+    meta.state = SLOT_FREE;
+}
+
+bool isCached(int i) {
+    return slotMeta[i].state == SLOT_USED && slotMeta[i].names == 0;
+}
+
+// En caché, sin voces y con al menos un bloque mezclado desde que se soltó
+bool isEvictable(int i, uint32_t epoch, bool mixerRunning) {
+    return isCached(i) && slotRefs[i] == 0 &&
+           !(mixerRunning && epoch == slotMeta[i].unpinEpoch);
+}
+
+uint32_t cachedBytes() {
+    uint32_t bytes = 0;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (isCached(i)) bytes += slotMeta[i].bytes;
+    }
+    return bytes;
+}
+
+// Desaloja el sample en caché usado hace más tiempo
+bool evictLRU() {
+    uint32_t epoch = AudioEngine::mixEpoch();
+    bool mixerRunning = AudioEngine::isRunning();
+    int victim = -1;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (!isEvictable(i, epoch, mixerRunning)) continue;
+        if (victim < 0 || slotMeta[i].lastUse < slotMeta[victim].lastUse) victim = i;
+    }
+    if (victim < 0) return false;
+
+    freeSlot(victim);
+    cacheEvictions++;
+    return true;
+}
+
+size_t enforceBudget() {
+    size_t evicted = 0;
+    while (cachedBytes() > cacheBudget && evictLRU()) evicted++;
+    return evicted;
+}
+
+// Reserva PSRAM desalojando caché LRU mientras no quepa
+void* allocEvicting(size_t bytes) {
+    while (true) {
+        void* ptr = SampleArena::allocSample(bytes);
+        if (ptr) return ptr;
+        SampleLock lock;
+        if (!evictLRU()) return nullptr;
+    }
+}
+
+SampleArena::BankId openBankEvicting(size_t capacity) {
+    while (true) {
+        SampleArena::BankId bank = SampleArena::openBank(capacity);
+        if (bank != SampleArena::NO_BANK) return bank;
+        SampleLock lock;
+        if (!evictLRU()) return SampleArena::NO_BANK;
+    }
+}
+
+// ============================================================
+// ENVOLVENTE (culling y robo de voces en el mezclador)
+// ============================================================
+
+uint32_t envelopeBlocks(uint32_t frames) {
+    return mixEnvelopeBlocks(frames);
+}
+
+uint32_t envelopeBytes(uint32_t frames) {
+    return envelopeBlocks(frames) * sizeof(uint16_t);
+}
+
+// El envolvente va detrás del PCM, en la misma reserva
+size_t envelopeOffset(size_t pcmBytes) {
+    return (pcmBytes + 15) & ~(size_t)15;
+}
+
+// Envolvente (mix_engine.h, el mismo cálculo que el render offline del host).
+// Un sample comprimido se decodifica bloque a bloque (lo que oirá el mezclador).
+void buildEnvelope(Sample& s, uint16_t* env) {
+    static int16_t decoded[SAMPLE_CODEC_BLOCK * 2];  // Sólo la tarea que carga
+    MixSource src = {};
+    src.data = s.data;
+    src.coded = s.coded;
+    src.format = s.format;
+    src.frames = s.frames;
+    src.channels = s.channels;
+    mixBuildEnvelope(src, env, decoded);
+    s.envelope = env;
+    s.envelopeBlocks = envelopeBlocks(s.frames);
+}
+
+// Progreso acumulado de varias lecturas dentro de una misma carga
+struct ProgressSpan {
+    SampleManager::LoadProgressFn fn;
+    void* ctx;
+    uint32_t base;
+    uint32_t total;
+};
+
+void spanProgress(uint32_t bytesDone, uint32_t, void* ctx) {
+    ProgressSpan* span = static_cast<ProgressSpan*>(ctx);
+    if (span->fn) span->fn(span->base + bytesDone, span->total, span->ctx);
+}
+
+// ============================================================
+// SD CLOCK NEGOTIATION
+// ============================================================
+
+// Primer sector de prueba: inicio de la primera partición (boot sector + FAT,
+// con datos no nulos) o 0 si la tarjeta no tiene tabla de particiones
+uint32_t probeBaseSector = 0;
+
+uint32_t findProbeBase() {
+    uint8_t* mbr = (uint8_t*)heap_caps_malloc(512, MALLOC_CAP_DMA);
+    if (!mbr) return 0;
+
+    uint32_t base = 0;
+    if (SD.readRAW(mbr, 0) && mbr[510] == 0x55 && mbr[511] == 0xAA && mbr[0x1C2] != 0) {
+        base = (uint32_t)mbr[0x1C6] | ((uint32_t)mbr[0x1C7] << 8) |
+               ((uint32_t)mbr[0x1C8] << 16) | ((uint32_t)mbr[0x1C9] << 24);
+    }
+    heap_caps_free(mbr);
+    return base;
+}
+
+// CRC de SD_PROBE_SECTORS sectores consecutivos con el reloj actual
+bool probeSectors(uint16_t* crcs) {
+    uint8_t* sector = (uint8_t*)heap_caps_malloc(512, MALLOC_CAP_DMA);
+    if (!sector) return false;
+
+    bool ok = true;
+    for (uint32_t i = 0; i < SD_PROBE_SECTORS && ok; i++) {
+        ok = SD.readRAW(sector, probeBaseSector + i);
+        if (ok) crcs[i] = esp_rom_crc16_le(0, sector, 512);
+    }
+    heap_caps_free(sector);
+    return ok;
+}
+
+bool mountAt(uint32_t hz) {
+    SD.end();
+    return SD.begin(SD_CS_PIN, SPI, hz, "/sd");
+}
+
+// Acepta 'hz' sólo si todas las pasadas reproducen los CRC de referencia
+bool verifyClock(uint32_t hz, const uint16_t* reference) {
+    if (!mountAt(hz)) return false;
+
+    uint16_t crcs[SD_PROBE_SECTORS];
+    for (int pass = 0; pass < SD_PROBE_PASSES; pass++) {
+        if (!probeSectors(crcs) || memcmp(crcs, reference, sizeof(crcs)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cabecera de un bundle de 'size' bytes (archivo en SD o partición de flash)
+bool validKitHeader(const char* path, const KitBundleHeader& header, size_t size) {
+    if (header.magic != KIT_BUNDLE_MAGIC) {
+        Serial.printf("[KIT] %s is not a kit bundle\n", path);
+        return false;
+    }
+    if (header.version != KIT_BUNDLE_VERSION ||
+        header.headerSize != sizeof(KitBundleHeader) ||
+        header.entrySize != sizeof(KitBundleEntry)) {
+        Serial.printf("[KIT] %s unsupported bundle version %u\n", path, header.version);
+        return false;
+    }
+    if (header.sampleCount == 0 || header.sampleCount > KIT_BUNDLE_MAX_SAMPLES ||
+        header.dataSize == 0 || header.dataOffset % KIT_BUNDLE_ALIGN != 0 ||
+        header.indexOffset + header.sampleCount * sizeof(KitBundleEntry) > header.dataOffset ||
+        (size_t)header.dataOffset + header.dataSize > size) {
+        Serial.printf("[KIT] %s has an invalid header\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool validKitEntries(const char* path, const KitBundleHeader& header, const std::vector<KitBundleEntry>& index) {
+    for (const KitBundleEntry& e : index) {
+        bool valid = sampleCodecIsKnown(e.format) &&
+                     (e.channels == 1 || e.channels == 2) &&
+                     e.frames > 0 &&
+                     e.bytes == sampleCodecBytes(e.format, e.frames, e.channels) &&
+                     e.offset % KIT_BUNDLE_ALIGN == 0 &&
+                     (size_t)e.offset + e.bytes <= header.dataSize;
+        if (!valid) {
+            Serial.printf("[KIT] %s bad entry '%.*s'\n", path, KIT_BUNDLE_NAME_LEN, e.name);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readKitIndex(File& f, const char* path, KitBundleHeader& header, std::vector<KitBundleEntry>& index) {
+    if (f.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        !validKitHeader(path, header, f.size())) {
+        return false;
+    }
+
+    index.resize(header.sampleCount);
+    size_t indexBytes = header.sampleCount * sizeof(KitBundleEntry);
+    f.seek(header.indexOffset);
+    if (f.read((uint8_t*)index.data(), indexBytes) != indexBytes) {
+        Serial.printf("[KIT] %s short index read\n", path);
+        return false;
+    }
+    return validKitEntries(path, header, index);
+}
+
 } // namespace
 
 namespace SampleManager {
 
 // Helper: Check if sample is already loaded
 bool isLoaded(const char* name) {
-    for (auto& it : loaded) {
-        if (it.name.equals(name)) return true;
+    SampleLock lock;
+    return findLive(name) >= 0;
+}
+
+// Helper: Register a WAV under 'path', reusing cached content or reading it
+// (into 'bank' if given). Any previous sample under that name is released.
+static bool loadAndRegister(const char* path, SampleArena::BankId bank,
+                            LoadProgressFn progress, void* ctx) {
+    if (!SD.exists(path)) {
+        Serial.printf("[SAMPLE] File not found: %s\n", path);
+        return false;
     }
-    return false;
+
+    File f = SD.open(path, FILE_READ);
+    if (!f) {
+        Serial.printf("[SAMPLE] Cannot open %s\n", path);
+        return false;
+    }
+
+    WavInfo info;
+    uint32_t fingerprint = 0;
+    if (!parseWav(f, path, info) || !fingerprintWav(f, info, fingerprint)) {
+        f.close();
+        return false;
+    }
+
+    // 1. Mismo contenido ya en PSRAM (otro kit, otro nombre o en caché)
+    {
+        SampleLock lock;
+        if (findLive(path) >= 0) {
+            f.close();
+            return true;  // Cargado en paralelo por otra tarea
+        }
+        int slot = findContent(fingerprint, info.sampleRate, (uint8_t)info.channels);
+        if (slot >= 0) {
+            f.close();
+            if (!mapName(path, slot, false)) {
+                Serial.printf("[SAMPLE] Name table full (%d names), cannot add %s\n", SAMPLE_MAX_NAMES, path);
+                return false;
+            }
+            cacheHits++;
+            if (progress) progress(info.dataSize, info.dataSize, ctx);
+            Serial.printf("[SAMPLE] Cache hit %s\n", path);
+            return true;
+        }
+        cacheMisses++;
+    }
+
+    // 2. Leer de SD (reserva con sitio para el envolvente detrás del PCM)
+    size_t bytes = info.dataSize;
+    size_t allocBytes = envelopeOffset(bytes) + envelopeBytes(bytes / (info.channels * sizeof(int16_t)));
+    int16_t* buf = (int16_t*)(bank != SampleArena::NO_BANK ? SampleArena::bankAlloc(bank, allocBytes)
+                                                           : allocEvicting(allocBytes));
+    if (!buf) {
+        // Sin fallback a RAM interna: la necesitan el mezclador y las pilas
+        Serial.printf("[SAMPLE] Arena full, cannot load %s (%u bytes, largest free %u)\n",
+                      path, (unsigned)bytes, (unsigned)SampleArena::getStats().largestFreeBlock);
+        f.close();
+        return false;
+    }
+
+    f.seek(info.dataPos);
+    bool complete = readChunked(f, (uint8_t*)buf, bytes, progress, ctx);
+    f.close();
+
+    if (!complete) {
+        Serial.printf("[SAMPLE] Short read %s (%u bytes)\n", path, (unsigned)bytes);
+        // En un banco el hueco se recupera al liberar el banco entero
+        if (bank == SampleArena::NO_BANK) SampleArena::release(buf);
+        return false;
+    }
+
+    Sample s;
+    s.data = buf;
+    s.frames = info.dataSize / (info.channels * sizeof(int16_t));
+    s.sampleRate = info.sampleRate;
+    s.channels = (uint8_t)info.channels;
+
+    // 3. Recortar silencio inicial y cola inaudible; devolver lo sobrante a la arena
+    SampleTrim trim = analyzeSampleTrim(buf, s.frames, s.channels, s.sampleRate);
+    uint32_t kept = applySampleTrim(buf, s.channels, trim);
+    s.trimmedLeadMs = sampleTrimMs(trim.startFrame, s.sampleRate);
+    s.trimmedTailMs = sampleTrimMs(s.frames - trim.endFrame, s.sampleRate);
+    s.frames = kept;
+    bytes = (size_t)kept * s.channels * sizeof(int16_t);
+    buildEnvelope(s, (uint16_t*)((uint8_t*)buf + envelopeOffset(bytes)));
+    bytes = envelopeOffset(bytes) + envelopeBytes(kept);
+    if (bank != SampleArena::NO_BANK) {
+        SampleArena::bankShrinkLast(bank, buf, bytes);
+    } else {
+        SampleArena::shrink(buf, bytes);
+    }
+
+    SampleLock lock;
+    enforceBudget();
+    int slot = allocSlot(s, fingerprint, bytes, bank);
+    if (slot < 0 && evictLRU()) {
+        slot = allocSlot(s, fingerprint, bytes, bank);
+    }
+    if (slot < 0) {
+        Serial.printf("[SAMPLE] Sample table full (%d slots), cannot add %s\n", SAMPLE_MAX_SLOTS, path);
+        if (bank == SampleArena::NO_BANK) SampleArena::release(buf);
+        return false;
+    }
+    if (!mapName(path, slot, false)) {
+        Serial.printf("[SAMPLE] Name table full (%d names), cannot add %s\n", SAMPLE_MAX_NAMES, path);
+        return false;  // El slot queda en caché
+    }
+
+    Serial.printf("[SAMPLE] Loaded %s: %lu frames, %u ch, %lu Hz (trimmed %.1f ms lead, %.1f ms tail)\n",
+                  path, (unsigned long)s.frames, s.channels, (unsigned long)s.sampleRate,
+                  s.trimmedLeadMs, s.trimmedTailMs);
+    return true;
+}
+
+// Helper: Load into a kit bank unless already loaded
+static bool loadIntoBank(const char* path, SampleArena::BankId bank, LoadProgressFn progress, void* ctx) {
+    if (!path || strlen(path) >= SAMPLE_NAME_LEN) return false;
+    if (isLoaded(path)) return true;
+
+    return loadAndRegister(path, bank, progress, ctx);
 }
 
 // Helper: Load a single sample file
-bool loadSample(const char* path) {
+bool loadSample(const char* path, LoadProgressFn progress, void* ctx) {
+    ensureMutex();
+    if (!path || strlen(path) >= SAMPLE_NAME_LEN) return false;
     if (isLoaded(path)) return true; // Already loaded
 
-    Sample s;
-    if (loadWavToPSRAM(path, s)) {
-        loaded.push_back({String(path), s});
-        return true;
+    return loadAndRegister(path, SampleArena::NO_BANK, progress, ctx);
+}
+
+void unloadSample(const char* path) {
+    if (!path) return;
+    ensureMutex();
+    SampleLock lock;
+    int entry = findName(path);
+    if (entry >= 0) {
+        unmapName(entry);
+        enforceBudget();
+    }
+}
+
+size_t loadKitBundle(const char* path, LoadProgressFn progress, void* ctx) {
+    ensureMutex();
+    if (!path || !SD.exists(path)) {
+        Serial.printf("[KIT] Bundle not found: %s\n", path ? path : "(null)");
+        return 0;
+    }
+
+    uint32_t startMs = millis();
+    File f = SD.open(path, FILE_READ);
+    if (!f) {
+        Serial.printf("[KIT] Cannot open %s\n", path);
+        return 0;
+    }
+
+    KitBundleHeader header;
+    std::vector<KitBundleEntry> index;
+    if (!readKitIndex(f, path, header, index)) {
+        f.close();
+        return 0;
+    }
+
+    // 1. Samples ya en PSRAM: se sujetan con una referencia para que no se
+    //    desalojen mientras se lee el resto
+    std::vector<int16_t> hitSlot(index.size(), -1);
+    uint32_t missBytes = 0;     // PCM a leer
+    uint32_t bankBytes = 0;     // PCM + envolventes
+    size_t misses = 0;
+    {
+        SampleLock lock;
+        for (size_t i = 0; i < index.size(); i++) {
+            const KitBundleEntry& e = index[i];
+            int slot = findContent(e.fingerprint, e.sampleRate, e.channels);
+            if (slot >= 0) {
+                hitSlot[i] = slot;
+                slotRefs[slot]++;
+            } else {
+                missBytes += e.bytes;
+                bankBytes += envelopeOffset(e.bytes) + envelopeOffset(envelopeBytes(e.frames));
+                misses++;
+            }
+        }
+        cacheHits += index.size() - misses;
+        cacheMisses += misses;
+
+        while (freeSlotCount() < (int)misses && evictLRU()) {}
+    }
+
+    auto dropHits = [&]() {
+        for (int16_t slot : hitSlot) {
+            if (slot >= 0) slotRefs[slot]--;
+        }
+    };
+
+    if (freeSlotCount() < (int)misses) {
+        Serial.printf("[KIT] Previous kits still playing, cannot load %s yet\n", path);
+        dropHits();
+        f.close();
+        return 0;
+    }
+
+    // 2. Banco nuevo sólo para lo que falta; el kit anterior sigue sonando
+    SampleArena::BankId bank = SampleArena::NO_BANK;
+    if (misses > 0) {
+        bank = openBankEvicting(bankBytes);
+        if (bank == SampleArena::NO_BANK) {
+            // Sin sitio para tener los dos kits a la vez: soltar el anterior
+            // (corta sus voces) y reintentar
+            Serial.println("[KIT] Not enough PSRAM for a live swap, releasing current kit first");
+            {
+                SampleLock lock;
+                unmapKitNames();
+            }
+            AudioEngine::stopAll();
+            vTaskDelay(pdMS_TO_TICKS(20));  // Dejar que el mezclador cierre al menos un bloque
+            bank = openBankEvicting(bankBytes);
+        }
+        if (bank == SampleArena::NO_BANK) {
+            Serial.printf("[KIT] No PSRAM for %s (%u bytes, largest free %u)\n", path,
+                          (unsigned)bankBytes, (unsigned)SampleArena::getStats().largestFreeBlock);
+            dropHits();
+            f.close();
+            return 0;
+        }
+    }
+
+    // Blobs en orden de archivo: lecturas secuenciales grandes alineadas a sector
+    std::vector<Sample> loaded(index.size());
+    ProgressSpan span = {progress, ctx, 0, missBytes};
+    bool complete = true;
+    for (size_t i = 0; i < index.size() && complete; i++) {
+        if (hitSlot[i] >= 0) continue;
+        const KitBundleEntry& e = index[i];
+        uint8_t* dst = (uint8_t*)SampleArena::bankAlloc(bank, e.bytes);
+        uint16_t* env = (uint16_t*)SampleArena::bankAlloc(bank, envelopeBytes(e.frames));
+        complete = dst && env && f.seek(header.dataOffset + e.offset) &&
+                   readChunked(f, dst, e.bytes, spanProgress, &span);
+        span.base += e.bytes;
+        if (!complete) break;
+
+        // Los formatos comprimidos se quedan tal cual en PSRAM; el mezclador
+        // decodifica bloque a bloque (sample_codec.h)
+        if (sampleCodecIsCoded(e.format)) {
+            loaded[i].coded = dst;
+        } else {
+            loaded[i].data = reinterpret_cast<int16_t*>(dst);
+        }
+        loaded[i].format = e.format;
+        loaded[i].frames = e.frames;
+        loaded[i].sampleRate = e.sampleRate;
+        loaded[i].channels = e.channels;
+        loaded[i].trimmedLeadMs = sampleTrimMs(e.trimLeadFrames, e.sampleRate);  // Recortado por el packer
+        buildEnvelope(loaded[i], env);
+    }
+    f.close();
+    if (!complete) {
+        Serial.printf("[KIT] Short read %s\n", path);
+        dropHits();
+        if (bank != SampleArena::NO_BANK) SampleArena::releaseBank(bank);
+        return 0;
+    }
+
+    // 3. Registrar: los nombres del kit anterior se sueltan (sus samples
+    //    pasan a la caché) y se asocian los del kit nuevo
+    size_t registered = 0;
+    {
+        SampleLock lock;
+        unmapKitNames();
+        for (size_t i = 0; i < index.size(); i++) {
+            const KitBundleEntry& e = index[i];
+            char name[KIT_BUNDLE_NAME_LEN + 1];
+            memcpy(name, e.name, KIT_BUNDLE_NAME_LEN);
+            name[KIT_BUNDLE_NAME_LEN] = '\0';
+
+            uint32_t bytes = envelopeOffset(e.bytes) + envelopeBytes(e.frames);
+            int slot = hitSlot[i] >= 0 ? hitSlot[i] : allocSlot(loaded[i], e.fingerprint, bytes, bank);
+            if (slot >= 0 && mapName(name, slot, true)) registered++;
+        }
+        dropHits();
+        if (bank != SampleArena::NO_BANK) finishBank(bank);
+        enforceBudget();
+    }
+
+    uint32_t elapsedMs = millis() - startMs;
+    Serial.printf("[KIT] Loaded '%.*s': %u samples (%u cached), %u KB read in %lu ms (%lu KB/s)\n",
+                  KIT_BUNDLE_KIT_NAME_LEN, header.kitName,
+                  (unsigned)registered, (unsigned)(index.size() - misses),
+                  (unsigned)(missBytes / 1024), (unsigned long)elapsedMs,
+                  (unsigned long)(elapsedMs ? (missBytes / 1024) * 1000 / elapsedMs : 0));
+    return registered;
+}
+
+size_t loadFlashKit() {
+    ensureMutex();
+    uint32_t startMs = millis();
+    const char* path = "flash:" KIT_PARTITION_LABEL;
+
+    if (!flashKitBase) {
+        const esp_partition_t* part = esp_partition_find_first(
+            ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)KIT_PARTITION_SUBTYPE, KIT_PARTITION_LABEL);
+        if (!part) {
+            Serial.println("[KIT] No '" KIT_PARTITION_LABEL "' partition - built-in kit unavailable");
+            return 0;
+        }
+        KitBundleHeader header;
+        if (esp_partition_read(part, 0, &header, sizeof(header)) != ESP_OK) {
+            Serial.printf("[KIT] Cannot read %s\n", path);
+            return 0;
+        }
+        if (header.magic == 0xFFFFFFFFu) {
+            Serial.printf("[KIT] %s is empty (flash a .kit into it)\n", path);
+            return 0;
+        }
+        if (!validKitHeader(path, header, part->size)) return 0;
+
+        const void* mapped = nullptr;
+        if (esp_partition_mmap(part, 0, header.dataOffset + header.dataSize, SPI_FLASH_MMAP_DATA,
+                               &mapped, &flashKitHandle) != ESP_OK) {
+            Serial.printf("[KIT] Cannot map %s (%u bytes)\n", path,
+                          (unsigned)(header.dataOffset + header.dataSize));
+            return 0;
+        }
+        flashKitBase = static_cast<const uint8_t*>(mapped);
+    }
+
+    KitBundleHeader header;
+    memcpy(&header, flashKitBase, sizeof(header));
+    std::vector<KitBundleEntry> index(header.sampleCount);
+    memcpy(index.data(), flashKitBase + header.indexOffset, index.size() * sizeof(KitBundleEntry));
+    if (!validKitEntries(path, header, index)) return 0;
+    const uint8_t* data = flashKitBase + header.dataOffset;
+
+    // Sólo los envolventes van a PSRAM; el audio se queda en flash
+    std::vector<int16_t> hitSlot(index.size(), -1);
+    uint32_t envBytes = 0;
+    size_t misses = 0;
+    {
+        SampleLock lock;
+        for (size_t i = 0; i < index.size(); i++) {
+            const KitBundleEntry& e = index[i];
+            int slot = findContent(e.fingerprint, e.sampleRate, e.channels);
+            if (slot >= 0) {
+                hitSlot[i] = slot;
+                slotRefs[slot]++;
+            } else {
+                envBytes += envelopeOffset(envelopeBytes(e.frames));
+                misses++;
+            }
+        }
+        while (freeSlotCount() < (int)misses && evictLRU()) {}
+    }
+
+    auto dropHits = [&]() {
+        for (int16_t slot : hitSlot) {
+            if (slot >= 0) slotRefs[slot]--;
+        }
+    };
+
+    SampleArena::BankId bank = misses > 0 ? openBankEvicting(envBytes) : SampleArena::NO_BANK;
+    if (freeSlotCount() < (int)misses || (misses > 0 && bank == SampleArena::NO_BANK)) {
+        Serial.printf("[KIT] No room for %s envelopes\n", path);
+        dropHits();
+        if (bank != SampleArena::NO_BANK) SampleArena::releaseBank(bank);
+        return 0;
     }
-    return false;
+
+    std::vector<Sample> loaded(index.size());
+    for (size_t i = 0; i < index.size(); i++) {
+        if (hitSlot[i] >= 0) continue;
+        const KitBundleEntry& e = index[i];
+        const uint8_t* blob = data + e.offset;
+        if (sampleCodecIsCoded(e.format)) {
+            loaded[i].coded = blob;
+        } else {
+            // Sólo lectura: el mezclador nunca escribe en los datos de un sample
+            loaded[i].data = const_cast<int16_t*>(reinterpret_cast<const int16_t*>(blob));
+        }
+        loaded[i].format = e.format;
+        loaded[i].frames = e.frames;
+        loaded[i].sampleRate = e.sampleRate;
+        loaded[i].channels = e.channels;
+        loaded[i].trimmedLeadMs = sampleTrimMs(e.trimLeadFrames, e.sampleRate);
+        uint16_t* env = (uint16_t*)SampleArena::bankAlloc(bank, envelopeBytes(e.frames));
+        if (env) buildEnvelope(loaded[i], env);  // Sin envolvente: nunca se corta por inaudible
+    }
+
+    // Registrar como kit: un bundle de la SD lo reemplaza con loadKitBundle()
+    size_t registered = 0;
+    {
+        SampleLock lock;
+        unmapKitNames();
+        for (size_t i = 0; i < index.size(); i++) {
+            const KitBundleEntry& e = index[i];
+            char name[KIT_BUNDLE_NAME_LEN + 1];
+            memcpy(name, e.name, KIT_BUNDLE_NAME_LEN);
+            name[KIT_BUNDLE_NAME_LEN] = '\0';
+
+            uint32_t bytes = envelopeBytes(e.frames);
+            int slot = hitSlot[i] >= 0 ? hitSlot[i] : allocSlot(loaded[i], e.fingerprint, bytes, bank);
+            if (slot >= 0 && mapName(name, slot, true)) registered++;
+        }
+        dropHits();
+        if (bank != SampleArena::NO_BANK) finishBank(bank);
+        enforceBudget();
+    }
+
+    Serial.printf("[KIT] Built-in '%.*s': %u samples mapped from flash (%u KB, %u KB PSRAM) in %lu ms\n",
+                  KIT_BUNDLE_KIT_NAME_LEN, header.kitName, (unsigned)registered,
+                  (unsigned)(header.dataSize / 1024), (unsigned)(envBytes / 1024),
+                  (unsigned long)(millis() - startMs));
+    return registered;
 }
 
-size_t beginAndLoadDefaults() {
-#if USE_EMBEDDED_SAMPLES
-    Serial.println("[SAMPLE] Embedded samples enabled");
-    return 0;
-#else
-    Serial.printf("[SYSTEM] Free Heap: %d, Free PSRAM: %d\n", ESP.getFreeHeap(), ESP.getFreePsram());
+bool mountCard() {
+    ensureMutex();
+    negotiatedClockHz = 0;
 
     // Asegurar estado inicial de pines SPI
     pinMode(SD_CS_PIN, OUTPUT);
@@ -161,59 +972,220 @@ size_t beginAndLoadDefaults() {
 
     // Inicializar SPI explícitamente
     SPI.begin(SD_SCK_PIN, SD_MISO_PIN, SD_MOSI_PIN, SD_CS_PIN);
-    
-    // Intentar montar SD con frecuencia segura (4MHz)
-    if (!SD.begin(SD_CS_PIN, SPI, 4000000, "/sd")) {
+
+    // Referencia: montar con frecuencia segura y leer los sectores de prueba
+    uint16_t reference[SD_PROBE_SECTORS];
+    bool safeMounted = mountAt(SD_SAFE_CLOCK_HZ);
+    if (safeMounted) probeBaseSector = findProbeBase();
+    if (!safeMounted || !probeSectors(reference)) {
         Serial.println("[SD] init failed! Retrying with lower frequency...");
         delay(100);
-        if (!SD.begin(SD_CS_PIN, SPI, 1000000, "/sd")) {
-             Serial.println("[SD] init failed again. Check wiring/card.");
-             return 0;
+        if (!mountAt(SD_FALLBACK_CLOCK_HZ)) {
+            Serial.println("[SD] init failed again. Check wiring/card.");
+            return false;
         }
+        negotiatedClockHz = SD_FALLBACK_CLOCK_HZ;
+        Serial.printf("[SD] Card initialized at %lu kHz (fallback)\n", (unsigned long)(negotiatedClockHz / 1000));
+        return true;
     }
-    Serial.println("[SD] Card initialized.");
-    Serial.printf("[SYSTEM] Post-SD Heap: %d, Free PSRAM: %d\n", ESP.getFreeHeap(), ESP.getFreePsram());
 
-    loaded.clear();
-    
-    // Load samples requested by Pad Configuration
+    for (uint32_t hz : SD_CLOCK_CANDIDATES_HZ) {
+        if (verifyClock(hz, reference)) {
+            negotiatedClockHz = hz;
+            break;
+        }
+        Serial.printf("[SD] %lu kHz rejected (mount or CRC mismatch)\n", (unsigned long)(hz / 1000));
+    }
+
+    if (negotiatedClockHz == 0) {
+        if (!mountAt(SD_SAFE_CLOCK_HZ)) {
+            Serial.println("[SD] Remount at safe clock failed");
+            return false;
+        }
+        negotiatedClockHz = SD_SAFE_CLOCK_HZ;
+    }
+
+    Serial.printf("[SD] Card initialized at %lu kHz\n", (unsigned long)(negotiatedClockHz / 1000));
+    return true;
+}
+
+uint32_t cardClockHz() {
+    return negotiatedClockHz;
+}
+
+size_t loadDefaults(LoadProgressFn progress, void* ctx) {
+    // Kit bundle first: one sequential read for the whole kit
+    if (SD.exists(KIT_BUNDLE_DEFAULT_PATH)) {
+        loadKitBundle(KIT_BUNDLE_DEFAULT_PATH, progress, ctx);
+    }
+
+    // Load samples requested by Pad Configuration (skips those already in the bundle)
+    // into one bank, so the whole set is packed together and freed together
     Serial.println("[SAMPLE] Loading samples defined in PadConfig...");
-    
+    SampleArena::BankId bank = SampleArena::openBank();
+
     for (int i = 0; i < NUM_PADS; ++i) {
         PadConfig& cfg = PadConfigManager::getConfig(i);
-        
+
         // Ensure sample name is not empty
         if (strlen(cfg.sampleName) > 0) {
             Serial.printf("[SAMPLE] Pad %d needs: %s\n", i, cfg.sampleName);
-            if (!loadSample(cfg.sampleName)) {
+            if (!loadIntoBank(cfg.sampleName, bank, progress, ctx)) {
                 Serial.printf("[SAMPLE] Failed to load %s for Pad %d\n", cfg.sampleName, i);
             }
         }
-        
+
         // Also load rim samples if dual zone enabled
         if (cfg.dualZoneEnabled && strlen(cfg.rimSampleName) > 0) {
-            if (!loadSample(cfg.rimSampleName)) {
+            if (!loadIntoBank(cfg.rimSampleName, bank, progress, ctx)) {
                 Serial.printf("[SAMPLE] Failed to load rim %s for Pad %d\n", cfg.rimSampleName, i);
             }
         }
     }
-    
-    Serial.printf("[SAMPLE] Total loaded unique samples: %u\n", (unsigned)loaded.size());
-    return loaded.size();
-#endif
+
+    if (bank != SampleArena::NO_BANK) {
+        SampleLock lock;
+        finishBank(bank);
+    }
+
+    size_t count = loadedCount();
+    Serial.printf("[SAMPLE] Total loaded unique samples: %u\n", (unsigned)count);
+    SampleArena::printStats();
+    return count;
 }
 
 
 const Sample* getSample(const char* name) {
     if (!name) return nullptr;
-    for (auto& it : loaded) {
-        if (it.name.equals(name)) return &it.sample;
-    }
-    return nullptr;
+    ensureMutex();
+    SampleLock lock;
+    int slot = findLive(name);
+    return slot >= 0 ? &slotSamples[slot] : nullptr;
+}
+
+const Sample* acquireSample(const char* name) {
+    if (!name) return nullptr;
+    ensureMutex();
+    SampleLock lock;
+    int slot = findLive(name);
+    if (slot < 0) return nullptr;
+    slotRefs[slot]++;
+    touch(slot);
+    return &slotSamples[slot];
+}
+
+void releaseSample(const Sample* sample) {
+    if (sample < slotSamples || sample >= slotSamples + SAMPLE_MAX_SLOTS) return;
+    slotRefs[sample - slotSamples]--;
+}
+
+size_t collectGarbage() {
+    if (!samplesMutex) return 0;
+    SampleLock lock;
+    return enforceBudget();
 }
 
 size_t loadedCount() {
-    return loaded.size();
+    ensureMutex();
+    SampleLock lock;
+    size_t count = 0;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (slotMeta[i].state == SLOT_USED && slotMeta[i].names > 0) count++;
+    }
+    return count;
+}
+
+size_t retiredCount() {
+    ensureMutex();
+    SampleLock lock;
+    size_t count = 0;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (isCached(i) && slotRefs[i] > 0) count++;
+    }
+    return count;
+}
+
+void setCacheBudget(uint32_t bytes) {
+    ensureMutex();
+    SampleLock lock;
+    cacheBudget = bytes;
+    enforceBudget();
+}
+
+CacheStats getCacheStats() {
+    ensureMutex();
+    SampleLock lock;
+    CacheStats stats = {};
+    stats.hits = cacheHits;
+    stats.misses = cacheMisses;
+    stats.evictions = cacheEvictions;
+    stats.budgetBytes = cacheBudget;
+    for (int i = 0; i < SAMPLE_MAX_SLOTS; i++) {
+        if (slotMeta[i].state != SLOT_USED) continue;
+        if (slotMeta[i].names > 0) {
+            stats.pinnedSamples++;
+            stats.pinnedBytes += slotMeta[i].bytes;
+        } else {
+            stats.cachedSamples++;
+            stats.cachedBytes += slotMeta[i].bytes;
+        }
+    }
+    return stats;
+}
+
+void printTrimReport() {
+    ensureMutex();
+
+    // Copiar bajo el lock e imprimir fuera: a 115200 baudios el informe
+    // tarda decenas de ms y acquireSample() (AudioEngine::play) esperaría
+    struct Row {
+        char name[SAMPLE_NAME_LEN];
+        uint32_t frames;
+        uint8_t format;         // KitSampleFormat
+        float leadMs;
+        float tailMs;
+    };
+    static Row rows[SAMPLE_MAX_NAMES];
+    int named = 0;
+    {
+        SampleLock lock;
+        for (int i = 0; i < SAMPLE_MAX_NAMES; i++) {
+            if (nameTable[i].slot < 0) continue;
+            const Sample& s = slotSamples[nameTable[i].slot];
+            Row& row = rows[named++];
+            strncpy(row.name, nameTable[i].name, sizeof(row.name) - 1);
+            row.name[sizeof(row.name) - 1] = '\0';
+            row.frames = s.frames;
+            row.format = s.format;
+            row.leadMs = s.trimmedLeadMs;
+            row.tailMs = s.trimmedTailMs;
+        }
+    }
+
+    Serial.println("[SAMPLE] Loaded samples (lead = latency recovered):");
+    float totalLead = 0;
+    for (int i = 0; i < named; i++) {
+        const Row& row = rows[i];
+        Serial.printf("  %-40s %7lu frames  %-5s  lead %5.1f ms  tail %6.1f ms\n",
+                      row.name, (unsigned long)row.frames, sampleCodecName(row.format),
+                      row.leadMs, row.tailMs);
+        totalLead += row.leadMs;
+    }
+    if (named > 0) {
+        Serial.printf("  Average lead trimmed: %.2f ms\n", totalLead / named);
+    }
+}
+
+void printCacheStats() {
+    CacheStats s = getCacheStats();
+    uint32_t lookups = s.hits + s.misses;
+    Serial.printf("[SAMPLE] Cache: %u hits / %u misses (%u%% hit), %u evictions\n",
+                  (unsigned)s.hits, (unsigned)s.misses,
+                  (unsigned)(lookups ? s.hits * 100 / lookups : 0), (unsigned)s.evictions);
+    Serial.printf("[SAMPLE] Pinned %u samples (%u KB), cached %u samples (%u / %u KB budget)\n",
+                  (unsigned)s.pinnedSamples, (unsigned)(s.pinnedBytes / 1024),
+                  (unsigned)s.cachedSamples, (unsigned)(s.cachedBytes / 1024),
+                  (unsigned)(s.budgetBytes / 1024));
 }
 
 } // namespace SampleManager
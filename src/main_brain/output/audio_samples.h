@@ -2,39 +2,120 @@
 #define AUDIO_SAMPLES_H
 
 #include <Arduino.h>
+#include "kit_bundle.h"
 
-// SD.h only needed when not using embedded samples
-#ifndef USE_EMBEDDED_SAMPLES
 #include <SD.h>
-#endif
 
 struct Sample {
-    int16_t* data = nullptr;   // PCM signed 16-bit
+    int16_t* data = nullptr;   // PCM signed 16-bit (format KIT_FORMAT_PCM16)
+    const uint8_t* coded = nullptr; // Bloques comprimidos en PSRAM (sample_codec.h), si no es PCM16
+    uint8_t format = KIT_FORMAT_PCM16; // KitSampleFormat
     uint32_t frames = 0;       // frames = samples per channel
     uint32_t sampleRate = 44100;
     uint8_t channels = 1;      // 1=mono, 2=stereo
+    float trimmedLeadMs = 0;   // Silencio inicial recortado al cargar (latencia recuperada)
+    float trimmedTailMs = 0;   // Cola inaudible recortada al cargar
+    // Envolvente calculado al cargar: por cada bloque de SAMPLE_ENVELOPE_BLOCK
+    // frames, el RMS máximo desde ese bloque hasta el final (nunca sube)
+    const uint16_t* envelope = nullptr;
+    uint32_t envelopeBlocks = 0;
 };
 
+#define SAMPLE_ENVELOPE_BLOCK 256   // Frames por valor de envolvente (= bloque del mezclador)
+
+#define SAMPLE_MAX_SLOTS 96         // Samples en PSRAM (fijados + en caché)
+#define SAMPLE_MAX_NAMES 96         // Nombres/rutas registrados (varios pueden compartir sample)
+#define SAMPLE_NAME_LEN  64         // Ruta/nombre máximo (incluye '\0')
+#define SAMPLE_CACHE_BUDGET_BYTES (4 * 1024 * 1024)  // Caché de samples no usados por defecto
+
 namespace SampleManager {
 
-// Inicializa samples (embebidos o desde SD) y los carga.
-// @return número de samples cargados correctamente.
-size_t beginAndLoadDefaults();
+// Callback de progreso de lectura (bytes leídos / total del archivo en curso).
+// Se invoca desde el contexto que hace la carga (p.ej. la tarea SampleLoader).
+typedef void (*LoadProgressFn)(uint32_t bytesDone, uint32_t bytesTotal, void* ctx);
+
+// Caché de samples por contenido: un sample sin nombres (descargado o de un
+// kit anterior) se queda en PSRAM hasta que el LRU lo desaloja, y se reutiliza
+// sin leer la SD si se vuelve a pedir el mismo contenido con cualquier nombre.
+struct CacheStats {
+    uint32_t hits;             // Cargas resueltas sin leer PCM de la SD
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t pinnedSamples;    // Con nombre (kit activo, PadConfig): nunca se desalojan
+    uint32_t pinnedBytes;
+    uint32_t cachedSamples;    // Sin nombre, desalojables
+    uint32_t cachedBytes;
+    uint32_t budgetBytes;
+};
+
+// Monta la tarjeta SD negociando el reloj SPI más alto que lee sin errores:
+// cada candidato debe devolver los mismos CRC de sector que la lectura a
+// SD_SAFE_CLOCK_HZ. Si falla, cae a SD_SAFE_CLOCK_HZ / SD_FALLBACK_CLOCK_HZ.
+// @return true si la tarjeta quedó montada
+bool mountCard();
+
+// Frecuencia SPI negociada en Hz (0 si la tarjeta no está montada)
+uint32_t cardClockHz();
+
+// Carga el kit bundle por defecto y los samples de PadConfig (requiere mountCard()).
+// @return número de samples cargados
+size_t loadDefaults(LoadProgressFn progress = nullptr, void* ctx = nullptr);
 
 // Busca un sample cargado por nombre (ruta).
+// El puntero es estable (tabla fija) pero sólo garantiza datos válidos mientras
+// el sample no se descargue; para reproducir usar acquireSample().
 const Sample* getSample(const char* name);
 
+// Busca un sample y toma una referencia: sus datos no se liberan hasta
+// releaseSample(), aunque se descargue o se cambie de kit mientras suena.
+const Sample* acquireSample(const char* name);
+
+// Suelta una referencia tomada con acquireSample() (seguro desde el mezclador)
+void releaseSample(const Sample* sample);
+
+// Desaloja samples en caché (LRU) que ya no suenan hasta cumplir el presupuesto.
+// @return número de samples liberados
+size_t collectGarbage();
+
+// Samples sin nombre que aún tienen voces sonando
+size_t retiredCount();
+
+// Presupuesto en bytes para samples en caché (no cuenta los fijados)
+void setCacheBudget(uint32_t bytes);
+
+CacheStats getCacheStats();
+
+void printCacheStats();
+
+// Lista los samples cargados con el silencio/cola recortados a cada uno
+void printTrimReport();
+
 // Cantidad de samples actualmente cargados
 size_t loadedCount();
 
 // Carga o recarga un sample específico desde SD
 // @param path Ruta del archivo WAV en SD
 // @return true si se cargó correctamente
-bool loadSample(const char* path);
+bool loadSample(const char* path, LoadProgressFn progress = nullptr, void* ctx = nullptr);
 
-// Descarga un sample de memoria
+// Descarga un sample. Deja de encontrarse al instante y pasa a la caché; su
+// memoria se libera por LRU cuando ya no suena (collectGarbage()).
 void unloadSample(const char* path);
 
+// Carga un kit completo desde un bundle .kit (ver kit_bundle.h).
+// Reutiliza los samples que ya están en PSRAM (por huella de contenido), lee
+// el resto con lecturas secuenciales grandes a un único banco de la arena y
+// reemplaza el bundle cargado anteriormente sin cortar las voces que suenan.
+// @return número de samples registrados (0 si falla)
+size_t loadKitBundle(const char* path, LoadProgressFn progress = nullptr, void* ctx = nullptr);
+
+// Registra el kit integrado de la partición KIT_PARTITION_LABEL (mismo formato
+// que un .kit). El audio se lee directamente de flash a través de la caché
+// (esp_partition_mmap): no necesita SD ni copia en PSRAM, sólo los envolventes.
+// Un bundle cargado después desde la SD lo reemplaza como kit activo.
+// @return número de samples registrados (0 si no hay partición o está vacía)
+size_t loadFlashKit();
+
 } // namespace SampleManager
 
 #endif // AUDIO_SAMPLES_H
\ No newline at end of file
@@ -12,13 +12,100 @@
 #include "esp32-hal-tinyusb.h"
 #include "tusb.h"
 #include "class/midi/midi_device.h"
+#include <edrum_config.h>
+#include "../core/spsc_ring.h"
 
 namespace MIDIController {
 
 static bool initialized = false;
-constexpr uint8_t MAX_NOTE_OFFS = 16;
-static NoteOffEvent noteOffQueue[MAX_NOTE_OFFS];
-static uint8_t noteOffCount = 0;
+
+// ============================================================
+// NOTE-OFFS: RUEDA DE TEMPORIZACIÓN
+// ============================================================
+// Rueda hash de 64 ranuras de 1 ms. Hay un nodo fijo por (canal, nota):
+// redisparar una nota mueve su note-off en O(1) en lugar de ocupar otra
+// entrada, así que no hay límite de note-offs pendientes que perder en
+// redobles densos. Un note-off con más de 64 ms de espera da varias vueltas
+// a la rueda; cada visita compara la hora con resta con signo (a prueba
+// del desbordamiento de millis()).
+
+constexpr uint16_t WHEEL_SLOTS = 64;
+constexpr uint16_t WHEEL_MASK  = WHEEL_SLOTS - 1;
+constexpr uint16_t WHEEL_NODES = 16 * 128;     // Canal × nota
+constexpr uint16_t WHEEL_NIL   = 0xFFFF;
+
+struct WheelNode {
+    uint32_t offTime;
+    uint16_t next;
+    uint16_t prev;
+};
+
+static WheelNode wheelNodes[WHEEL_NODES];
+static uint16_t wheelHeads[WHEEL_SLOTS];
+static uint32_t wheelScheduled[WHEEL_NODES / 32];  // Bit por nodo enlazado
+static uint32_t wheelTick = 0;                      // Último ms procesado
+
+// ============================================================
+// LOTES USB
+// ============================================================
+// Los mensajes de una misma trama USB (1 ms) se acumulan y se escriben con
+// una sola llamada a tud_midi_stream_write: TinyUSB los mete en la FIFO y
+// lanza una única transferencia bulk de hasta 64 bytes (16 eventos USB-MIDI).
+
+constexpr uint8_t USB_MIDI_EP_BYTES = 64;
+constexpr uint8_t BATCH_MESSAGES    = USB_MIDI_EP_BYTES / 4;
+constexpr uint8_t BATCH_BYTES       = BATCH_MESSAGES * 3;
+
+static uint8_t batch[BATCH_BYTES];
+static uint32_t batchStamps[BATCH_MESSAGES];  // micros() de encolado de cada mensaje
+static uint8_t batchLen = 0;           // Bytes pendientes
+static uint8_t batchMessages = 0;      // Mensajes pendientes (el primero puede ir a medias)
+static uint8_t batchSkew = 0;          // Bytes del primer mensaje ya aceptados por TinyUSB
+static uint32_t batchFrame = 0;        // Trama USB (ms) de la última escritura
+static uint8_t packetsThisFrame = 0;
+
+// ============================================================
+// ANILLO PRODUCTOR → TAREA MIDI
+// ============================================================
+// El productor (el suscriptor MIDI del bus de eventos) solo encola, sin
+// mutex ni llamadas a TinyUSB, y avisa a la tarea; la rueda, el lote y
+// TinyUSB son exclusivos de la tarea MIDI, así que el tiempo que tarde
+// loop() en UI y UART ya no mueve los mensajes al DAW.
+
+struct MidiEvent {
+    uint32_t enqueueUs;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+};
+
+static SpscRing<MidiEvent, QUEUE_SIZE_MIDI_EVENTS> ring;
+static TaskHandle_t consumerTask = nullptr;
+static std::atomic<bool> resetRequested{false};
+static std::atomic<uint32_t> ringDropped{0};   // Lo escribe el productor
+static bool hiResVelocity = MIDI_HIRES_VELOCITY_DEFAULT;
+
+// ============================================================
+// ENTRADA: MÓDULO DE SONIDO Y RELOJ
+// ============================================================
+// TinyUSB marca la llegada en tud_midi_rx_cb (tarea USB) y despierta a la
+// tarea MIDI, que lee los paquetes y arranca la voz en el acto. La latencia
+// se mide desde esa marca hasta que el handler vuelve.
+
+static NoteInputHandler noteHandler = nullptr;
+static volatile bool soundModuleEnabled = MIDI_INPUT_SOUND_MODULE_DEFAULT;
+static std::atomic<bool> rxPending{false};
+static std::atomic<uint32_t> rxStampUs{0};
+static uint8_t hiResPrefix[16];                // CC88 recibido por canal, 0xFF = ninguno
+
+constexpr uint8_t MIDI_CLOCKS_PER_BEAT = 24;
+static uint8_t clockTicks = 0;
+static uint32_t beatStartUs = 0;
+static std::atomic<uint32_t> lastClockUs{0};
+static std::atomic<uint16_t> bpmX10{0};
+static std::atomic<bool> transportRunning{false};
+
+static Stats stats = {};
 
 // Descriptor callback para la interfaz MIDI (TinyUSB)
 extern "C" uint16_t tud_midi_desc_cb(uint8_t* dst, uint8_t* itf) {
@@ -34,10 +121,288 @@ extern "C" uint16_t tud_midi_desc_cb(uint8_t* dst, uint8_t* itf) {
     return TUD_MIDI_DESC_LEN;
 }
 
+// Datos MIDI recibidos (tarea USB de TinyUSB)
+extern "C" void tud_midi_rx_cb(uint8_t itf) {
+    (void)itf;
+    if (!rxPending.exchange(true)) rxStampUs.store(static_cast<uint32_t>(micros()));
+    TaskHandle_t task = consumerTask;
+    if (task) xTaskNotifyGive(task);
+}
+
 static uint8_t clampChannel(uint8_t ch) {
     return (ch < 1) ? 1 : ((ch > 16) ? 16 : ch);
 }
 
+// ------------------------------------------------------------
+// Lote de salida
+// ------------------------------------------------------------
+
+static void countPacket() {
+    uint32_t frame = millis();
+    if (frame != batchFrame) {
+        batchFrame = frame;
+        packetsThisFrame = 0;
+    }
+    packetsThisFrame++;
+    if (packetsThisFrame > stats.maxPacketsPerFrame) stats.maxPacketsPerFrame = packetsThisFrame;
+    stats.packets++;
+}
+
+// Devuelve true si el lote quedó vacío
+static bool flushBatch() {
+    if (batchLen == 0) return true;
+    if (!isConnected()) {
+        batchLen = 0;
+        batchMessages = 0;
+        batchSkew = 0;
+        return true;
+    }
+
+    uint32_t written = tud_midi_stream_write(0, batch, batchLen);
+    if (written == 0) return false;  // FIFO llena: la tarea reintenta en el siguiente tick
+    countPacket();
+
+    // TinyUSB puede aceptar un mensaje a medias; lo completa en la siguiente llamada
+    uint32_t consumed = batchSkew + written;
+    uint8_t done = static_cast<uint8_t>(consumed / 3);
+    uint32_t nowUs = micros();
+    for (uint8_t i = 0; i < done; i++) {
+        uint32_t latency = nowUs - batchStamps[i];
+        stats.totalLatencyUs += latency;
+        if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+    }
+    stats.messages += done;
+    if (done > stats.maxPerPacket) stats.maxPerPacket = done;
+
+    batchMessages -= done;
+    batchSkew = static_cast<uint8_t>(consumed % 3);
+    batchLen -= static_cast<uint8_t>(written);
+    if (batchLen == 0) {
+        batchMessages = 0;
+        batchSkew = 0;
+        return true;
+    }
+    memmove(batch, batch + written, batchLen);
+    memmove(batchStamps, batchStamps + done, batchMessages * sizeof(batchStamps[0]));
+    return false;
+}
+
+static inline bool batchHasRoom() {
+    return batchLen + 3 <= BATCH_BYTES;
+}
+
+static void queueMessage(uint8_t status, uint8_t data1, uint8_t data2, uint32_t enqueueUs) {
+    if (!batchHasRoom()) {
+        flushBatch();
+        if (!batchHasRoom()) {
+            stats.dropped++;
+            return;
+        }
+    }
+    batchStamps[batchMessages++] = enqueueUs;
+    batch[batchLen++] = status;
+    batch[batchLen++] = data1 & 0x7F;
+    batch[batchLen++] = data2 & 0x7F;
+}
+
+// ------------------------------------------------------------
+// Rueda de note-offs
+// ------------------------------------------------------------
+
+static inline uint16_t nodeIndex(uint8_t ch, uint8_t note) {
+    return static_cast<uint16_t>((ch - 1) * 128 + (note & 0x7F));
+}
+
+static inline bool isScheduled(uint16_t n) {
+    return wheelScheduled[n >> 5] & (1u << (n & 31));
+}
+
+static void unlinkNode(uint16_t n) {
+    WheelNode& node = wheelNodes[n];
+    if (node.prev != WHEEL_NIL) {
+        wheelNodes[node.prev].next = node.next;
+    } else {
+        wheelHeads[node.offTime & WHEEL_MASK] = node.next;
+    }
+    if (node.next != WHEEL_NIL) wheelNodes[node.next].prev = node.prev;
+    wheelScheduled[n >> 5] &= ~(1u << (n & 31));
+    stats.pending--;
+}
+
+static void scheduleNoteOff(uint8_t ch, uint8_t note, uint32_t offTime) {
+    uint16_t n = nodeIndex(ch, note);
+    if (isScheduled(n)) {
+        unlinkNode(n);
+        stats.retriggers++;
+    }
+    // Nunca en una ranura ya recorrida
+    if (static_cast<int32_t>(offTime - wheelTick) <= 0) offTime = wheelTick + 1;
+
+    WheelNode& node = wheelNodes[n];
+    uint16_t& head = wheelHeads[offTime & WHEEL_MASK];
+    node.offTime = offTime;
+    node.prev = WHEEL_NIL;
+    node.next = head;
+    if (head != WHEEL_NIL) wheelNodes[head].prev = n;
+    head = n;
+    wheelScheduled[n >> 5] |= 1u << (n & 31);
+
+    stats.pending++;
+    if (stats.pending > stats.maxPending) stats.maxPending = stats.pending;
+}
+
+static void cancelNoteOff(uint8_t ch, uint8_t note) {
+    uint16_t n = nodeIndex(ch, note);
+    if (isScheduled(n)) unlinkNode(n);
+}
+
+static void expireNoteOffs(uint32_t now) {
+    if (stats.pending == 0) {
+        wheelTick = now;
+        return;
+    }
+
+    // Tras un parón de más de una vuelta basta con recorrer cada ranura una vez
+    uint32_t steps = now - wheelTick;
+    if (steps > WHEEL_SLOTS) steps = WHEEL_SLOTS;
+
+    for (uint32_t i = 1; i <= steps; i++) {
+        uint16_t n = wheelHeads[(wheelTick + i) & WHEEL_MASK];
+        while (n != WHEEL_NIL) {
+            uint16_t next = wheelNodes[n].next;
+            int32_t late = static_cast<int32_t>(now - wheelNodes[n].offTime);
+            if (late >= 0) {
+                unlinkNode(n);
+                uint8_t ch = static_cast<uint8_t>(n / 128);
+                queueMessage(static_cast<uint8_t>(0x80 | ch), static_cast<uint8_t>(n & 0x7F), 0, micros());
+                stats.noteOffs++;
+                stats.totalLatenessMs += static_cast<uint32_t>(late);
+                if (static_cast<uint32_t>(late) > stats.maxLatenessMs) stats.maxLatenessMs = late;
+            }
+            n = next;
+        }
+    }
+    wheelTick = now;
+}
+
+// ------------------------------------------------------------
+// Entrada
+// ------------------------------------------------------------
+
+static void handleClock(uint8_t status, uint32_t rxUs) {
+    switch (status) {
+        case 0xFA:  // Start
+        case 0xFB:  // Continue
+            transportRunning = true;
+            clockTicks = 0;
+            break;
+        case 0xFC:  // Stop
+            transportRunning = false;
+            break;
+        case 0xF8: {
+            // Tempo por pulsos de negra: 24 relojes medidos de punta a punta
+            uint32_t last = lastClockUs.exchange(rxUs);
+            if (rxUs - last > MIDI_CLOCK_TIMEOUT_MS * 1000UL) clockTicks = 0;
+            if (clockTicks == 0) beatStartUs = rxUs;
+            if (++clockTicks > MIDI_CLOCKS_PER_BEAT) {
+                uint32_t beatUs = rxUs - beatStartUs;
+                uint32_t measured = beatUs ? 600000000UL / beatUs : 0;
+                if (measured >= 100 && measured <= 9999) {  // 10-999.9 BPM
+                    uint16_t previous = bpmX10.load();
+                    // Suavizado 1/4: el jitter de tramas USB (1 ms) no hace bailar la cifra
+                    bpmX10 = static_cast<uint16_t>(previous ? (previous * 3 + measured + 2) / 4 : measured);
+                }
+                beatStartUs = rxUs;
+                clockTicks = 1;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void handleNoteInput(uint8_t channel, uint8_t note, uint8_t velocity, uint32_t rxUs) {
+    uint16_t velocityHiRes = 0;
+    if (hiResPrefix[channel] != 0xFF) {
+        velocityHiRes = static_cast<uint16_t>((velocity << 9) | (hiResPrefix[channel] << 2));
+        hiResPrefix[channel] = 0xFF;
+    }
+
+    NoteInputHandler handler = noteHandler;
+    if (!soundModuleEnabled || !handler || !handler(channel + 1, note, velocity, velocityHiRes)) {
+        stats.inputIgnored++;
+        return;
+    }
+
+    uint32_t latency = static_cast<uint32_t>(micros()) - rxUs;
+    stats.inputNotes++;
+    stats.totalInputLatencyUs += latency;
+    if (latency > stats.maxInputLatencyUs) stats.maxInputLatencyUs = latency;
+}
+
+static void serviceInput() {
+    // Bajar la marca antes de leer: lo que llegue durante la lectura vuelve a marcar
+    if (!rxPending.exchange(false)) return;
+    uint32_t rxUs = rxStampUs.load();
+
+    uint8_t packet[4];
+    while (tud_midi_packet_read(packet)) {
+        uint8_t status = packet[1];
+        if (status >= 0xF8) {
+            handleClock(status, rxUs);
+            continue;
+        }
+        uint8_t channel = status & 0x0F;
+        switch (status & 0xF0) {
+            case 0x90:
+                if (packet[3] > 0) {
+                    handleNoteInput(channel, packet[2] & 0x7F, packet[3] & 0x7F, rxUs);
+                    break;
+                }
+                hiResPrefix[channel] = 0xFF;  // Note-on con velocity 0 = note-off
+                break;
+            case 0xB0:
+                if (packet[2] == MIDI_CC_HIRES_VELOCITY) hiResPrefix[channel] = packet[3] & 0x7F;
+                break;
+            default:
+                break;  // Note-offs: las voces son one-shot
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// API
+// ------------------------------------------------------------
+
+// Mensaje del anillo, ya en la tarea MIDI
+static void handleEvent(const MidiEvent& ev) {
+    uint8_t type = ev.status & 0xF0;
+    uint8_t ch = static_cast<uint8_t>((ev.status & 0x0F) + 1);
+    if (type == 0x90) {
+        scheduleNoteOff(ch, ev.data1, millis() + NOTE_OFF_DURATION);
+    } else if (type == 0x80) {
+        cancelNoteOff(ch, ev.data1);  // Un note-off explícito sustituye al programado
+    }
+    queueMessage(ev.status, ev.data1, ev.data2, ev.enqueueUs);
+}
+
+static void post(uint8_t status, uint8_t data1, uint8_t data2) {
+    if (!isConnected()) return;
+
+    MidiEvent ev = { static_cast<uint32_t>(micros()), status, static_cast<uint8_t>(data1 & 0x7F), static_cast<uint8_t>(data2 & 0x7F) };
+    if (!ring.push(ev)) {
+        ringDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TaskHandle_t task = consumerTask;
+    if (task) xTaskNotifyGive(task);
+}
+
+// ------------------------------------------------------------
+// API
+// ------------------------------------------------------------
+
 void begin() {
     if (initialized) return;
 
@@ -55,12 +420,21 @@ void begin() {
         delay(20);
     }
 
+    for (uint16_t i = 0; i < WHEEL_SLOTS; i++) wheelHeads[i] = WHEEL_NIL;
+    memset(wheelScheduled, 0, sizeof(wheelScheduled));
+    wheelTick = millis();
+    batchLen = 0;
+    batchMessages = 0;
+    batchSkew = 0;
+    stats = {};
+    memset(hiResPrefix, 0xFF, sizeof(hiResPrefix));
     initialized = true;
-    noteOffCount = 0;
 
     Serial.println("[MIDI] USB MIDI initialized (USB native)");
     Serial.printf("[MIDI] Device mounted: %s\n", tud_midi_mounted() ? "Yes" : "No");
     Serial.printf("[MIDI] Default channel: %d\n", MIDI_CHANNEL);
+    Serial.printf("[MIDI] High-res velocity (CC%d): %s\n", MIDI_CC_HIRES_VELOCITY, hiResVelocity ? "on" : "off");
+    Serial.printf("[MIDI] Sound module (MIDI in -> kit): %s\n", soundModuleEnabled ? "on" : "off");
 }
 
 void sendNoteOn(uint8_t note, uint8_t velocity) {
@@ -68,23 +442,39 @@ void sendNoteOn(uint8_t note, uint8_t velocity) {
 }
 
 void sendNoteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
-    if (!isConnected()) return;
+    post(static_cast<uint8_t>(0x90 | ((clampChannel(channel) - 1) & 0x0F)), note, velocity);
+}
 
-    uint8_t ch = clampChannel(channel);
-    uint8_t msg[3] = {
-        static_cast<uint8_t>(0x90 | ((ch - 1) & 0x0F)),
-        static_cast<uint8_t>(note & 0x7F),
-        static_cast<uint8_t>(velocity & 0x7F)
-    };
-    tud_midi_stream_write(0, msg, sizeof(msg));
+void sendNoteOnHiRes(uint8_t note, uint16_t velocityHiRes) {
+    sendNoteOnHiRes(MIDI_CHANNEL, note, velocityHiRes);
+}
 
-    if (noteOffCount < MAX_NOTE_OFFS) {
-        noteOffQueue[noteOffCount++] = {
-            static_cast<uint8_t>(note & 0x7F),
-            ch,
-            millis() + NOTE_OFF_DURATION
-        };
+void sendNoteOnHiRes(uint8_t channel, uint8_t note, uint16_t velocityHiRes) {
+    uint8_t velocity = velocityHiRes >> 9;
+    if (velocity == 0) velocity = 1;
+    if (!hiResVelocity) {
+        sendNoteOn(channel, note, velocity);
+        return;
     }
+    if (!isConnected()) return;
+
+    // Prefijo y note-on entran juntos en el anillo (y en el mismo lote USB):
+    // un prefijo huérfano cambiaría la velocity de la siguiente nota
+    if (ring.size() + 2 > ring.capacity()) {
+        ringDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint8_t ch = (clampChannel(channel) - 1) & 0x0F;
+    post(static_cast<uint8_t>(0xB0 | ch), MIDI_CC_HIRES_VELOCITY, (velocityHiRes >> 2) & 0x7F);
+    post(static_cast<uint8_t>(0x90 | ch), note, velocity);
+}
+
+void setHighResVelocity(bool enabled) {
+    hiResVelocity = enabled;
+}
+
+bool highResVelocity() {
+    return hiResVelocity;
 }
 
 void sendNoteOff(uint8_t note) {
@@ -92,15 +482,7 @@ void sendNoteOff(uint8_t note) {
 }
 
 void sendNoteOff(uint8_t channel, uint8_t note) {
-    if (!isConnected()) return;
-
-    uint8_t ch = clampChannel(channel);
-    uint8_t msg[3] = {
-        static_cast<uint8_t>(0x80 | ((ch - 1) & 0x0F)),
-        static_cast<uint8_t>(note & 0x7F),
-        0
-    };
-    tud_midi_stream_write(0, msg, sizeof(msg));
+    post(static_cast<uint8_t>(0x80 | ((clampChannel(channel) - 1) & 0x0F)), note, 0);
 }
 
 void sendControlChange(uint8_t control, uint8_t value) {
@@ -108,36 +490,99 @@ void sendControlChange(uint8_t control, uint8_t value) {
 }
 
 void sendControlChange(uint8_t channel, uint8_t control, uint8_t value) {
-    if (!isConnected()) return;
+    post(static_cast<uint8_t>(0xB0 | ((clampChannel(channel) - 1) & 0x0F)), control, value);
+}
 
-    uint8_t ch = clampChannel(channel);
-    uint8_t msg[3] = {
-        static_cast<uint8_t>(0xB0 | ((ch - 1) & 0x0F)),
-        static_cast<uint8_t>(control & 0x7F),
-        static_cast<uint8_t>(value & 0x7F)
-    };
-    tud_midi_stream_write(0, msg, sizeof(msg));
+bool isConnected() {
+    return initialized && tud_midi_mounted();
 }
 
-void update() {
-    if (noteOffCount > 0) {
-        uint32_t now = millis();
-        for (uint8_t i = 0; i < noteOffCount; ) {
-            if (now >= noteOffQueue[i].offTime) {
-                sendNoteOff(noteOffQueue[i].channel, noteOffQueue[i].note);
-                for (uint8_t j = i; j < noteOffCount - 1; j++) {
-                    noteOffQueue[j] = noteOffQueue[j + 1];
-                }
-                noteOffCount--;
-            } else {
-                i++;
-            }
-        }
+void attachTask(TaskHandle_t task) {
+    consumerTask = task;
+}
+
+uint32_t service() {
+    if (!initialized) return 100;
+
+    if (resetRequested.exchange(false)) {
+        uint16_t pending = stats.pending;
+        stats = {};
+        stats.pending = pending;
+        stats.maxPending = pending;
+    }
+
+    serviceInput();
+    expireNoteOffs(millis());
+
+    size_t queued = ring.size();
+    if (queued > stats.ringMax) stats.ringMax = static_cast<uint16_t>(queued);
+
+    // Con el endpoint lleno los eventos esperan en el anillo, no se pierden
+    MidiEvent ev;
+    while ((batchHasRoom() || flushBatch()) && ring.pop(ev)) {
+        handleEvent(ev);
     }
+
+    if (!flushBatch()) return 1;        // Endpoint ocupado: reintentar en 1 ms
+    return stats.pending ? 1 : 100;     // Note-offs en la rueda: resolución de 1 ms
 }
 
-bool isConnected() {
-    return initialized && tud_midi_mounted();
+void setNoteInputHandler(NoteInputHandler handler) {
+    noteHandler = handler;
+}
+
+void setSoundModule(bool enabled) {
+    soundModuleEnabled = enabled;
+}
+
+bool soundModule() {
+    return soundModuleEnabled;
+}
+
+uint16_t clockBpmX10() {
+    uint32_t last = lastClockUs.load();
+    if (last == 0 || static_cast<uint32_t>(micros()) - last > MIDI_CLOCK_TIMEOUT_MS * 1000UL) return 0;
+    return bpmX10.load();
+}
+
+bool clockRunning() {
+    return transportRunning.load();
+}
+
+Stats getStats() {
+    Stats s = stats;
+    s.ringDropped = ringDropped.load(std::memory_order_relaxed);
+    return s;
+}
+
+void resetStats() {
+    ringDropped.store(0, std::memory_order_relaxed);
+    resetRequested.store(true);
+    if (consumerTask) xTaskNotifyGive(consumerTask);
+}
+
+void printStats() {
+    Stats s = getStats();
+    Serial.printf("[MIDI] %lu msgs in %lu packets (max %u/packet, max %u packets/frame), %lu dropped\n",
+                  (unsigned long)s.messages, (unsigned long)s.packets, s.maxPerPacket,
+                  s.maxPacketsPerFrame, (unsigned long)s.dropped);
+    Serial.printf("[MIDI] Latency enqueue->USB: avg %lu us / max %lu us; ring max %u/%u, %lu dropped\n",
+                  (unsigned long)(s.messages ? s.totalLatencyUs / s.messages : 0),
+                  (unsigned long)s.maxLatencyUs, s.ringMax, (unsigned)ring.capacity(),
+                  (unsigned long)s.ringDropped);
+    Serial.printf("[MIDI] Input: %lu notes played, %lu ignored, latency USB->voice avg %lu us / max %lu us\n",
+                  (unsigned long)s.inputNotes, (unsigned long)s.inputIgnored,
+                  (unsigned long)(s.inputNotes ? s.totalInputLatencyUs / s.inputNotes : 0),
+                  (unsigned long)s.maxInputLatencyUs);
+    uint16_t bpm = clockBpmX10();
+    if (bpm) {
+        Serial.printf("[MIDI] Clock: %u.%u BPM (%s)\n", bpm / 10, bpm % 10, clockRunning() ? "running" : "stopped");
+    }
+    Serial.printf("[MIDI] Note-offs: %lu sent, %lu retriggered, pending %u (max %u), "
+                  "lateness avg %lu ms / max %lu ms\n",
+                  (unsigned long)s.noteOffs, (unsigned long)s.retriggers, s.pending, s.maxPending,
+                  (unsigned long)(s.noteOffs ? s.totalLatenessMs / s.noteOffs : 0),
+                  (unsigned long)s.maxLatenessMs);
 }
 
 } // namespace MIDIController
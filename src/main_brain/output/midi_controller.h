@@ -2,21 +2,48 @@
 #define MIDI_CONTROLLER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 namespace MIDIController {
 
 constexpr uint8_t  MIDI_CHANNEL      = 10;
 constexpr uint32_t NOTE_OFF_DURATION = 50;
 
-struct NoteOffEvent {
-    uint8_t  note;
-    uint8_t  channel;
-    uint32_t offTime;
+// Contadores de salida (lectura desde loop(), sin bloqueo)
+struct Stats {
+    uint32_t messages;          // Mensajes MIDI entregados a TinyUSB
+    uint32_t packets;           // Escrituras agrupadas (una por trama USB o por lote lleno)
+    uint8_t  maxPerPacket;      // Mensajes en el lote más grande (máx. 16 = 64 bytes)
+    uint8_t  maxPacketsPerFrame;// Escrituras dentro de una misma trama USB de 1 ms
+    uint32_t noteOffs;          // Note-offs programados que han vencido
+    uint32_t retriggers;        // Note-offs reprogramados por redisparo de la nota
+    uint16_t pending;           // Note-offs en la rueda ahora mismo
+    uint16_t maxPending;
+    uint32_t maxLatenessMs;     // Retraso máximo de un note-off respecto a su hora
+    uint32_t totalLatenessMs;   // Suma de retrasos (media = total / noteOffs)
+    uint32_t dropped;           // Mensajes perdidos con la FIFO USB llena
+    uint32_t ringDropped;       // Eventos perdidos con el anillo lleno
+    uint16_t ringMax;           // Ocupación máxima del anillo
+    uint32_t maxLatencyUs;      // Encolado → aceptado por TinyUSB, peor caso
+    uint64_t totalLatencyUs;    // Suma (media = total / messages)
+
+    // Entrada (modo módulo de sonido)
+    uint32_t inputNotes;        // Note-ons recibidos que arrancaron una voz
+    uint32_t inputIgnored;     // Note-ons sin voz: nota sin pad, sample sin cargar o modo desactivado
+    uint32_t maxInputLatencyUs; // Recepción USB → voz arrancada, peor caso
+    uint64_t totalInputLatencyUs;
 };
 
+// Note-on recibido por USB. Devuelve true si arrancó una voz.
+// Se llama desde la tarea MIDI, no desde loop().
+typedef bool (*NoteInputHandler)(uint8_t channel, uint8_t note, uint8_t velocity, uint16_t velocityHiRes);
+
 void begin();
-void update();
 
+// Productor: encolan en el anillo sin bloquear y despiertan a la tarea MIDI.
+// Un solo productor (el suscriptor MIDI del bus, EventDispatcher); el
+// anillo no admite varios.
 void sendNoteOn(uint8_t note, uint8_t velocity);
 void sendNoteOff(uint8_t note);
 void sendNoteOn(uint8_t channel, uint8_t note, uint8_t velocity);
@@ -25,6 +52,34 @@ void sendControlChange(uint8_t control, uint8_t value);
 void sendControlChange(uint8_t channel, uint8_t control, uint8_t value);
 bool isConnected();
 
+// Note-on con velocity de 16 bits (HitEvent::velocityHiRes). Con alta
+// resolución activa envía antes el prefijo CC88 con los 7 bits bajos de la
+// velocity de 14 bits; si no, solo el note-on con velocityHiRes >> 9.
+void sendNoteOnHiRes(uint8_t note, uint16_t velocityHiRes);
+void sendNoteOnHiRes(uint8_t channel, uint8_t note, uint16_t velocityHiRes);
+void setHighResVelocity(bool enabled);
+bool highResVelocity();
+
+// Entrada: los note-ons recibidos van directos al handler desde la tarea
+// MIDI (despertada por TinyUSB al recibir), sin pasar por loop()
+void setNoteInputHandler(NoteInputHandler handler);
+void setSoundModule(bool enabled);
+bool soundModule();
+
+// Tempo del reloj MIDI entrante en décimas de BPM (0 = sin reloj)
+uint16_t clockBpmX10();
+bool clockRunning();
+
+// Consumidor: tarea del suscriptor MIDI del bus (EventDispatcher). service()
+// vacía el anillo, vence note-offs y envía el lote; devuelve cuántos ms
+// puede dormir la tarea si nadie la despierta antes.
+void attachTask(TaskHandle_t task);
+uint32_t service();
+
+Stats getStats();
+void resetStats();   // Lo aplica la tarea MIDI en su siguiente pasada
+void printStats();
+
 }  // namespace MIDIController
 
 #endif // MIDI_CONTROLLER_H
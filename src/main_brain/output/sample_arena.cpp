@@ -0,0 +1,443 @@
+#include "sample_arena.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <cstring>
+
+namespace SampleArena {
+
+namespace {
+
+constexpr uint32_t ALIGN = 16;
+constexpr uint8_t SLAB_CLASSES = 4;
+constexpr uint32_t SLAB_CLASS_BYTES[SLAB_CLASSES] = {
+    16 * 1024, 32 * 1024, 64 * 1024, SAMPLE_SLAB_PAGE_BYTES
+};
+constexpr uint8_t SLAB_PAGES = SAMPLE_SLAB_BYTES / SAMPLE_SLAB_PAGE_BYTES;
+
+static_assert(SAMPLE_SLAB_BYTES % SAMPLE_SLAB_PAGE_BYTES == 0, "Slab must be whole pages");
+static_assert(SAMPLE_SLAB_PAGE_BYTES / (16 * 1024) <= 8, "Slab page bitmap is 8 bits");
+
+enum ExtentKind : uint8_t {
+    EXTENT_FREE = 0,
+    EXTENT_BANK,
+    EXTENT_SAMPLE
+};
+
+// Extents ordenados por offset y contiguos: cubren toda la zona no-slab
+struct Extent {
+    uint32_t offset;
+    uint32_t size;
+    ExtentKind kind;
+};
+
+struct Bank {
+    bool open;
+    bool sealed;
+    uint32_t offset;     // Offset del extent del banco
+    uint32_t capacity;
+    uint32_t used;
+    uint32_t lastAlloc;  // Offset (relativo al banco) de la última reserva
+};
+
+struct SlabPage {
+    int8_t sizeClass;    // -1 = página libre
+    uint8_t usedMask;    // Un bit por bloque
+};
+
+uint8_t* arenaBase = nullptr;
+uint32_t arenaSize = 0;
+uint32_t slabOffset = 0;          // Inicio de la zona slab (final de la arena)
+
+Extent extents[SAMPLE_ARENA_MAX_EXTENTS];
+uint8_t extentCount = 0;
+Bank banks[SAMPLE_ARENA_MAX_BANKS];
+SlabPage slabPages[SLAB_PAGES];
+uint32_t failedAllocs = 0;
+
+SemaphoreHandle_t arenaMutex = nullptr;
+
+// Los samples se reservan desde la tarea de carga y se liberan desde loop()
+class ArenaLock {
+public:
+    ArenaLock()  { xSemaphoreTake(arenaMutex, portMAX_DELAY); }
+    ~ArenaLock() { xSemaphoreGive(arenaMutex); }
+    ArenaLock(const ArenaLock&) = delete;
+    ArenaLock& operator=(const ArenaLock&) = delete;
+};
+
+uint32_t alignUp(uint32_t bytes) {
+    return (bytes + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+uint8_t blocksPerPage(int8_t sizeClass) {
+    return (uint8_t)(SAMPLE_SLAB_PAGE_BYTES / SLAB_CLASS_BYTES[sizeClass]);
+}
+
+// ============================================================
+// EXTENTS
+// ============================================================
+
+bool insertExtent(uint8_t at, uint32_t offset, uint32_t size, ExtentKind kind) {
+    if (extentCount >= SAMPLE_ARENA_MAX_EXTENTS) return false;
+    memmove(&extents[at + 1], &extents[at], (extentCount - at) * sizeof(Extent));
+    extents[at] = {offset, size, kind};
+    extentCount++;
+    return true;
+}
+
+void removeExtent(uint8_t at) {
+    memmove(&extents[at], &extents[at + 1], (extentCount - at - 1) * sizeof(Extent));
+    extentCount--;
+}
+
+int findExtent(uint32_t offset) {
+    for (uint8_t i = 0; i < extentCount; i++) {
+        if (extents[i].offset == offset) return i;
+    }
+    return -1;
+}
+
+// Recorta el extent a newSize y devuelve la cola como hueco libre.
+// Si la tabla está llena la cola se queda dentro del extent (no se pierde nada).
+void splitExtent(uint8_t at, uint32_t newSize) {
+    Extent& e = extents[at];
+    uint32_t tail = e.size - newSize;
+    if (tail == 0) return;
+
+    if (at + 1 < extentCount && extents[at + 1].kind == EXTENT_FREE) {
+        e.size = newSize;
+        extents[at + 1].offset -= tail;
+        extents[at + 1].size += tail;
+        return;
+    }
+    if (insertExtent(at + 1, e.offset + newSize, tail, EXTENT_FREE)) {
+        extents[at].size = newSize;
+    }
+}
+
+// Best-fit: el hueco más pequeño donde quepa, para conservar los grandes
+int allocExtent(uint32_t bytes, ExtentKind kind) {
+    int best = -1;
+    for (uint8_t i = 0; i < extentCount; i++) {
+        if (extents[i].kind != EXTENT_FREE || extents[i].size < bytes) continue;
+        if (best < 0 || extents[i].size < extents[best].size) best = i;
+    }
+    if (best < 0) return -1;
+
+    extents[best].kind = kind;
+    splitExtent(best, bytes);
+    return best;
+}
+
+void freeExtent(int at) {
+    extents[at].kind = EXTENT_FREE;
+
+    // Fusionar con el vecino siguiente y el anterior
+    if (at + 1 < extentCount && extents[at + 1].kind == EXTENT_FREE) {
+        extents[at].size += extents[at + 1].size;
+        removeExtent(at + 1);
+    }
+    if (at > 0 && extents[at - 1].kind == EXTENT_FREE) {
+        extents[at - 1].size += extents[at].size;
+        removeExtent(at);
+    }
+}
+
+uint32_t largestFreeExtent() {
+    uint32_t largest = 0;
+    for (uint8_t i = 0; i < extentCount; i++) {
+        if (extents[i].kind == EXTENT_FREE && extents[i].size > largest) {
+            largest = extents[i].size;
+        }
+    }
+    return largest;
+}
+
+// ============================================================
+// SLAB
+// ============================================================
+
+int8_t slabClassFor(uint32_t bytes) {
+    for (uint8_t c = 0; c < SLAB_CLASSES; c++) {
+        if (bytes <= SLAB_CLASS_BYTES[c]) return c;
+    }
+    return -1;
+}
+
+void* allocSlab(int8_t sizeClass) {
+    uint8_t blocks = blocksPerPage(sizeClass);
+    uint8_t fullMask = (uint8_t)((1u << blocks) - 1);
+
+    // Primero páginas ya asignadas a esta clase, después una página libre
+    int page = -1;
+    for (uint8_t p = 0; p < SLAB_PAGES; p++) {
+        if (slabPages[p].sizeClass == sizeClass && slabPages[p].usedMask != fullMask) {
+            page = p;
+            break;
+        }
+    }
+    if (page < 0) {
+        for (uint8_t p = 0; p < SLAB_PAGES; p++) {
+            if (slabPages[p].sizeClass < 0) {
+                slabPages[p].sizeClass = sizeClass;
+                slabPages[p].usedMask = 0;
+                page = p;
+                break;
+            }
+        }
+    }
+    if (page < 0) return nullptr;
+
+    for (uint8_t b = 0; b < blocks; b++) {
+        if (!(slabPages[page].usedMask & (1u << b))) {
+            slabPages[page].usedMask |= (uint8_t)(1u << b);
+            return arenaBase + slabOffset + page * SAMPLE_SLAB_PAGE_BYTES +
+                   b * SLAB_CLASS_BYTES[sizeClass];
+        }
+    }
+    return nullptr;
+}
+
+void freeSlab(uint32_t offset) {
+    uint32_t rel = offset - slabOffset;
+    SlabPage& page = slabPages[rel / SAMPLE_SLAB_PAGE_BYTES];
+    if (page.sizeClass < 0) return;
+
+    uint8_t block = (rel % SAMPLE_SLAB_PAGE_BYTES) / SLAB_CLASS_BYTES[page.sizeClass];
+    page.usedMask &= (uint8_t)~(1u << block);
+    if (page.usedMask == 0) {
+        page.sizeClass = -1;   // Página vacía: disponible para cualquier clase
+    }
+}
+
+uint32_t slabUsed() {
+    uint32_t used = 0;
+    for (uint8_t p = 0; p < SLAB_PAGES; p++) {
+        if (slabPages[p].sizeClass < 0) continue;
+        used += __builtin_popcount(slabPages[p].usedMask) *
+                SLAB_CLASS_BYTES[slabPages[p].sizeClass];
+    }
+    return used;
+}
+
+bool validBank(BankId bank) {
+    return bank >= 0 && bank < SAMPLE_ARENA_MAX_BANKS && banks[bank].open;
+}
+
+} // namespace
+
+// ============================================================
+// FUNCIONES PÚBLICAS
+// ============================================================
+
+bool begin() {
+    if (arenaBase) return true;
+
+    size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    if (largest <= SAMPLE_ARENA_RESERVE_BYTES + SAMPLE_SLAB_BYTES) {
+        Serial.println("[ARENA] ERROR: Not enough PSRAM for sample arena");
+        return false;
+    }
+
+    uint32_t size = (largest - SAMPLE_ARENA_RESERVE_BYTES) & ~(ALIGN - 1);
+    arenaBase = (uint8_t*)heap_caps_aligned_alloc(ALIGN, size, MALLOC_CAP_SPIRAM);
+    if (!arenaBase) {
+        Serial.println("[ARENA] ERROR: PSRAM reservation failed");
+        return false;
+    }
+
+    arenaMutex = xSemaphoreCreateMutex();
+    arenaSize = size;
+    slabOffset = size - SAMPLE_SLAB_BYTES;
+
+    extentCount = 0;
+    insertExtent(0, 0, slabOffset, EXTENT_FREE);
+    memset(banks, 0, sizeof(banks));
+    for (uint8_t p = 0; p < SLAB_PAGES; p++) {
+        slabPages[p] = {-1, 0};
+    }
+
+    Serial.printf("[ARENA] Reserved %u KB PSRAM (%u KB slab)\n",
+                  (unsigned)(size / 1024), (unsigned)(SAMPLE_SLAB_BYTES / 1024));
+    return true;
+}
+
+bool isReady() {
+    return arenaBase != nullptr;
+}
+
+BankId openBank(size_t capacity) {
+    if (!arenaBase) return NO_BANK;
+    ArenaLock lock;
+
+    BankId id = NO_BANK;
+    for (uint8_t b = 0; b < SAMPLE_ARENA_MAX_BANKS; b++) {
+        if (!banks[b].open) { id = b; break; }
+    }
+    if (id == NO_BANK) {
+        failedAllocs++;
+        return NO_BANK;
+    }
+
+    uint32_t bytes = capacity ? alignUp(capacity) : largestFreeExtent();
+    int at = bytes ? allocExtent(bytes, EXTENT_BANK) : -1;
+    if (at < 0) {
+        failedAllocs++;
+        return NO_BANK;
+    }
+
+    banks[id] = {true, false, extents[at].offset, extents[at].size, 0, 0};
+    return id;
+}
+
+void* bankAlloc(BankId bank, size_t bytes) {
+    ArenaLock lock;
+    if (!validBank(bank) || banks[bank].sealed) return nullptr;
+
+    Bank& b = banks[bank];
+    uint32_t size = alignUp(bytes);
+    if (size > b.capacity - b.used) {
+        failedAllocs++;
+        return nullptr;
+    }
+
+    void* ptr = arenaBase + b.offset + b.used;
+    b.lastAlloc = b.used;
+    b.used += size;
+    return ptr;
+}
+
+void bankShrinkLast(BankId bank, void* ptr, size_t bytes) {
+    ArenaLock lock;
+    if (!validBank(bank) || banks[bank].sealed) return;
+
+    Bank& b = banks[bank];
+    if ((uint8_t*)ptr != arenaBase + b.offset + b.lastAlloc) return;
+    uint32_t size = alignUp(bytes);
+    if (b.lastAlloc + size < b.used) b.used = b.lastAlloc + size;
+}
+
+void sealBank(BankId bank) {
+    ArenaLock lock;
+    if (!validBank(bank) || banks[bank].sealed) return;
+
+    Bank& b = banks[bank];
+    int at = findExtent(b.offset);
+    if (at < 0) return;
+
+    if (b.used == 0) {
+        // Banco vacío: no hay nada que conservar
+        freeExtent(at);
+        b = {};
+        return;
+    }
+
+    splitExtent(at, b.used);
+    b.capacity = extents[at].size;
+    b.sealed = true;
+}
+
+bool isSealed(BankId bank) {
+    ArenaLock lock;
+    return validBank(bank) && banks[bank].sealed;
+}
+
+void releaseBank(BankId bank) {
+    ArenaLock lock;
+    if (!validBank(bank)) return;
+
+    int at = findExtent(banks[bank].offset);
+    if (at >= 0) freeExtent(at);
+    banks[bank] = {};
+}
+
+void* allocSample(size_t bytes) {
+    if (!arenaBase || bytes == 0) return nullptr;
+    ArenaLock lock;
+
+    int8_t sizeClass = slabClassFor(bytes);
+    if (sizeClass >= 0) {
+        void* ptr = allocSlab(sizeClass);
+        if (ptr) return ptr;
+        // Slab lleno: usar un extent
+    }
+
+    int at = allocExtent(alignUp(bytes), EXTENT_SAMPLE);
+    if (at < 0) {
+        failedAllocs++;
+        return nullptr;
+    }
+    return arenaBase + extents[at].offset;
+}
+
+void shrink(void* ptr, size_t bytes) {
+    if (!ptr || !arenaBase) return;
+    uint32_t offset = (uint8_t*)ptr - arenaBase;
+    if (offset >= slabOffset) return;
+
+    ArenaLock lock;
+    int at = findExtent(offset);
+    uint32_t size = alignUp(bytes);
+    if (at < 0 || extents[at].kind != EXTENT_SAMPLE || size == 0 || size >= extents[at].size) return;
+    splitExtent(at, size);
+}
+
+void release(void* ptr) {
+    if (!ptr || !arenaBase) return;
+    uint8_t* p = (uint8_t*)ptr;
+    if (p < arenaBase || p >= arenaBase + arenaSize) {
+        Serial.println("[ARENA] WARNING: release() of pointer outside arena");
+        return;
+    }
+
+    ArenaLock lock;
+    uint32_t offset = p - arenaBase;
+    if (offset >= slabOffset) {
+        freeSlab(offset);
+        return;
+    }
+
+    int at = findExtent(offset);
+    if (at < 0 || extents[at].kind != EXTENT_SAMPLE) {
+        Serial.println("[ARENA] WARNING: release() of unknown block");
+        return;
+    }
+    freeExtent(at);
+}
+
+Stats getStats() {
+    Stats stats = {};
+    if (!arenaBase) return stats;
+    ArenaLock lock;
+
+    uint32_t extentFree = 0;
+    for (uint8_t i = 0; i < extentCount; i++) {
+        if (extents[i].kind == EXTENT_FREE) extentFree += extents[i].size;
+    }
+    uint32_t largest = largestFreeExtent();
+
+    stats.totalBytes = arenaSize;
+    stats.slabUsedBytes = slabUsed();
+    stats.freeBytes = extentFree + (SAMPLE_SLAB_BYTES - stats.slabUsedBytes);
+    stats.usedBytes = arenaSize - stats.freeBytes;
+    stats.largestFreeBlock = largest;
+    stats.fragmentationPct = extentFree ? (uint8_t)(100 - (uint64_t)largest * 100 / extentFree) : 0;
+    for (uint8_t b = 0; b < SAMPLE_ARENA_MAX_BANKS; b++) {
+        if (banks[b].open) stats.banksOpen++;
+    }
+    stats.failedAllocs = failedAllocs;
+    return stats;
+}
+
+void printStats() {
+    Stats s = getStats();
+    Serial.printf("[ARENA] Used %u / %u KB, free %u KB, largest %u KB, frag %u%%, "
+                  "slab %u KB, banks %u, failed %u\n",
+                  (unsigned)(s.usedBytes / 1024), (unsigned)(s.totalBytes / 1024),
+                  (unsigned)(s.freeBytes / 1024), (unsigned)(s.largestFreeBlock / 1024),
+                  s.fragmentationPct, (unsigned)(s.slabUsedBytes / 1024),
+                  s.banksOpen, (unsigned)s.failedAllocs);
+}
+
+} // namespace SampleArena
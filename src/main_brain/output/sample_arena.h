@@ -0,0 +1,83 @@
+#ifndef SAMPLE_ARENA_H
+#define SAMPLE_ARENA_H
+
+#include <Arduino.h>
+
+// ============================================================
+// SAMPLE ARENA - MEMORIA PSRAM DEDICADA A SAMPLES
+// ============================================================
+// Una única región PSRAM reservada al arrancar, repartida en:
+//
+//   [ extents (bancos de kit + samples grandes) ........ | slab ]
+//
+// - Banco: asignador "bump" para todos los samples de un kit. Se cierra
+//   (sealBank) devolviendo la cola sin usar y se libera entero de una vez.
+// - Slab: páginas de SAMPLE_SLAB_PAGE_BYTES divididas en clases de tamaño
+//   (16/32/64/128 KB) para one-shots sueltos pequeños; no fragmenta los extents.
+// - Samples sueltos grandes: un extent propio (best-fit con fusión de huecos).
+//
+// Nunca cae a RAM interna: si la arena no tiene sitio, la carga falla.
+
+#define SAMPLE_ARENA_RESERVE_BYTES (256 * 1024)   // PSRAM que se deja al resto del firmware
+#define SAMPLE_SLAB_BYTES          (1024 * 1024)  // Zona slab para one-shots pequeños
+#define SAMPLE_SLAB_PAGE_BYTES     (128 * 1024)   // Página = tamaño máximo de un bloque slab
+#define SAMPLE_ARENA_MAX_EXTENTS   64
+#define SAMPLE_ARENA_MAX_BANKS     4
+
+namespace SampleArena {
+
+typedef int8_t BankId;
+constexpr BankId NO_BANK = -1;
+
+struct Stats {
+    uint32_t totalBytes;         // Tamaño de la arena
+    uint32_t usedBytes;          // Extents ocupados + bloques slab en uso
+    uint32_t freeBytes;          // Huecos libres + slab libre
+    uint32_t largestFreeBlock;   // Mayor asignación contigua posible
+    uint8_t fragmentationPct;    // 100 * (1 - mayor hueco / huecos libres)
+    uint32_t slabUsedBytes;
+    uint8_t banksOpen;
+    uint32_t failedAllocs;
+};
+
+// Reserva la región PSRAM. @return false si no hay PSRAM
+bool begin();
+
+bool isReady();
+
+// Abre un banco para un kit. capacity = 0 reserva el mayor hueco libre
+// (para cargas cuyo tamaño total no se conoce; cerrar con sealBank()).
+// @return NO_BANK si no hay sitio
+BankId openBank(size_t capacity = 0);
+
+// Reserva dentro de un banco abierto (alineado a 16 bytes)
+void* bankAlloc(BankId bank, size_t bytes);
+
+// Recorta la última reserva del banco (p.ej. tras recortar silencios)
+void bankShrinkLast(BankId bank, void* ptr, size_t bytes);
+
+// Cierra el banco: devuelve la parte no usada a la arena
+void sealBank(BankId bank);
+
+bool isSealed(BankId bank);
+
+// Libera un banco entero (todos sus samples)
+void releaseBank(BankId bank);
+
+// Reserva para un sample suelto: slab si cabe en una página, si no un extent
+void* allocSample(size_t bytes);
+
+// Recorta una reserva de allocSample() devolviendo la cola a la arena
+// (los bloques slab conservan su tamaño de clase)
+void shrink(void* ptr, size_t bytes);
+
+// Libera una reserva de allocSample()
+void release(void* ptr);
+
+Stats getStats();
+
+void printStats();
+
+} // namespace SampleArena
+
+#endif // SAMPLE_ARENA_H
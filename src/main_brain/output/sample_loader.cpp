@@ -0,0 +1,271 @@
+#include "sample_loader.h"
+#include "audio_samples.h"
+#include "../communication/uart_protocol.h"
+#include <edrum_config.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <cstring>
+
+namespace SampleLoader {
+
+namespace {
+
+struct LoadRequest {
+    RequestType type;
+    char path[SAMPLE_LOADER_PATH_LEN];
+    CompletionFn done;
+    void* ctx;
+};
+
+struct LoadResult {
+    LoadRequest request;
+    bool success;
+    uint32_t samples;
+    uint32_t bytes;
+    uint32_t elapsedMs;
+};
+
+// Progreso de la petición en curso: lo escribe la tarea, lo lee update()
+struct ProgressState {
+    bool active;
+    uint32_t bytesDone;
+    uint32_t bytesTotal;
+    uint32_t bytesFinished;   // Bytes de archivos ya terminados (REQUEST_DEFAULTS)
+    char name[SAMPLE_LOADER_PATH_LEN];
+};
+
+constexpr uint32_t PROGRESS_INTERVAL_MS = 100;   // Máx 10 Hz hacia el display
+constexpr uint32_t GC_INTERVAL_MS = 1000;        // Barrido lento de samples retirados
+
+QueueHandle_t requestQueue = nullptr;
+QueueHandle_t resultQueue = nullptr;
+TaskHandle_t loaderTaskHandle = nullptr;
+
+portMUX_TYPE progressMux = portMUX_INITIALIZER_UNLOCKED;
+ProgressState progress = {};
+volatile bool busy = false;
+
+// Estado de envío al display (sólo desde loop)
+uint32_t lastProgressSentMs = 0;
+uint8_t lastPercentSent = 0xFF;
+uint32_t lastGcMs = 0;
+
+const char* displayName(const LoadRequest& req) {
+    return req.type == REQUEST_DEFAULTS ? "default kit" : req.path;
+}
+
+// LoadProgressFn: se llama desde la tarea de carga
+void onProgress(uint32_t bytesDone, uint32_t bytesTotal, void*) {
+    portENTER_CRITICAL(&progressMux);
+    if (progress.bytesTotal &&
+        (progress.bytesDone == progress.bytesTotal || bytesDone < progress.bytesDone)) {
+        // Empezó otro archivo dentro de la misma petición
+        progress.bytesFinished += progress.bytesDone;
+    }
+    progress.bytesDone = bytesDone;
+    progress.bytesTotal = bytesTotal;
+    portEXIT_CRITICAL(&progressMux);
+}
+
+void sendProgress(uint8_t state, const char* name, uint32_t done, uint32_t total) {
+    LoadProgressMsg msg = {};
+    msg.state = state;
+    msg.percent = total ? (uint8_t)((uint64_t)done * 100 / total)
+                        : (state == LOAD_STATE_DONE ? 100 : 0);
+    msg.pending = pendingCount();
+    msg.bytesDone = done;
+    msg.bytesTotal = total;
+    strncpy(msg.name, name, sizeof(msg.name) - 1);
+    UARTProtocol::queueLoadProgress(msg);
+}
+
+void loaderTask(void* parameter) {
+    (void)parameter;
+    Serial.println("[LOADER] Sample loader task started on Core 0");
+
+    LoadRequest req;
+    while (true) {
+        if (xQueueReceive(requestQueue, &req, portMAX_DELAY) != pdTRUE) continue;
+
+        busy = true;
+        portENTER_CRITICAL(&progressMux);
+        progress.active = true;
+        progress.bytesDone = 0;
+        progress.bytesTotal = 0;
+        progress.bytesFinished = 0;
+        strncpy(progress.name, displayName(req), sizeof(progress.name) - 1);
+        progress.name[sizeof(progress.name) - 1] = '\0';
+        portEXIT_CRITICAL(&progressMux);
+
+        LoadResult result = {};
+        result.request = req;
+        uint32_t startMs = millis();
+
+        switch (req.type) {
+            case REQUEST_SAMPLE:
+                result.success = SampleManager::loadSample(req.path, onProgress, nullptr);
+                result.samples = result.success ? 1 : 0;
+                break;
+            case REQUEST_KIT_BUNDLE:
+                result.samples = SampleManager::loadKitBundle(req.path, onProgress, nullptr);
+                result.success = result.samples > 0;
+                break;
+            case REQUEST_DEFAULTS:
+                // Arranque con kit de flash: la SD se monta aquí, con el audio ya sonando
+                if (SampleManager::cardClockHz() == 0 && !SampleManager::mountCard()) {
+                    result.samples = 0;
+                } else {
+                    result.samples = SampleManager::loadDefaults(onProgress, nullptr);
+                }
+                result.success = result.samples > 0;
+                break;
+        }
+        result.elapsedMs = millis() - startMs;
+
+        portENTER_CRITICAL(&progressMux);
+        result.bytes = progress.bytesFinished + progress.bytesDone;
+        progress.active = false;
+        portEXIT_CRITICAL(&progressMux);
+
+        // Nunca se descarta un resultado: si loop() va atrasado, esperar
+        xQueueSend(resultQueue, &result, portMAX_DELAY);
+        busy = false;
+    }
+}
+
+bool enqueue(RequestType type, const char* path, CompletionFn done, void* ctx) {
+    if (!requestQueue) {
+        Serial.println("[LOADER] Not initialized");
+        return false;
+    }
+
+    LoadRequest req = {};
+    req.type = type;
+    if (path) {
+        strncpy(req.path, path, sizeof(req.path) - 1);
+    }
+    req.done = done;
+    req.ctx = ctx;
+
+    if (xQueueSend(requestQueue, &req, 0) != pdTRUE) {
+        Serial.printf("[LOADER] Queue full, dropped request for %s\n", displayName(req));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================
+// FUNCIONES PÚBLICAS
+// ============================================================
+
+bool begin() {
+    if (loaderTaskHandle) return true;
+
+    requestQueue = xQueueCreate(QUEUE_SIZE_SAMPLE_LOAD, sizeof(LoadRequest));
+    resultQueue = xQueueCreate(QUEUE_SIZE_SAMPLE_LOAD, sizeof(LoadResult));
+    if (!requestQueue || !resultQueue) {
+        Serial.println("[LOADER] Failed to create queues");
+        return false;
+    }
+
+    // Core 0, prioridad mínima: el mezclador (Core 1) y el scanner nunca esperan a la SD
+    xTaskCreatePinnedToCore(
+        loaderTask,
+        "SampleLoader",
+        TASK_STACK_SAMPLE_LOADER,
+        nullptr,
+        TASK_PRIORITY_SAMPLE_LOADER,
+        &loaderTaskHandle,
+        TASK_CORE_SAMPLE_LOADER
+    );
+
+    if (!loaderTaskHandle) {
+        Serial.println("[LOADER] Failed to create task");
+        return false;
+    }
+    return true;
+}
+
+bool requestSample(const char* path, CompletionFn done, void* ctx) {
+    if (!path || !path[0]) return false;
+    return enqueue(REQUEST_SAMPLE, path, done, ctx);
+}
+
+bool requestKitBundle(const char* path, CompletionFn done, void* ctx) {
+    if (!path || !path[0]) return false;
+    return enqueue(REQUEST_KIT_BUNDLE, path, done, ctx);
+}
+
+bool requestDefaults(CompletionFn done, void* ctx) {
+    return enqueue(REQUEST_DEFAULTS, nullptr, done, ctx);
+}
+
+void update() {
+    if (!resultQueue) return;
+
+    // 1. Peticiones terminadas: avisar al display y ejecutar callbacks
+    LoadResult result;
+    bool drained = false;
+    while (xQueueReceive(resultQueue, &result, 0) == pdTRUE) {
+        drained = true;
+        const char* name = displayName(result.request);
+        Serial.printf("[LOADER] %s %s: %lu samples, %lu KB in %lu ms\n",
+                      result.success ? "Loaded" : "Failed",
+                      name,
+                      (unsigned long)result.samples,
+                      (unsigned long)(result.bytes / 1024),
+                      (unsigned long)result.elapsedMs);
+
+        sendProgress(result.success ? LOAD_STATE_DONE : LOAD_STATE_FAILED,
+                     name, result.bytes, result.bytes);
+        lastPercentSent = 0xFF;
+
+        if (result.request.done) {
+            result.request.done(result.request.path, result.success, result.request.ctx);
+        }
+    }
+
+    // 2. Desalojar caché por encima del presupuesto (sólo samples que ya no suenan).
+    //    collectGarbage() toma samplesMutex y recorre todos los slots, así que no
+    //    se llama en cada pasada: sólo tras una carga (puede superar el presupuesto)
+    //    o cada GC_INTERVAL_MS. unloadSample() ya aplica el presupuesto con su lock;
+    //    el barrido lento recoge lo que entonces seguía sonando, cuando el epoch
+    //    del mixer avanza.
+    uint32_t now = millis();
+    if (drained || now - lastGcMs >= GC_INTERVAL_MS) {
+        lastGcMs = now;
+        size_t freed = SampleManager::collectGarbage();
+        if (freed > 0) {
+            Serial.printf("[LOADER] Evicted %u cached samples (%u unloaded still playing)\n",
+                          (unsigned)freed, (unsigned)SampleManager::retiredCount());
+        }
+    }
+
+    // 3. Progreso de la petición en curso (limitado a PROGRESS_INTERVAL_MS)
+    if (now - lastProgressSentMs < PROGRESS_INTERVAL_MS) return;
+
+    portENTER_CRITICAL(&progressMux);
+    ProgressState snapshot = progress;
+    portEXIT_CRITICAL(&progressMux);
+    if (!snapshot.active || snapshot.bytesTotal == 0) return;
+
+    uint8_t percent = (uint8_t)((uint64_t)snapshot.bytesDone * 100 / snapshot.bytesTotal);
+    if (percent == lastPercentSent) return;
+
+    sendProgress(LOAD_STATE_LOADING, snapshot.name, snapshot.bytesDone, snapshot.bytesTotal);
+    lastPercentSent = percent;
+    lastProgressSentMs = now;
+}
+
+bool isBusy() {
+    return busy || pendingCount() > 0;
+}
+
+uint8_t pendingCount() {
+    return requestQueue ? (uint8_t)uxQueueMessagesWaiting(requestQueue) : 0;
+}
+
+} // namespace SampleLoader
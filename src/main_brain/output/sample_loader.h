@@ -0,0 +1,53 @@
+#ifndef SAMPLE_LOADER_H
+#define SAMPLE_LOADER_H
+
+#include <Arduino.h>
+
+// ============================================================
+// SAMPLE LOADER - CARGA ASÍNCRONA DESDE SD
+// ============================================================
+// Tarea de baja prioridad (Core 0) que atiende una cola de peticiones de
+// carga (sample WAV, kit bundle o carga por defecto de PadConfig), para que
+// loop() y el mezclador sigan funcionando mientras se lee la SD.
+//
+// Los callbacks de finalización y el progreso hacia el display (MSG_LOAD_PROGRESS)
+// se entregan desde update(), es decir, en el contexto de loop(): los callbacks
+// pueden tocar PadConfig, MenuSystem o UARTProtocol sin más sincronización.
+
+#define SAMPLE_LOADER_PATH_LEN 64
+
+namespace SampleLoader {
+
+enum RequestType : uint8_t {
+    REQUEST_SAMPLE = 0,     // Un WAV suelto (SampleManager::loadSample)
+    REQUEST_KIT_BUNDLE,     // Un bundle .kit (SampleManager::loadKitBundle)
+    REQUEST_DEFAULTS        // Bundle por defecto + samples de PadConfig (monta la SD si no lo está)
+};
+
+// Callback de finalización (se ejecuta en loop() vía update())
+// @param path Ruta pedida (vacía para REQUEST_DEFAULTS)
+// @param success true si se cargó al menos un sample
+typedef void (*CompletionFn)(const char* path, bool success, void* ctx);
+
+// Crea la cola y la tarea de carga. Las peticiones de sample y bundle
+// necesitan la tarjeta montada; REQUEST_DEFAULTS la monta si hace falta.
+bool begin();
+
+// Encolan una petición. No bloquean: devuelven false si la cola está llena.
+bool requestSample(const char* path, CompletionFn done = nullptr, void* ctx = nullptr);
+bool requestKitBundle(const char* path, CompletionFn done = nullptr, void* ctx = nullptr);
+bool requestDefaults(CompletionFn done = nullptr, void* ctx = nullptr);
+
+// Entrega callbacks completados, desaloja la caché de samples por encima del presupuesto
+// y envía el progreso al display (llamar en loop)
+void update();
+
+// true mientras haya una petición en curso o en cola
+bool isBusy();
+
+// Peticiones en cola (sin contar la que está en curso)
+uint8_t pendingCount();
+
+} // namespace SampleLoader
+
+#endif // SAMPLE_LOADER_H
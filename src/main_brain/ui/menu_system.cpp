@@ -1,7 +1,9 @@
 #include "menu_system.h"
 #include "../communication/uart_protocol.h"
 #include "../output/audio_samples.h"
+#include "../output/sample_loader.h"
 #include "pad_config.h"
+#include "../core/log_ring.h"
 #include <SD.h>
 
 namespace MenuSystem {
@@ -9,6 +11,10 @@ namespace MenuSystem {
 // Forward declarations
 static void scanDirectory(File& dir, uint8_t depth);
 static void sendDisplayUpdate();
+static void onSampleLoaded(const char* path, bool success, void* padCtx);
+static bool isSampleInUse(const char* name);
+static void releaseSessionSamples();
+static void requestPadSamples();
 
 // ============================================================================
 // STATE
@@ -16,6 +22,11 @@ static void sendDisplayUpdate();
 
 static MenuContext ctx;
 
+// Samples mapped or replaced by the browser since the last save/discard.
+// They stay mapped until the change is committed, so a discard can fall
+// back to the saved sample without reloading it.
+static std::vector<String> sessionSamples;
+
 // Option names for display
 static const char* OPTION_NAMES[CONFIG_COUNT] = {
     "SAMPLE",
@@ -44,8 +55,11 @@ void begin() {
     ctx.hasChanges = false;
     ctx.availableSamples.clear();
 
-    // Try to load saved config
-    loadConfiguration();
+    // Try to load saved config. With the built-in kit the card mounts in the
+    // background; main.cpp loads it once SampleLoader has mounted the card.
+    if (SampleManager::cardClockHz() != 0) {
+        loadConfiguration();
+    }
 
     Serial.println("[MENU] Menu system initialized");
 }
@@ -101,7 +115,7 @@ void onEncoderRotate(int8_t direction) {
             // Navigate between pads
             ctx.selectedPad = (ctx.selectedPad + direction + NUM_PADS) % NUM_PADS;
             ctx.needsRedraw = true;
-            Serial.printf("[MENU] Selected pad: %d (%s)\n", ctx.selectedPad, PAD_NAMES[ctx.selectedPad]);
+            LOG_EVENT(MENU_PAD, ctx.selectedPad);
             break;
 
         case MENU_PAD_CONFIG:
@@ -109,23 +123,29 @@ void onEncoderRotate(int8_t direction) {
                 // Adjust current value
                 PadConfig& cfg = PadConfigManager::getConfig(ctx.selectedPad);
                 int step = (direction > 0) ? 10 : -10;
+                uint32_t field = 0;
 
                 switch (ctx.selectedOption) {
                     case CONFIG_THRESHOLD:
                         cfg.threshold = constrain((int)cfg.threshold + step, 50, 1000);
-                        Serial.printf("[MENU] Threshold: %d\n", cfg.threshold);
+                        field = configFieldBit(CFG_THRESHOLD);
+                        LOG_EVENT(MENU_THRESHOLD, cfg.threshold);
                         break;
                     case CONFIG_SENSITIVITY:
                         cfg.velocityMin = constrain((int)cfg.velocityMin + step, 50, 500);
-                        Serial.printf("[MENU] Sensitivity: %d\n", cfg.velocityMin);
+                        field = configFieldBit(CFG_VELOCITY_MIN);
+                        LOG_EVENT(MENU_SENSITIVITY, cfg.velocityMin);
                         break;
                     case CONFIG_MAX_PEAK:
                         cfg.velocityMax = constrain((int)cfg.velocityMax + step * 10, 500, 4000);
-                        Serial.printf("[MENU] Max Peak: %d\n", cfg.velocityMax);
+                        field = configFieldBit(CFG_VELOCITY_MAX);
+                        LOG_EVENT(MENU_MAX_PEAK, cfg.velocityMax);
                         break;
                     default:
                         break;
                 }
+                // Encoder steps within one UART tick go out as one delta
+                PadConfigManager::markChanged(ctx.selectedPad, field);
                 ctx.hasChanges = true;
             } else {
                 // Navigate options
@@ -133,7 +153,7 @@ void onEncoderRotate(int8_t direction) {
                 if (newOption < 0) newOption = CONFIG_COUNT - 1;
                 if (newOption >= CONFIG_COUNT) newOption = 0;
                 ctx.selectedOption = (ConfigOption)newOption;
-                Serial.printf("[MENU] Option: %s\n", OPTION_NAMES[ctx.selectedOption]);
+                LOG_EVENT(MENU_OPTION, ctx.selectedOption);
             }
             ctx.needsRedraw = true;
             break;
@@ -153,7 +173,7 @@ void onEncoderRotate(int8_t direction) {
                     ctx.sampleScrollOffset = ctx.selectedSampleIndex - 3;
                 }
 
-                Serial.printf("[MENU] Sample: %s\n", ctx.availableSamples[ctx.selectedSampleIndex].displayName);
+                LOG_EVENT(MENU_SAMPLE, ctx.selectedSampleIndex + 1, ctx.availableSamples.size());
             }
             ctx.needsRedraw = true;
             break;
@@ -203,17 +223,15 @@ void onEncoderPress() {
         case MENU_SAMPLE_BROWSE:
             // Select sample
             if (!ctx.availableSamples.empty()) {
-                PadConfig& cfg = PadConfigManager::getConfig(ctx.selectedPad);
                 const char* newSample = ctx.availableSamples[ctx.selectedSampleIndex].path;
 
-                // Load new sample into memory
-                if (SampleManager::loadSample(newSample)) {
-                    strncpy(cfg.sampleName, newSample, sizeof(cfg.sampleName) - 1);
-                    cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
-                    ctx.hasChanges = true;
-                    Serial.printf("[MENU] PAD%d sample changed to: %s\n", ctx.selectedPad + 1, cfg.sampleName);
+                // Load new sample in the background; the pad switches over in
+                // onSampleLoaded() so the current sample keeps playing meanwhile
+                if (SampleLoader::requestSample(newSample, onSampleLoaded,
+                                                (void*)(uintptr_t)ctx.selectedPad)) {
+                    Serial.printf("[MENU] Loading %s for PAD%d...\n", newSample, ctx.selectedPad + 1);
                 } else {
-                    Serial.printf("[MENU] Failed to load sample: %s\n", newSample);
+                    Serial.printf("[MENU] Failed to queue sample: %s\n", newSample);
                 }
             }
             ctx.state = MENU_PAD_CONFIG;
@@ -241,6 +259,8 @@ void onButtonMenu() {
             // Reload config to discard changes
             PadConfigManager::loadFromNVS();
             ctx.hasChanges = false;
+            releaseSessionSamples();
+            requestPadSamples();
         }
         ctx.state = MENU_HIDDEN;
         ctx.needsRedraw = true;
@@ -281,6 +301,7 @@ void onButtonFX() {
         if (savedOk) {
             Serial.println("[MENU] ✅ Configuration SAVED to NVS!");
             ctx.hasChanges = false;
+            releaseSessionSamples();
 
             // Send SAVING state to display (triggers toast)
             ctx.state = MENU_SAVING;
@@ -391,6 +412,69 @@ static void scanDirectory(File& dir, uint8_t depth) {
     }
 }
 
+// SampleLoader completion (runs in loop() via SampleLoader::update)
+static void onSampleLoaded(const char* path, bool success, void* padCtx) {
+    uint8_t padId = (uint8_t)(uintptr_t)padCtx;
+
+    if (!success) {
+        Serial.printf("[MENU] Failed to load sample: %s\n", path);
+        return;
+    }
+    if (ctx.state == MENU_HIDDEN) {
+        // Menu closed (changes discarded) while loading: keep the old sample
+        Serial.printf("[MENU] %s loaded after menu closed - not assigned\n", path);
+        return;
+    }
+
+    PadConfig& cfg = PadConfigManager::getConfig(padId);
+    char previous[sizeof(cfg.sampleName)];
+    strncpy(previous, cfg.sampleName, sizeof(previous));
+    strncpy(cfg.sampleName, path, sizeof(cfg.sampleName) - 1);
+    cfg.sampleName[sizeof(cfg.sampleName) - 1] = '\0';
+    PadConfigManager::markChanged(padId, configFieldBit(CFG_SAMPLE_NAME));
+    ctx.hasChanges = true;
+    ctx.needsRedraw = true;
+    Serial.printf("[MENU] PAD%d sample changed to: %s\n", padId + 1, cfg.sampleName);
+
+    // The replaced sample stays mapped until save/discard
+    if (previous[0] != '\0') sessionSamples.push_back(previous);
+    sessionSamples.push_back(cfg.sampleName);
+}
+
+static bool isSampleInUse(const char* name) {
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        const PadConfig& cfg = PadConfigManager::getConfig(i);
+        if (strcmp(cfg.sampleName, name) == 0) return true;
+        if (cfg.dualZoneEnabled && strcmp(cfg.rimSampleName, name) == 0) return true;
+    }
+    return false;
+}
+
+// On save or discard: browsed samples no pad uses any more go to the
+// sample cache (instant if picked again)
+static void releaseSessionSamples() {
+    for (const String& name : sessionSamples) {
+        if (!isSampleInUse(name.c_str())) {
+            SampleManager::unloadSample(name.c_str());
+        }
+    }
+    sessionSamples.clear();
+}
+
+// Queue every pad sample that is not mapped (names restored from NVS or
+// read from the SD config may never have been loaded)
+static void requestPadSamples() {
+    for (uint8_t i = 0; i < NUM_PADS; i++) {
+        const PadConfig& cfg = PadConfigManager::getConfig(i);
+        if (cfg.sampleName[0] != '\0' && !SampleManager::getSample(cfg.sampleName)) {
+            SampleLoader::requestSample(cfg.sampleName);
+        }
+        if (cfg.dualZoneEnabled && cfg.rimSampleName[0] != '\0' && !SampleManager::getSample(cfg.rimSampleName)) {
+            SampleLoader::requestSample(cfg.rimSampleName);
+        }
+    }
+}
+
 // ============================================================================
 // CONFIGURATION PERSISTENCE
 // ============================================================================
@@ -457,6 +541,8 @@ bool loadConfiguration() {
     }
 
     f.close();
+    PadConfigManager::markChanged();
+    requestPadSamples();
     return true;
 }
 
@@ -503,7 +589,7 @@ static void sendDisplayUpdate() {
     }
 
     // Send menu state
-    UARTProtocol::sendMenuState(msg);
+    UARTProtocol::queueMenuState(msg);
 
     // If in sample browse mode, also send sample list
     if (ctx.state == MENU_SAMPLE_BROWSE && !ctx.availableSamples.empty()) {
@@ -529,7 +615,7 @@ static void sendDisplayUpdate() {
                     sizeof(sampleMsg.samples[i].path) - 1);
         }
 
-        UARTProtocol::sendSampleList(sampleMsg);
+        UARTProtocol::queueSampleList(sampleMsg);
     }
 
     // Debug output
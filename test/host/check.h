@@ -0,0 +1,37 @@
+/**
+ * @file check.h
+ * @brief Minimal check harness shared by the host tests in test/host/
+ *
+ * CHECK() records a failure with its location and a printf-style message
+ * and keeps going, so one run reports every broken property. main() ends
+ * with `return checkSummary("name");`.
+ */
+
+#ifndef TEST_HOST_CHECK_H
+#define TEST_HOST_CHECK_H
+
+#include <cstdio>
+
+inline int failures = 0;
+
+#define CHECK(cond, ...)                                     \
+    do {                                                     \
+        if (!(cond)) {                                       \
+            failures++;                                      \
+            std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            std::printf(__VA_ARGS__);                        \
+            std::printf("\n");                               \
+        }                                                    \
+    } while (0)
+
+// Prints the result line and returns the process exit code
+inline int checkSummary(const char* suite) {
+    if (failures) {
+        std::printf("%d check(s) FAILED\n", failures);
+        return 1;
+    }
+    std::printf("All %s checks passed\n", suite);
+    return 0;
+}
+
+#endif // TEST_HOST_CHECK_H
@@ -0,0 +1,267 @@
+/**
+ * @file test_frame_parser.cpp
+ * @brief Host fuzz/property test for the UART frame parser (shared/protocol/frame_parser.h)
+ *
+ * Feeds random frame streams through the parser in random chunk sizes and checks:
+ * - a clean stream comes out frame for frame, bit-exact and in order;
+ * - noise between frames (including fake headers with large lengths) never
+ *   costs a good frame, once the idle timeout (expire) has run;
+ * - corrupting bytes inside some frames only loses those frames;
+ * - pure garbage never overruns the window and almost never yields a frame;
+ * - empty and maximum-size payloads round-trip.
+ * It also measures parser throughput against a 921600 baud link.
+ *
+ * Build and run (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Ishared/protocol test/host/test_frame_parser.cpp -o /tmp/test_frame_parser
+ *   /tmp/test_frame_parser
+ */
+
+#include <frame_parser.h>
+
+#include "check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const uint16_t MAX_PAYLOAD = 2048;  // UART_MAX_PAYLOAD in gui_protocol.h
+static const double LINK_BYTES_PER_S = 921600.0 / 10.0;  // 8N1
+
+// ============================================================
+// STREAM GENERATION
+// ============================================================
+
+struct Frame {
+    uint8_t type;
+    std::vector<uint8_t> payload;
+    bool operator==(const Frame& o) const { return type == o.type && payload == o.payload; }
+};
+
+static void encode(const Frame& f, std::vector<uint8_t>& out) {
+    size_t start = out.size();
+    out.push_back(FRAME_START_BYTE);
+    out.push_back(f.type);
+    out.push_back(f.payload.size() >> 8);
+    out.push_back(f.payload.size() & 0xFF);
+    out.insert(out.end(), f.payload.begin(), f.payload.end());
+    uint16_t crc = frameCrc16(out.data() + start, out.size() - start);
+    out.push_back(crc >> 8);
+    out.push_back(crc & 0xFF);
+}
+
+// Mostly small telemetry frames, some config-sized ones; payloads are
+// biased towards 0xAA so start bytes show up inside frames too
+static Frame randomFrame(std::mt19937& rng, uint16_t maxLength = 300) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> unit(0, 99);
+    Frame f;
+    f.type = byte(rng);
+    size_t length = unit(rng) < 90 ? rng() % 33 : rng() % (maxLength + 1);
+    f.payload.resize(length);
+    for (auto& b : f.payload) b = unit(rng) < 10 ? FRAME_START_BYTE : byte(rng);
+    return f;
+}
+
+static void appendNoise(std::vector<uint8_t>& out, std::mt19937& rng) {
+    std::uniform_int_distribution<int> unit(0, 99);
+    int kind = unit(rng);
+    if (kind < 40) {
+        // Fake header with a plausible-but-wrong length: swallows what follows
+        out.push_back(FRAME_START_BYTE);
+        out.push_back(rng() & 0xFF);
+        uint16_t length = rng() % (MAX_PAYLOAD + 1);
+        out.push_back(length >> 8);
+        out.push_back(length & 0xFF);
+    } else {
+        size_t n = 1 + rng() % 12;
+        for (size_t i = 0; i < n; i++) out.push_back(unit(rng) < 30 ? FRAME_START_BYTE : (rng() & 0xFF));
+    }
+}
+
+struct Receiver {
+    FrameParser<MAX_PAYLOAD> parser;
+    std::vector<Frame> frames;
+
+    void feed(const std::vector<uint8_t>& stream, std::mt19937& rng) {
+        auto onFrame = [this](uint8_t type, const uint8_t* payload, uint16_t length) {
+            frames.push_back(Frame{type, std::vector<uint8_t>(payload, payload + length)});
+        };
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            size_t n = std::min<size_t>(1 + rng() % 300, stream.size() - pos);
+            parser.parse(stream.data() + pos, n, onFrame);
+            if (parser.pending() > FrameParser<MAX_PAYLOAD>::MAX_FRAME) {
+                CHECK(false, "window overrun: %zu bytes", parser.pending());
+            }
+            pos += n;
+        }
+        // Line goes idle: abandon whatever candidate is left
+        while (!parser.idle()) parser.expire(onFrame);
+    }
+};
+
+// Every expected frame appears in order; returns how many extra frames
+// (false positives from noise) were interleaved
+static size_t checkSubsequence(const std::vector<Frame>& expected, const std::vector<Frame>& got,
+                               const char* label) {
+    size_t j = 0;
+    for (const Frame& f : got) {
+        if (j < expected.size() && f == expected[j]) j++;
+    }
+    CHECK(j == expected.size(), "%s: only %zu of %zu good frames delivered", label, j, expected.size());
+    return got.size() - j;
+}
+
+// ============================================================
+// PROPERTIES
+// ============================================================
+
+static void testCleanStream(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Frame> sent;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 5000; i++) {
+        sent.push_back(randomFrame(rng));
+        encode(sent.back(), stream);
+    }
+
+    Receiver rx;
+    rx.feed(stream, rng);
+    CHECK(rx.frames.size() == sent.size(), "clean: %zu frames, expected %zu", rx.frames.size(), sent.size());
+    CHECK(rx.frames == sent, "clean: frames differ");
+    CHECK(rx.parser.stats().crcErrors == 0 && rx.parser.stats().skippedBytes == 0,
+          "clean: %u CRC errors, %u skipped bytes", rx.parser.stats().crcErrors,
+          rx.parser.stats().skippedBytes);
+}
+
+static void testNoiseBetweenFrames(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Frame> sent;
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 5000; i++) {
+        if (rng() % 4 == 0) appendNoise(stream, rng);
+        sent.push_back(randomFrame(rng));
+        encode(sent.back(), stream);
+    }
+    appendNoise(stream, rng);
+
+    Receiver rx;
+    rx.feed(stream, rng);
+    size_t extra = checkSubsequence(sent, rx.frames, "noise");
+    CHECK(extra <= 2, "noise: %zu false frames", extra);
+    std::printf("  noise:     %zu frames, %u CRC / %u length errors, %u timeouts, %zu false\n",
+                rx.frames.size(), rx.parser.stats().crcErrors, rx.parser.stats().lengthErrors,
+                rx.parser.stats().timeouts, extra);
+}
+
+static void testCorruptedFrames(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Frame> good;
+    std::vector<uint8_t> stream;
+    int corrupted = 0;
+    for (int i = 0; i < 5000; i++) {
+        Frame f = randomFrame(rng);
+        std::vector<uint8_t> bytes;
+        encode(f, bytes);
+        if (rng() % 10 == 0) {
+            // Flip bits anywhere in the frame, header and CRC included
+            bytes[rng() % bytes.size()] ^= 1 + rng() % 255;
+            corrupted++;
+        } else {
+            good.push_back(f);
+        }
+        stream.insert(stream.end(), bytes.begin(), bytes.end());
+    }
+
+    Receiver rx;
+    rx.feed(stream, rng);
+    size_t extra = checkSubsequence(good, rx.frames, "corrupt");
+    CHECK(extra <= 2, "corrupt: %zu corrupted frames accepted", extra);
+    std::printf("  corrupted: %d damaged, %zu good delivered, %zu accepted by CRC collision\n",
+                corrupted, rx.frames.size() - extra, extra);
+}
+
+static void testGarbage(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> stream(1 << 20);
+    for (auto& b : stream) b = rng() % 4 == 0 ? FRAME_START_BYTE : (rng() & 0xFF);
+
+    Receiver rx;
+    rx.feed(stream, rng);
+    CHECK(rx.frames.size() <= 4, "garbage: %zu frames out of random bytes", rx.frames.size());
+}
+
+static void testEdgeSizes() {
+    std::mt19937 rng(7);
+    std::vector<Frame> sent;
+    std::vector<uint8_t> stream;
+    for (uint16_t length : {0, 1, 2, (int)MAX_PAYLOAD - 1, (int)MAX_PAYLOAD, 0}) {
+        Frame f;
+        f.type = 0x20 + length % 7;
+        f.payload.assign(length, FRAME_START_BYTE);
+        sent.push_back(f);
+        encode(f, stream);
+    }
+    // One byte past the limit is rejected as a length error, then resync
+    std::vector<uint8_t> tooLong = {FRAME_START_BYTE, 0x01, (MAX_PAYLOAD + 1) >> 8, (MAX_PAYLOAD + 1) & 0xFF};
+    stream.insert(stream.begin(), tooLong.begin(), tooLong.end());
+
+    Receiver rx;
+    rx.feed(stream, rng);
+    CHECK(rx.frames == sent, "edge sizes: %zu of %zu frames", rx.frames.size(), sent.size());
+    CHECK(rx.parser.stats().lengthErrors == 1, "edge sizes: %u length errors",
+          rx.parser.stats().lengthErrors);
+}
+
+// ============================================================
+// THROUGHPUT
+// ============================================================
+
+static void benchmark(const char* label, uint32_t noisePercent) {
+    std::mt19937 rng(1234);
+    std::vector<uint8_t> stream;
+    while (stream.size() < (4u << 20)) {
+        if (rng() % 100 < noisePercent) appendNoise(stream, rng);
+        encode(randomFrame(rng, 64), stream);  // Telemetry-sized frames
+    }
+
+    FrameParser<MAX_PAYLOAD> parser;
+    size_t frames = 0;
+    auto onFrame = [&frames](uint8_t, const uint8_t*, uint16_t) { frames++; };
+
+    const int passes = 5;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < passes; p++) {
+        for (size_t pos = 0; pos < stream.size(); pos += 128) {
+            parser.parse(stream.data() + pos, std::min<size_t>(128, stream.size() - pos), onFrame);
+        }
+        while (!parser.idle()) parser.expire(onFrame);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double bytesPerS = stream.size() * passes / seconds;
+
+    std::printf("  %-10s %7.1f MB/s, %6.0fx a 921600 baud link, %.2f us per 1 ms of link traffic\n",
+                label, bytesPerS / 1e6, bytesPerS / LINK_BYTES_PER_S,
+                LINK_BYTES_PER_S / 1000.0 / bytesPerS * 1e6);
+    CHECK(bytesPerS > LINK_BYTES_PER_S * 10, "%s: parser only %.1fx faster than the link", label,
+          bytesPerS / LINK_BYTES_PER_S);
+}
+
+int main() {
+    std::printf("Frame parser properties:\n");
+    for (uint32_t seed = 1; seed <= 5; seed++) {
+        testCleanStream(seed);
+        testNoiseBetweenFrames(seed);
+        testCorruptedFrames(seed);
+        testGarbage(seed);
+    }
+    testEdgeSizes();
+
+    std::printf("Throughput (host):\n");
+    benchmark("clean", 0);
+    benchmark("1% noise", 1);
+
+    return checkSummary("frame parser");
+}
@@ -0,0 +1,206 @@
+/**
+ * @file test_master_limiter.cpp
+ * @brief Host test for the master bus limiter (shared/audio/master_limiter.h)
+ *
+ * Renders dense, synthetic drum hit sequences into the limiter and checks:
+ * - no output sample exceeds the ceiling and nothing is clamped;
+ * - material below the ceiling passes bit-exact (only delayed);
+ * - gain reduction never goes deeper than the loudest peak needs;
+ * - the gain recovers after the dense section;
+ * - latency is exactly the lookahead.
+ * It also prints the host time per 256-frame block.
+ *
+ * Build and run (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Ishared/audio test/host/test_master_limiter.cpp -o /tmp/test_master_limiter
+ *   /tmp/test_master_limiter
+ */
+
+#include <master_limiter.h>
+
+#include "check.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const uint32_t SAMPLE_RATE = 44100;
+static const uint32_t BLOCK = 256;
+
+// ============================================================
+// SIGNAL GENERATION
+// ============================================================
+
+struct Render {
+    std::vector<int32_t> left;
+    std::vector<int32_t> right;
+};
+
+// Decaying noise + tone, like a drum one-shot, added at 'start' with a pan
+static void addHit(Render& r, uint32_t start, float amplitude, float pan, float freq,
+                   float decayMs, std::mt19937& rng) {
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    float gainL = std::cos(pan * (float)M_PI / 2.0f) * 1.41421356f;
+    float gainR = std::sin(pan * (float)M_PI / 2.0f) * 1.41421356f;
+    uint32_t length = (uint32_t)(SAMPLE_RATE * decayMs * 5.0f / 1000.0f);
+    for (uint32_t i = 0; i < length && start + i < r.left.size(); i++) {
+        float env = std::exp(-(float)i / (SAMPLE_RATE * decayMs / 1000.0f));
+        float x = amplitude * env * (0.6f * std::sin(2.0f * (float)M_PI * freq * i / SAMPLE_RATE) +
+                                     0.4f * noise(rng));
+        r.left[start + i] += (int32_t)(x * gainL);
+        r.right[start + i] += (int32_t)(x * gainR);
+    }
+}
+
+// Up to 12 overlapping voices hitting at 'bpm' sixteenths
+static Render denseSequence(uint32_t frames, float bpm, float amplitude, uint32_t seed) {
+    Render r;
+    r.left.assign(frames, 0);
+    r.right.assign(frames, 0);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    uint32_t step = (uint32_t)(SAMPLE_RATE * 60.0f / bpm / 4.0f);
+    for (uint32_t t = 0; t < frames; t += step) {
+        int voices = 1 + (int)(unit(rng) * 3);  // 1-3 pads per sixteenth, long tails overlap
+        for (int v = 0; v < voices; v++) {
+            float vel = 0.5f + 0.5f * unit(rng);
+            addHit(r, t, amplitude * vel, unit(rng), 60.0f + unit(rng) * 400.0f,
+                   20.0f + unit(rng) * 300.0f, rng);
+        }
+    }
+    return r;
+}
+
+struct Result {
+    std::vector<int16_t> out;   // Interleaved
+    MasterLimiterStats stats;
+    int32_t outPeak;
+    int32_t inPeak;
+};
+
+static Result runLimiter(MasterLimiter& limiter, const Render& r) {
+    Result res;
+    uint32_t frames = (uint32_t)r.left.size() / BLOCK * BLOCK;
+    res.out.assign(frames * 2, 0);
+    res.outPeak = 0;
+    res.inPeak = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        res.inPeak = std::max(res.inPeak, std::max(std::abs(r.left[i]), std::abs(r.right[i])));
+    }
+    for (uint32_t b = 0; b < frames; b += BLOCK) {
+        limiter.process(&r.left[b], &r.right[b], &res.out[b * 2], BLOCK);
+    }
+    for (int16_t s : res.out) res.outPeak = std::max<int32_t>(res.outPeak, std::abs((int32_t)s));
+    res.stats = limiter.getStats();
+    return res;
+}
+
+// ============================================================
+// TESTS
+// ============================================================
+
+static void testDenseNeverExceedsCeiling() {
+    // 12 voices at full velocity summed with no headroom: ~+12 dB over full scale
+    for (uint32_t seed = 1; seed <= 8; seed++) {
+        MasterLimiter limiter;
+        Render r = denseSequence(SAMPLE_RATE * 4, 180.0f, 32767.0f, seed);
+        Result res = runLimiter(limiter, r);
+
+        CHECK(res.inPeak > MASTER_LIMITER_CEILING, "seed %u: sequence not dense enough (peak %d)",
+              seed, res.inPeak);
+        CHECK(res.stats.clippedSamples == 0, "seed %u: %u samples clamped", seed,
+              res.stats.clippedSamples);
+        CHECK(res.outPeak <= MASTER_LIMITER_CEILING, "seed %u: output peak %d over ceiling", seed,
+              res.outPeak);
+
+        // Never reduce more than the loudest peak needs (1 LSB of Q15 slack)
+        int32_t needed = (int32_t)(((int64_t)MASTER_LIMITER_CEILING << 15) / res.inPeak);
+        CHECK(res.stats.minGain >= needed - 1, "seed %u: min gain %d below needed %d", seed,
+              res.stats.minGain, needed);
+
+        std::printf("  seed %u: in peak %6d (%+5.1f dBFS)  out peak %5d  max GR %5.1f dB\n", seed,
+                    res.inPeak, 20.0f * std::log10(res.inPeak / 32767.0f), res.outPeak,
+                    -masterLimiterReductionDb(res.stats.minGain));
+    }
+}
+
+static void testQuietMaterialIsBitExact() {
+    MasterLimiter limiter;
+    Render r = denseSequence(SAMPLE_RATE, 120.0f, 6000.0f, 42);
+    Result res = runLimiter(limiter, r);
+
+    CHECK(res.inPeak <= MASTER_LIMITER_CEILING, "quiet sequence too loud (%d)", res.inPeak);
+    CHECK(res.stats.minGain == MASTER_LIMITER_UNITY, "gain moved on quiet material (%d)",
+          res.stats.minGain);
+
+    uint32_t frames = (uint32_t)res.out.size() / 2;
+    uint32_t mismatches = 0;
+    for (uint32_t i = MASTER_LIMITER_LOOKAHEAD_FRAMES; i < frames; i++) {
+        uint32_t src = i - MASTER_LIMITER_LOOKAHEAD_FRAMES;
+        if (res.out[i * 2] != r.left[src] || res.out[i * 2 + 1] != r.right[src]) mismatches++;
+    }
+    CHECK(mismatches == 0, "%u frames differ from the delayed input", mismatches);
+}
+
+static void testLatencyIsLookahead() {
+    MasterLimiter limiter;
+    Render r;
+    r.left.assign(BLOCK * 2, 0);
+    r.right.assign(BLOCK * 2, 0);
+    r.left[10] = 1000;
+    r.right[10] = -1000;
+    Result res = runLimiter(limiter, r);
+
+    uint32_t at = 10 + MASTER_LIMITER_LOOKAHEAD_FRAMES;
+    CHECK(res.out[at * 2] == 1000 && res.out[at * 2 + 1] == -1000, "impulse not at frame %u", at);
+}
+
+static void testGainRecovers() {
+    MasterLimiter limiter;
+    uint32_t dense = SAMPLE_RATE * 2;
+    Render r = denseSequence(dense, 200.0f, 32767.0f, 7);
+    Result loud = runLimiter(limiter, r);
+    CHECK(loud.stats.minGain < MASTER_LIMITER_UNITY, "dense section did not engage the limiter");
+
+    // Then 300 ms of silence: the release must bring gain back within 1 dB of unity
+    Render silence;
+    silence.left.assign(SAMPLE_RATE * 3 / 10, 0);
+    silence.right.assign(SAMPLE_RATE * 3 / 10, 0);
+    Result quiet = runLimiter(limiter, silence);
+    float reduction = -masterLimiterReductionDb(quiet.stats.gain);
+    CHECK(reduction < 1.0f, "gain still %.2f dB down after 300 ms", reduction);
+}
+
+static void benchmark() {
+    MasterLimiter limiter;
+    Render r = denseSequence(SAMPLE_RATE * 10, 180.0f, 32767.0f, 3);
+    std::vector<int16_t> out(BLOCK * 2);
+    uint32_t blocks = (uint32_t)r.left.size() / BLOCK;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 10; pass++) {
+        for (uint32_t b = 0; b < blocks; b++) {
+            limiter.process(&r.left[b * BLOCK], &r.right[b * BLOCK], out.data(), BLOCK);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / (blocks * 10.0);
+    std::printf("  host: %.0f ns per %u-frame block\n", ns, BLOCK);
+}
+
+int main() {
+    std::printf("[limiter] dense sequences\n");
+    testDenseNeverExceedsCeiling();
+    std::printf("[limiter] quiet material\n");
+    testQuietMaterialIsBitExact();
+    std::printf("[limiter] latency\n");
+    testLatencyIsLookahead();
+    std::printf("[limiter] release\n");
+    testGainRecovers();
+    std::printf("[limiter] benchmark\n");
+    benchmark();
+
+    return checkSummary("limiter");
+}
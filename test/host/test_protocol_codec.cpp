@@ -0,0 +1,415 @@
+/**
+ * @file test_protocol_codec.cpp
+ * @brief Host interop test for the shared UART codec (shared/protocol/frame_codec.h, gui_protocol.h)
+ *
+ * Both firmwares encode with frameEncode()/encodeMessage() and decode with
+ * FrameParser + decodeMessage(). This test checks that:
+ * - the table CRC matches the bit-by-bit CRC-16-CCITT it replaced
+ *   (and the standard check value 0x29B1 for "123456789");
+ * - every frame is byte-identical to the old header/payload/CRC writes, so
+ *   a board on the new codec still talks to one on the old code;
+ * - every descriptor message sent by one side comes out of the other
+ *   side's parser with the same type, length and contents, in both
+ *   directions and in random chunk sizes;
+ * - decodeMessage() rejects the wrong type and the wrong length, and
+ *   frameEncode() rejects a buffer that is too small;
+ * - MSG_TELEMETRY_BATCH frames unpack into the same records, in order, and
+ *   a truncated batch or an unknown record type stops the walk;
+ * - MSG_CONFIG_DELTA records rebuild the sender's PadConfigWire on the
+ *   receiver, unknown fields are skipped, text fields are bounded, and a
+ *   wrong version or a truncated record is rejected.
+ * It also compares table and bitwise CRC throughput.
+ *
+ * Build and run (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Ishared/protocol test/host/test_protocol_codec.cpp -o /tmp/test_protocol_codec
+ *   /tmp/test_protocol_codec
+ */
+
+#include <gui_protocol.h>
+
+#include "check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// ============================================================
+// REFERENCE (the per-firmware code the codec replaced)
+// ============================================================
+
+static uint16_t bitwiseCrc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ 0x1021;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+// Header, payload and CRC as separate writes, like the old sendMessage()
+static std::vector<uint8_t> legacyEncode(uint8_t type, const void* payload, uint16_t length) {
+    uint8_t header[4] = {FRAME_START_BYTE, type, (uint8_t)(length >> 8), (uint8_t)(length & 0xFF)};
+    uint16_t crc = bitwiseCrc16(header, 4);
+    crc = bitwiseCrc16((const uint8_t*)payload, length, crc);
+
+    std::vector<uint8_t> out(4 + length + 2);
+    memcpy(out.data(), header, 4);
+    if (length > 0) memcpy(out.data() + 4, payload, length);
+    out[4 + length] = crc >> 8;
+    out[5 + length] = crc & 0xFF;
+    return out;
+}
+
+// ============================================================
+// ENDPOINTS
+// ============================================================
+
+struct Received {
+    uint8_t type;
+    std::vector<uint8_t> payload;
+};
+
+// One side of the link: encodes into its own TX buffer like the firmware
+// does, and parses what the other side wrote
+struct Endpoint {
+    uint8_t txBuffer[frameSize(UART_MAX_PAYLOAD)];
+    FrameParser<UART_MAX_PAYLOAD> parser;
+    std::vector<Received> received;
+
+    template <typename Msg>
+    void send(const Msg& msg, std::vector<uint8_t>& wire) {
+        size_t n = encodeMessage(txBuffer, sizeof(txBuffer), msg);
+        CHECK(n == frameSize(MessageTraits<Msg>::SIZE), "type 0x%02X: encoded %zu bytes",
+              MessageTraits<Msg>::TYPE, n);
+        wire.insert(wire.end(), txBuffer, txBuffer + n);
+    }
+
+    void receive(const std::vector<uint8_t>& wire, std::mt19937& rng) {
+        auto onFrame = [this](uint8_t type, const uint8_t* payload, uint16_t length) {
+            received.push_back(Received{type, std::vector<uint8_t>(payload, payload + length)});
+        };
+        for (size_t pos = 0; pos < wire.size();) {
+            size_t n = std::min<size_t>(1 + rng() % 64, wire.size() - pos);
+            parser.parse(wire.data() + pos, n, onFrame);
+            pos += n;
+        }
+    }
+};
+
+template <typename Msg>
+static Msg randomMessage(std::mt19937& rng) {
+    Msg msg;
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&msg);
+    for (size_t i = 0; i < sizeof(Msg); i++) bytes[i] = rng() % 4 == 0 ? FRAME_START_BYTE : (rng() & 0xFF);
+    return msg;
+}
+
+// Sends 'count' random Msg from 'from' to 'to' and checks every one decodes
+// to the same bytes with the size the descriptor table lists
+template <typename Msg>
+static void roundTrip(Endpoint& from, Endpoint& to, std::mt19937& rng, int count) {
+    std::vector<Msg> sent;
+    std::vector<uint8_t> wire;
+    for (int i = 0; i < count; i++) {
+        sent.push_back(randomMessage<Msg>(rng));
+        from.send(sent.back(), wire);
+
+        // Same bytes as the old four-write encoder
+        std::vector<uint8_t> legacy = legacyEncode(MessageTraits<Msg>::TYPE, &sent.back(), sizeof(Msg));
+        CHECK(std::equal(legacy.begin(), legacy.end(), wire.end() - legacy.size()),
+              "type 0x%02X: frame differs from the legacy encoder", MessageTraits<Msg>::TYPE);
+    }
+
+    to.received.clear();
+    to.receive(wire, rng);
+    CHECK(to.received.size() == sent.size(), "type 0x%02X: %zu of %zu frames", MessageTraits<Msg>::TYPE,
+          to.received.size(), sent.size());
+
+    for (size_t i = 0; i < to.received.size() && i < sent.size(); i++) {
+        const Received& r = to.received[i];
+        const Msg* msg = decodeMessage<Msg>(r.type, r.payload.data(), r.payload.size());
+        CHECK(msg && memcmp(msg, &sent[i], sizeof(Msg)) == 0, "type 0x%02X: frame %zu differs",
+              MessageTraits<Msg>::TYPE, i);
+        CHECK(messagePayloadSize(r.type) == sizeof(Msg), "type 0x%02X: descriptor size %u",
+              MessageTraits<Msg>::TYPE, messagePayloadSize(r.type));
+    }
+}
+
+static void testCrc() {
+    const char* check = "123456789";
+    CHECK(frameCrc16((const uint8_t*)check, 9) == 0x29B1, "CRC check value 0x%04X", frameCrc16((const uint8_t*)check, 9));
+
+    std::mt19937 rng(3);
+    std::vector<uint8_t> data(4096);
+    for (auto& b : data) b = rng() & 0xFF;
+    for (size_t length : {0, 1, 2, 4, 7, 64, 1000, 4096}) {
+        CHECK(frameCrc16(data.data(), length) == bitwiseCrc16(data.data(), length), "CRC differs at %zu bytes", length);
+    }
+    // Chained over header then payload, as both senders used to do it
+    uint16_t chained = frameCrc16(data.data() + 4, 60, frameCrc16(data.data(), 4));
+    CHECK(chained == bitwiseCrc16(data.data(), 64), "chained CRC differs");
+}
+
+static void testInterop() {
+    std::mt19937 rng(11);
+    Endpoint brain, display;
+
+#define ROUND_TRIP_MAIN_TO_DISPLAY(id, msgType, size) \
+    if (id < CMD_SET_THRESHOLD || id >= MSG_MENU_STATE) roundTrip<msgType>(brain, display, rng, 500);
+#define ROUND_TRIP_DISPLAY_TO_MAIN(id, msgType, size) \
+    if (id >= CMD_SET_THRESHOLD && id < MSG_MENU_STATE) roundTrip<msgType>(display, brain, rng, 500);
+    GUI_MESSAGE_TABLE(ROUND_TRIP_MAIN_TO_DISPLAY)
+    GUI_MESSAGE_TABLE(ROUND_TRIP_DISPLAY_TO_MAIN)
+#undef ROUND_TRIP_MAIN_TO_DISPLAY
+#undef ROUND_TRIP_DISPLAY_TO_MAIN
+
+    CHECK(brain.parser.stats().crcErrors == 0 && display.parser.stats().crcErrors == 0,
+          "CRC errors on a clean link: %u / %u", brain.parser.stats().crcErrors,
+          display.parser.stats().crcErrors);
+}
+
+static void testVariableAndRejects() {
+    std::mt19937 rng(5);
+    Endpoint brain, display;
+
+    // Variable-length payloads (ACK, NACK text, JSON) go through frameEncode
+    std::vector<uint8_t> wire;
+    const char* json = "{\"pads\":[{\"threshold\":120}]}";
+    uint8_t ack = CMD_SET_THRESHOLD;
+    size_t n = frameEncode(brain.txBuffer, sizeof(brain.txBuffer), MSG_CONFIG_DUMP, json, strlen(json) + 1);
+    wire.insert(wire.end(), brain.txBuffer, brain.txBuffer + n);
+    n = frameEncode(brain.txBuffer, sizeof(brain.txBuffer), MSG_ACK, &ack, 1);
+    wire.insert(wire.end(), brain.txBuffer, brain.txBuffer + n);
+    n = frameEncode(brain.txBuffer, sizeof(brain.txBuffer), CMD_GET_CONFIG, nullptr, 0);
+    wire.insert(wire.end(), brain.txBuffer, brain.txBuffer + n);
+    std::vector<uint8_t> big(UART_MAX_PAYLOAD, FRAME_START_BYTE);
+    n = frameEncode(brain.txBuffer, sizeof(brain.txBuffer), MSG_CONFIG_DUMP, big.data(), big.size());
+    CHECK(n == frameSize(UART_MAX_PAYLOAD), "max payload: encoded %zu bytes", n);
+    wire.insert(wire.end(), brain.txBuffer, brain.txBuffer + n);
+
+    display.receive(wire, rng);
+    CHECK(display.received.size() == 4, "variable-length: %zu of 4 frames", display.received.size());
+    if (display.received.size() == 4) {
+        CHECK(strcmp((const char*)display.received[0].payload.data(), json) == 0, "JSON payload differs");
+        CHECK(display.received[1].type == MSG_ACK && display.received[1].payload[0] == ack, "ACK differs");
+        CHECK(display.received[2].type == CMD_GET_CONFIG && display.received[2].payload.empty(),
+              "empty command differs");
+        CHECK(display.received[3].payload == big, "max payload differs");
+        CHECK(messagePayloadSize(MSG_CONFIG_DUMP) == 0, "JSON dump listed as fixed-size");
+    }
+
+    // Too small a buffer: nothing written
+    uint8_t small[frameSize(sizeof(HitEventMsg)) - 1];
+    CHECK(encodeMessage(small, sizeof(small), HitEventMsg{}) == 0, "encoded into a short buffer");
+    CHECK(frameEncode(small, sizeof(small), MSG_ACK, nullptr, 1) == 0, "encoded a null payload");
+
+    // Wrong type or length never yields a typed view
+    HitEventMsg hit = {};
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&hit);
+    CHECK(decodeMessage<HitEventMsg>(MSG_HIT_EVENT, raw, sizeof(hit)) != nullptr, "valid hit rejected");
+    CHECK(decodeMessage<HitEventMsg>(MSG_PAD_STATE, raw, sizeof(hit)) == nullptr, "wrong type accepted");
+    CHECK(decodeMessage<HitEventMsg>(MSG_HIT_EVENT, raw, sizeof(hit) - 1) == nullptr, "short payload accepted");
+    CHECK(decodeMessage<HitEventMsg>(MSG_HIT_EVENT, raw, sizeof(hit) + 1) == nullptr, "long payload accepted");
+}
+
+static void testTelemetryBatch() {
+    std::mt19937 rng(21);
+    Endpoint brain, display;
+
+    // Roll on all pads plus the per-tick extras, as the TX scheduler packs them
+    std::vector<Received> sent;
+    std::vector<uint8_t> wire;
+    for (int tick = 0; tick < 200; tick++) {
+        uint8_t* body = frameBody(brain.txBuffer);
+        size_t used = 0;
+        size_t capacity = 1 + rng() % 400;  // Free TX space varies per tick
+        auto add = [&](auto msg) {
+            size_t next = batchAppend(body, used, capacity, msg);
+            if (next == used) return;
+            sent.push_back(Received{body[used], std::vector<uint8_t>(body + used + 1, body + next)});
+            used = next;
+        };
+        for (int i = 0, hits = rng() % 12; i < hits; i++) add(randomMessage<HitEventMsg>(rng));
+        for (int i = 0; i < 4; i++) add(randomMessage<PadStateMsg>(rng));
+        if (tick % 6 == 0) add(randomMessage<MixerMetersMsg>(rng));
+        if (tick % 50 == 0) add(randomMessage<TempoMsg>(rng));
+        if (tick % 200 == 0) add(randomMessage<SystemStatusMsg>(rng));
+        CHECK(used <= capacity, "batch %zu bytes over a %zu byte budget", used, capacity);
+        if (used == 0) continue;
+        size_t n = frameSeal(brain.txBuffer, MSG_TELEMETRY_BATCH, used);
+        wire.insert(wire.end(), brain.txBuffer, brain.txBuffer + n);
+    }
+
+    display.receive(wire, rng);
+    std::vector<Received> unpacked;
+    for (const Received& frame : display.received) {
+        CHECK(frame.type == MSG_TELEMETRY_BATCH, "unexpected frame type 0x%02X", frame.type);
+        bool ok = forEachBatchRecord(frame.payload.data(), frame.payload.size(),
+                                     [&](uint8_t type, const uint8_t* record, uint16_t size) {
+                                         unpacked.push_back(Received{type, std::vector<uint8_t>(record, record + size)});
+                                     });
+        CHECK(ok, "valid batch rejected");
+    }
+    CHECK(unpacked.size() == sent.size(), "batch: %zu of %zu records", unpacked.size(), sent.size());
+    bool same = unpacked.size() == sent.size();
+    for (size_t i = 0; same && i < sent.size(); i++) {
+        same = unpacked[i].type == sent[i].type && unpacked[i].payload == sent[i].payload;
+    }
+    CHECK(same, "batch records differ");
+
+    // Truncated record and unknown type: records before them still arrive
+    uint8_t body[64];
+    size_t used = batchAppend(body, 0, sizeof(body), HitEventMsg{});
+    size_t whole = used;
+    used = batchAppend(body, used, sizeof(body), PadStateMsg{});
+    int seen = 0;
+    auto count = [&seen](uint8_t, const uint8_t*, uint16_t) { seen++; };
+    CHECK(!forEachBatchRecord(body, used - 1, count) && seen == 1, "truncated batch: %d records", seen);
+    body[whole] = MSG_CONFIG_DUMP;
+    seen = 0;
+    CHECK(!forEachBatchRecord(body, used, count) && seen == 1, "unknown record type: %d records", seen);
+}
+
+// ============================================================
+// CONFIG SYNC
+// ============================================================
+
+static void testConfigSync() {
+    CHECK(sizeof(PadConfigWire) == 80, "PadConfigWire is %zu bytes", sizeof(PadConfigWire));
+    CHECK(messagePayloadSize(MSG_CONFIG_SNAPSHOT) == sizeof(ConfigSnapshotMsg), "snapshot size mismatch");
+
+    std::mt19937 rng(11);
+    std::vector<uint8_t> fields;
+#define CONFIG_FIELD_LIST(id, wireId, member) fields.push_back(id);
+    CONFIG_FIELD_TABLE(CONFIG_FIELD_LIST)
+#undef CONFIG_FIELD_LIST
+
+    // Random edits on the sender, shipped as deltas of 1-3 fields
+    PadConfigWire sender[CONFIG_SNAPSHOT_PADS];
+    PadConfigWire mirror[CONFIG_SNAPSHOT_PADS];
+    memset(sender, 0, sizeof(sender));
+    memset(mirror, 0, sizeof(mirror));
+    size_t deltaBytes = 0;
+    int deltas = 0;
+    for (uint32_t generation = 1; generation <= 2000; generation++) {
+        uint8_t pad = rng() % CONFIG_SNAPSHOT_PADS;
+        uint8_t body[128];
+        size_t used = configDeltaBegin(body, generation);
+        for (int i = 0, n = 1 + rng() % 3; i < n; i++) {
+            uint8_t field = fields[rng() % fields.size()];
+            ConfigFieldInfo info = {};
+            CHECK(configFieldInfo(field, info), "field 0x%02X missing from the table", field);
+            uint8_t* target = reinterpret_cast<uint8_t*>(&sender[pad]) + info.offset;
+            if (info.text) {
+                size_t length = rng() % info.size;  // Up to size - 1 characters
+                memset(target, 0, info.size);
+                for (size_t c = 0; c < length; c++) target[c] = 'a' + rng() % 26;
+            } else {
+                for (size_t b = 0; b < info.size; b++) target[b] = rng() & 0xFF;
+            }
+            used = configDeltaAppend(body, used, sizeof(body), pad, field, sender[pad]);
+        }
+
+        uint32_t received = 0;
+        bool ok = forEachConfigDelta(body, used, received,
+                                     [&](uint8_t padId, uint8_t field, const uint8_t* value, uint8_t length) {
+                                         CHECK(configApplyField(mirror[padId], field, value, length),
+                                               "field 0x%02X rejected", field);
+                                     });
+        CHECK(ok && received == generation, "delta %u rejected", generation);
+        deltaBytes += frameSize(used);
+        deltas++;
+    }
+    CHECK(memcmp(sender, mirror, sizeof(sender)) == 0, "mirror differs from sender after deltas");
+
+    // A single threshold edit against the JSON it replaces
+    uint8_t body[64];
+    size_t used = configDeltaBegin(body, 1);
+    used = configDeltaAppend(body, used, sizeof(body), 0, CFG_THRESHOLD, sender[0]);
+    const char* json = "{\"padId\":0,\"threshold\":120,\"velocityMin\":40,\"velocityMax\":3800}";
+    std::printf("  config delta: avg %.1f bytes per frame, threshold edit %zu bytes (JSON pad update ~%zu)\n",
+                double(deltaBytes) / deltas, frameSize(used), frameSize(strlen(json)));
+
+    // Unknown field (newer sender): skipped by length, the rest still applies
+    used = configDeltaBegin(body, 7);
+    body[used++] = 1;
+    body[used++] = 0x7F;
+    body[used++] = 2;
+    body[used++] = 0xDE;
+    body[used++] = 0xAD;
+    used = configDeltaAppend(body, used, sizeof(body), 1, CFG_MIDI_NOTE, sender[1]);
+    int applied = 0, unknown = 0;
+    uint32_t generation = 0;
+    PadConfigWire pad;
+    memset(&pad, 0, sizeof(pad));
+    auto apply = [&](uint8_t, uint8_t field, const uint8_t* value, uint8_t length) {
+        if (configApplyField(pad, field, value, length)) applied++;
+        else unknown++;
+    };
+    CHECK(forEachConfigDelta(body, used, generation, apply) && applied == 1 && unknown == 1 &&
+              pad.midiNote == sender[1].midiNote && generation == 7,
+          "unknown field: %d applied, %d unknown", applied, unknown);
+
+    // Truncated record: the records before it still arrive
+    applied = unknown = 0;
+    CHECK(!forEachConfigDelta(body, used - 1, generation, apply) && applied + unknown == 1,
+          "truncated delta: %d records", applied + unknown);
+
+    // Wrong version: nothing is delivered
+    body[0] = CONFIG_SYNC_VERSION + 1;
+    applied = unknown = 0;
+    CHECK(!forEachConfigDelta(body, used, generation, apply) && applied + unknown == 0,
+          "wrong version accepted");
+
+    // Text must leave room for the NUL; fixed fields must match exactly
+    char longName[sizeof(PadConfigWire::name)];
+    memset(longName, 'x', sizeof(longName));
+    CHECK(!configApplyField(pad, CFG_NAME, (const uint8_t*)longName, sizeof(longName)), "unterminated name accepted");
+    CHECK(configApplyField(pad, CFG_NAME, (const uint8_t*)"Kick", 4) && strcmp(pad.name, "Kick") == 0,
+          "short name not applied");
+    uint8_t threshold[3] = {1, 2, 3};
+    CHECK(!configApplyField(pad, CFG_THRESHOLD, threshold, 3), "oversized threshold accepted");
+}
+
+// ============================================================
+// THROUGHPUT
+// ============================================================
+
+static void benchmarkCrc() {
+    std::vector<uint8_t> data(1 << 20);
+    std::mt19937 rng(9);
+    for (auto& b : data) b = rng() & 0xFF;
+
+    const int passes = 20;
+    volatile uint16_t sink = 0;
+    auto time = [&](uint16_t (*crc)(const uint8_t*, size_t, uint16_t)) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int p = 0; p < passes; p++) sink = sink + crc(data.data(), data.size(), 0xFFFF);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return data.size() * passes / seconds;
+    };
+    double bitwise = time(bitwiseCrc16);
+    double table = time(frameCrc16);
+    std::printf("  CRC bitwise %7.1f MB/s, table %7.1f MB/s (%.1fx)\n", bitwise / 1e6, table / 1e6,
+                table / bitwise);
+    CHECK(table > bitwise, "table CRC slower than bitwise");
+}
+
+int main() {
+    std::printf("Protocol codec:\n");
+    testCrc();
+    testInterop();
+    testVariableAndRejects();
+    testTelemetryBatch();
+    testConfigSync();
+    benchmarkCrc();
+
+    return checkSummary("protocol codec");
+}
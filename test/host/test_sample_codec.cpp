@@ -0,0 +1,209 @@
+/**
+ * @file test_sample_codec.cpp
+ * @brief Host test and benchmark for the PSRAM sample codecs (shared/audio/sample_codec.h)
+ *
+ * Encodes synthetic drum one-shots (mono and stereo) with every codec and:
+ * - checks that each block decodes on its own to the same frames as a
+ *   sequential decode, and that the sizes match sampleCodecBytes();
+ * - checks that PCM12 is bit-exact on blocks that fit in 12 bits;
+ * - prints size, SNR and decode throughput per codec, so each kit can be
+ *   packed trading PSRAM for CPU (kit_packer --codec).
+ *
+ * Build and run (from the repository root):
+ *   g++ -std=c++17 -O2 -Wall -Ishared/audio test/host/test_sample_codec.cpp -o /tmp/test_sample_codec
+ *   /tmp/test_sample_codec
+ */
+
+#include <sample_codec.h>
+
+#include "check.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+static const uint32_t SAMPLE_RATE = 44100;
+
+// ============================================================
+// SIGNAL GENERATION
+// ============================================================
+
+struct TestSample {
+    const char* name;
+    std::vector<int16_t> pcm;   // Interleaved
+    uint32_t frames;
+    uint8_t channels;
+};
+
+// Decaying tone + noise, like a drum one-shot. Stereo gets a slightly
+// different noise per side, as a real overhead recording would.
+static TestSample drumHit(const char* name, uint8_t channels, float amplitude, float freq,
+                          float decayMs, float noiseMix, uint32_t seed) {
+    TestSample s;
+    s.name = name;
+    s.channels = channels;
+    s.frames = (uint32_t)(SAMPLE_RATE * decayMs * 6.0f / 1000.0f) + 37;  // Partial last block
+    s.pcm.resize((size_t)s.frames * channels);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (uint32_t i = 0; i < s.frames; i++) {
+        float env = std::exp(-(float)i / (SAMPLE_RATE * decayMs / 1000.0f));
+        float tone = std::sin(2.0f * (float)M_PI * freq * i / SAMPLE_RATE);
+        for (uint8_t c = 0; c < channels; c++) {
+            float x = amplitude * env * ((1.0f - noiseMix) * tone + noiseMix * noise(rng));
+            s.pcm[(size_t)i * channels + c] = (int16_t)std::max(-32767.0f, std::min(32767.0f, x));
+        }
+    }
+    return s;
+}
+
+static std::vector<TestSample> testSamples() {
+    std::vector<TestSample> v;
+    v.push_back(drumHit("kick (mono)", 1, 30000.0f, 55.0f, 120.0f, 0.1f, 1));
+    v.push_back(drumHit("snare (mono)", 1, 26000.0f, 190.0f, 80.0f, 0.7f, 2));
+    v.push_back(drumHit("tom (stereo)", 2, 24000.0f, 110.0f, 250.0f, 0.2f, 3));
+    v.push_back(drumHit("crash (stereo)", 2, 20000.0f, 3000.0f, 900.0f, 0.95f, 4));
+    v.push_back(drumHit("ghost (mono)", 1, 1500.0f, 190.0f, 60.0f, 0.7f, 5));
+    return v;
+}
+
+// ============================================================
+// HELPERS
+// ============================================================
+
+static std::vector<uint8_t> encode(uint8_t format, const TestSample& s) {
+    std::vector<uint8_t> coded(sampleCodecBytes(format, s.frames, s.channels));
+    sampleCodecEncode(format, s.pcm.data(), s.frames, s.channels, coded.data());
+    return coded;
+}
+
+static std::vector<int16_t> decodeAll(uint8_t format, const TestSample& s, const std::vector<uint8_t>& coded) {
+    uint32_t blockBytes = sampleCodecBlockBytes(format, s.channels);
+    uint32_t blocks = sampleCodecBlocks(s.frames);
+    std::vector<int16_t> out((size_t)blocks * SAMPLE_CODEC_BLOCK * s.channels);
+    for (uint32_t b = 0; b < blocks; b++) {
+        sampleCodecDecodeBlock(format, s.channels, coded.data() + (size_t)b * blockBytes,
+                               &out[(size_t)b * SAMPLE_CODEC_BLOCK * s.channels]);
+    }
+    out.resize(s.pcm.size());
+    return out;
+}
+
+static double snrDb(const std::vector<int16_t>& ref, const std::vector<int16_t>& test) {
+    double signal = 0.0, error = 0.0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        double d = (double)ref[i] - test[i];
+        signal += (double)ref[i] * ref[i];
+        error += d * d;
+    }
+    if (error == 0.0) return INFINITY;
+    return 10.0 * std::log10(signal / error);
+}
+
+// ============================================================
+// TESTS
+// ============================================================
+
+static void testSizes() {
+    for (uint8_t ch = 1; ch <= 2; ch++) {
+        CHECK(sampleCodecBlockBytes(KIT_FORMAT_PCM12, ch) == 4 + 384u * ch, "PCM12 block size (%u ch)", ch);
+        CHECK(sampleCodecBlockBytes(KIT_FORMAT_ADPCM4, ch) == 132u * ch, "ADPCM block size (%u ch)", ch);
+    }
+    CHECK(sampleCodecBytes(KIT_FORMAT_PCM16, 1000, 2) == 4000, "PCM16 size");
+    CHECK(sampleCodecBytes(KIT_FORMAT_ADPCM4, 257, 1) == 2 * 132, "partial block not rounded up");
+}
+
+static void testRandomAccess() {
+    // Each block must decode alone to what a front-to-back decode gives
+    for (const TestSample& s : testSamples()) {
+        for (uint8_t format : {KIT_FORMAT_PCM12, KIT_FORMAT_ADPCM4}) {
+            std::vector<uint8_t> coded = encode(format, s);
+            std::vector<int16_t> all = decodeAll(format, s, coded);
+            uint32_t blockBytes = sampleCodecBlockBytes(format, s.channels);
+            uint32_t blocks = sampleCodecBlocks(s.frames);
+            int16_t block[SAMPLE_CODEC_BLOCK * 2];
+            uint32_t mismatches = 0;
+            for (uint32_t b = blocks; b-- > 0;) {
+                sampleCodecDecodeBlock(format, s.channels, coded.data() + (size_t)b * blockBytes, block);
+                for (uint32_t i = 0; i < SAMPLE_CODEC_BLOCK * s.channels; i++) {
+                    size_t at = (size_t)b * SAMPLE_CODEC_BLOCK * s.channels + i;
+                    if (at < all.size() && all[at] != block[i]) mismatches++;
+                }
+            }
+            CHECK(mismatches == 0, "%s %s: %u samples differ on random access", s.name,
+                  sampleCodecName(format), mismatches);
+        }
+    }
+}
+
+static void testPcm12Lossless() {
+    // Peak below 2048: every block keeps shift 0
+    TestSample quiet = drumHit("quiet", 2, 2000.0f, 300.0f, 50.0f, 0.5f, 9);
+    std::vector<int16_t> out = decodeAll(KIT_FORMAT_PCM12, quiet, encode(KIT_FORMAT_PCM12, quiet));
+    CHECK(out == quiet.pcm, "PCM12 not bit-exact on 12-bit material");
+
+    // Full-scale extremes survive the shift and the rounding
+    TestSample extremes;
+    extremes.name = "extremes";
+    extremes.channels = 1;
+    extremes.frames = SAMPLE_CODEC_BLOCK;
+    extremes.pcm.assign(SAMPLE_CODEC_BLOCK, 0);
+    extremes.pcm[0] = 32767;
+    extremes.pcm[1] = -32768;
+    out = decodeAll(KIT_FORMAT_PCM12, extremes, encode(KIT_FORMAT_PCM12, extremes));
+    CHECK(out[0] >= 32752 && out[1] == -32768, "PCM12 extremes decoded as %d %d", out[0], out[1]);
+}
+
+static void report() {
+    std::printf("  %-16s %-6s %9s %7s %8s %12s\n", "sample", "codec", "bytes", "ratio", "SNR dB", "Mframes/s");
+    for (const TestSample& s : testSamples()) {
+        uint32_t pcmBytes = sampleCodecBytes(KIT_FORMAT_PCM16, s.frames, s.channels);
+        for (uint8_t format : {KIT_FORMAT_PCM12, KIT_FORMAT_ADPCM4}) {
+            std::vector<uint8_t> coded = encode(format, s);
+            std::vector<int16_t> out = decodeAll(format, s, coded);
+            double snr = snrDb(s.pcm, out);
+
+            // Throughput: decode the whole sample repeatedly, as the mixer does block by block
+            uint32_t blockBytes = sampleCodecBlockBytes(format, s.channels);
+            uint32_t blocks = sampleCodecBlocks(s.frames);
+            int16_t block[SAMPLE_CODEC_BLOCK * 2];
+            volatile int16_t sink = 0;
+            int passes = 0;
+            auto start = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed{};
+            do {
+                for (uint32_t b = 0; b < blocks; b++) {
+                    sampleCodecDecodeBlock(format, s.channels, coded.data() + (size_t)b * blockBytes, block);
+                    sink = sink + block[b & 127];
+                }
+                passes++;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while (elapsed.count() < 0.05);
+            double mframes = (double)blocks * SAMPLE_CODEC_BLOCK * passes / elapsed.count() / 1e6;
+
+            std::printf("  %-16s %-6s %9zu %6.1f%% %8.1f %12.1f\n", s.name, sampleCodecName(format),
+                        coded.size(), 100.0 * coded.size() / pcmBytes, snr, mframes);
+
+            // Regression floors. IMA-ADPCM is ~15 dB on noise-like material
+            // (snares, cymbals): fine in a dense mix, audible on solo cymbals.
+            double floor = format == KIT_FORMAT_PCM12 ? 60.0 : 12.0;
+            CHECK(snr >= floor, "%s %s: SNR %.1f dB under %.0f dB", s.name, sampleCodecName(format), snr, floor);
+        }
+    }
+}
+
+int main() {
+    std::printf("[codec] sizes\n");
+    testSizes();
+    std::printf("[codec] random access\n");
+    testRandomAccess();
+    std::printf("[codec] pcm12 lossless\n");
+    testPcm12Lossless();
+    std::printf("[codec] size / quality / throughput\n");
+    report();
+
+    return checkSummary("codec");
+}
@@ -0,0 +1,170 @@
+/**
+ * @file wav_file.h
+ * @brief Minimal WAV reader/writer for the host-side tools
+ *
+ * Reads PCM 8/16/24/32-bit integer and 32-bit float WAV files (including
+ * WAVE_FORMAT_EXTENSIBLE) and converts them to interleaved signed 16-bit,
+ * which is the format the main brain mixes. Loop points are taken from the
+ * first loop of a 'smpl' chunk when present.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace wav {
+
+struct Audio {
+    std::vector<int16_t> pcm;   // Interleaved
+    uint32_t frames = 0;
+    uint32_t sampleRate = 0;
+    uint8_t channels = 0;
+    uint32_t loopStart = 0;
+    uint32_t loopEnd = 0;       // 0 = no loop
+};
+
+inline uint16_t le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t le32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+inline int16_t clamp16(double v) {
+    long r = std::lround(v);
+    if (r > 32767) return 32767;
+    if (r < -32768) return -32768;
+    return (int16_t)r;
+}
+
+/**
+ * @brief Load a WAV file and convert it to interleaved int16
+ * @param error Receives a human-readable reason on failure
+ */
+inline bool read(const std::string& path, Audio& out, std::string& error) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> file;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) file.insert(file.end(), buf, buf + n);
+    std::fclose(f);
+
+    if (file.size() < 12 || std::memcmp(file.data(), "RIFF", 4) != 0 || std::memcmp(file.data() + 8, "WAVE", 4) != 0) {
+        error = path + " is not a RIFF/WAVE file";
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    const uint8_t* data = nullptr;
+    uint32_t dataSize = 0;
+
+    size_t pos = 12;
+    while (pos + 8 <= file.size()) {
+        const uint8_t* chunk = file.data() + pos;
+        uint32_t size = le32(chunk + 4);
+        const uint8_t* body = chunk + 8;
+        size_t avail = file.size() - (pos + 8);
+        if (size > avail) size = (uint32_t)avail;  // Truncated file: use what is there
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            format = le16(body);
+            channels = le16(body + 2);
+            rate = le32(body + 4);
+            bits = le16(body + 14);
+            if (format == 0xFFFE && size >= 26) {
+                format = le16(body + 24);  // SubFormat GUID starts with the real format tag
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            data = body;
+            dataSize = size;
+        } else if (std::memcmp(chunk, "smpl", 4) == 0 && size >= 36 + 24) {
+            uint32_t loops = le32(body + 28);
+            if (loops > 0) {
+                out.loopStart = le32(body + 36 + 8);
+                out.loopEnd = le32(body + 36 + 12);
+            }
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    if (!data || channels == 0 || rate == 0) {
+        error = path + " has no fmt/data chunk";
+        return false;
+    }
+    if (channels > 2) {
+        error = path + ": only mono and stereo are supported";
+        return false;
+    }
+    bool isFloat = (format == 3 && bits == 32);
+    bool isInt = (format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32));
+    if (!isFloat && !isInt) {
+        error = path + ": unsupported encoding (format " + std::to_string(format) + ", " + std::to_string(bits) + " bits)";
+        return false;
+    }
+
+    uint32_t bytesPerSample = bits / 8;
+    uint32_t total = dataSize / bytesPerSample;
+    total -= total % channels;
+    out.pcm.resize(total);
+    for (uint32_t i = 0; i < total; i++) {
+        const uint8_t* p = data + (size_t)i * bytesPerSample;
+        double v;
+        if (isFloat) {
+            float fv;
+            uint32_t raw = le32(p);
+            std::memcpy(&fv, &raw, sizeof(fv));
+            v = fv * 32767.0;
+        } else if (bits == 8) {
+            v = ((int)p[0] - 128) * 256.0;
+        } else if (bits == 16) {
+            v = (int16_t)le16(p);
+        } else if (bits == 24) {
+            int32_t s = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+            v = s / 256.0;
+        } else {
+            v = (int32_t)le32(p) / 65536.0;
+        }
+        out.pcm[i] = clamp16(v);
+    }
+    out.channels = (uint8_t)channels;
+    out.sampleRate = rate;
+    out.frames = total / channels;
+    if (out.loopEnd > out.frames) out.loopEnd = out.frames;
+    if (out.loopStart >= out.loopEnd) out.loopStart = out.loopEnd = 0;
+    return true;
+}
+
+/**
+ * @brief Write interleaved int16 PCM as a canonical 44-byte-header WAV
+ */
+inline bool write(const std::string& path, const int16_t* pcm, uint32_t frames, uint8_t channels, uint32_t sampleRate) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    uint32_t dataBytes = frames * channels * 2;
+    uint8_t h[44];
+    auto put16 = [&](int o, uint16_t v) { h[o] = v & 0xFF; h[o + 1] = v >> 8; };
+    auto put32 = [&](int o, uint32_t v) { for (int i = 0; i < 4; i++) h[o + i] = (v >> (8 * i)) & 0xFF; };
+    std::memcpy(h, "RIFF", 4);
+    put32(4, 36 + dataBytes);
+    std::memcpy(h + 8, "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, 1);
+    put16(22, channels);
+    put32(24, sampleRate);
+    put32(28, sampleRate * channels * 2);
+    put16(32, channels * 2);
+    put16(34, 16);
+    std::memcpy(h + 36, "data", 4);
+    put32(40, dataBytes);
+    bool ok = std::fwrite(h, 1, sizeof(h), f) == sizeof(h) &&
+              std::fwrite(pcm, 2, (size_t)frames * channels, f) == (size_t)frames * channels;
+    return std::fclose(f) == 0 && ok;
+}
+
+}  // namespace wav
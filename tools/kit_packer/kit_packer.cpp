@@ -0,0 +1,263 @@
+/**
+ * @file kit_packer.cpp
+ * @brief Host-side CLI that builds a kit bundle (.kit) from a folder of WAVs
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -Ishared/audio -Itools/common tools/kit_packer/kit_packer.cpp -o kit_packer
+ *
+ * Usage:
+ *   kit_packer [--no-trim] [--codec pcm16|pcm12|adpcm] <wav-folder> <kit-description> <output.kit>
+ *
+ * Kit description (plain text, one sample per line, '#' starts a comment):
+ *
+ *   kit Default
+ *   /samples/default/kick.wav    kick.wav
+ *   /samples/default/snare.wav   snare_01.wav
+ *   /samples/default/hihat.wav   hats/closed.wav    0 0
+ *
+ *   - "kit <name>" sets the kit name shown in the boot log.
+ *   - First column: sample name as referenced by PadConfig::sampleName.
+ *   - Second column: WAV file relative to <wav-folder>.
+ *   - Optional third/fourth columns: loop start/end frames (overrides 'smpl').
+ *
+ * Every WAV is converted to signed 16-bit PCM (mono or stereo) and placed on a
+ * KIT_BUNDLE_ALIGN boundary, so the firmware can read the data region in one
+ * pass. Copy the result to the SD card as /kits/default.kit.
+ *
+ * One-shot samples (no loop) are trimmed like the firmware does for loose WAVs
+ * (sample_trim.h): leading silence is removed and the inaudible tail is cut
+ * with a short fade. --no-trim keeps them as they are.
+ *
+ * --codec stores the samples compressed (sample_codec.h); the firmware keeps
+ * them that way in PSRAM and decodes while mixing:
+ *   pcm16  plain PCM (default)
+ *   pcm12  ~76% of the size, near-lossless (>60 dB SNR), cheapest decode
+ *   adpcm  ~26% of the size, IMA-ADPCM (~15-35 dB SNR depending on material)
+ * test/host/test_sample_codec.cpp reports size, SNR and decode speed per codec.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "kit_bundle.h"
+#include "sample_codec.h"
+#include "sample_trim.h"
+#include "wav_file.h"
+
+namespace {
+
+struct KitItem {
+    std::string name;
+    std::string file;
+    long loopStart = -1;
+    long loopEnd = -1;
+};
+
+bool parseDescription(const std::string& path, std::string& kitName, std::vector<KitItem>& items) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "error: cannot open kit description %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        std::string first;
+        if (!(ss >> first)) continue;
+
+        if (first == "kit") {
+            std::getline(ss >> std::ws, kitName);
+            continue;
+        }
+
+        KitItem item;
+        item.name = first;
+        if (!(ss >> item.file)) {
+            std::fprintf(stderr, "error: %s:%d: missing WAV file for '%s'\n", path.c_str(), lineNo, first.c_str());
+            return false;
+        }
+        if (ss >> item.loopStart) {
+            if (!(ss >> item.loopEnd)) {
+                std::fprintf(stderr, "error: %s:%d: loop start without loop end\n", path.c_str(), lineNo);
+                return false;
+            }
+        }
+        if (item.name.size() >= KIT_BUNDLE_NAME_LEN) {
+            std::fprintf(stderr, "error: %s:%d: sample name longer than %d chars\n",
+                         path.c_str(), lineNo, KIT_BUNDLE_NAME_LEN - 1);
+            return false;
+        }
+        for (const KitItem& other : items) {
+            if (kitBundleHash(other.name.c_str()) == kitBundleHash(item.name.c_str())) {
+                std::fprintf(stderr, "error: %s:%d: '%s' duplicates or collides with '%s'\n",
+                             path.c_str(), lineNo, item.name.c_str(), other.name.c_str());
+                return false;
+            }
+        }
+        items.push_back(item);
+    }
+
+    if (items.empty()) {
+        std::fprintf(stderr, "error: %s lists no samples\n", path.c_str());
+        return false;
+    }
+    if (items.size() > KIT_BUNDLE_MAX_SAMPLES) {
+        std::fprintf(stderr, "error: %zu samples, the firmware accepts at most %d\n",
+                     items.size(), KIT_BUNDLE_MAX_SAMPLES);
+        return false;
+    }
+    return true;
+}
+
+bool parseCodec(const char* name, uint8_t& format) {
+    for (uint8_t f : {KIT_FORMAT_PCM16, KIT_FORMAT_PCM12, KIT_FORMAT_ADPCM4}) {
+        if (std::strcmp(name, sampleCodecName(f)) == 0) {
+            format = f;
+            return true;
+        }
+    }
+    std::fprintf(stderr, "error: unknown codec '%s' (pcm16, pcm12, adpcm)\n", name);
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* program = argv[0];
+    bool trimSamples = true;
+    uint8_t codec = KIT_FORMAT_PCM16;
+    while (argc > 1 && std::strncmp(argv[1], "--", 2) == 0) {
+        if (std::strcmp(argv[1], "--no-trim") == 0) {
+            trimSamples = false;
+        } else if (std::strcmp(argv[1], "--codec") == 0 && argc > 2) {
+            if (!parseCodec(argv[2], codec)) return 2;
+            argv++;
+            argc--;
+        } else {
+            break;
+        }
+        argv++;
+        argc--;
+    }
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s [--no-trim] [--codec pcm16|pcm12|adpcm] <wav-folder> <kit-description> <output.kit>\n",
+                     program);
+        return 2;
+    }
+    std::string folder = argv[1];
+    if (!folder.empty() && folder.back() != '/') folder += '/';
+
+    std::string kitName = "Kit";
+    std::vector<KitItem> items;
+    if (!parseDescription(argv[2], kitName, items)) return 1;
+
+    std::vector<KitBundleEntry> index(items.size());
+    std::vector<wav::Audio> audio(items.size());
+    std::vector<SampleTrim> trims(items.size());
+    std::vector<uint32_t> sourceFrames(items.size());
+    uint32_t dataSize = 0;
+
+    for (size_t i = 0; i < items.size(); i++) {
+        std::string error;
+        if (!wav::read(folder + items[i].file, audio[i], error)) {
+            std::fprintf(stderr, "error: %s\n", error.c_str());
+            return 1;
+        }
+        wav::Audio& a = audio[i];
+        if (a.frames == 0) {
+            std::fprintf(stderr, "error: %s has no audio\n", items[i].file.c_str());
+            return 1;
+        }
+        if (a.sampleRate != 44100) {
+            std::fprintf(stderr, "warning: %s is %u Hz, the engine plays at 44100 Hz without resampling\n",
+                         items[i].file.c_str(), a.sampleRate);
+        }
+
+        KitBundleEntry& e = index[i];
+        std::memset(&e, 0, sizeof(e));
+
+        // Fingerprint of the source PCM, so the firmware cache matches the same WAV loaded loose
+        e.fingerprint = kitSampleFingerprint(reinterpret_cast<const uint8_t*>(a.pcm.data()),
+                                             a.frames * a.channels * sizeof(int16_t),
+                                             a.sampleRate, a.channels);
+
+        bool looped = items[i].loopEnd > 0 || (items[i].loopEnd < 0 && a.loopEnd > 0);
+        sourceFrames[i] = a.frames;
+        trims[i] = {0, a.frames, 0, 0};
+        if (trimSamples && !looped) {
+            trims[i] = analyzeSampleTrim(a.pcm.data(), a.frames, a.channels, a.sampleRate);
+            a.frames = applySampleTrim(a.pcm.data(), a.channels, trims[i]);
+            a.pcm.resize((size_t)a.frames * a.channels);
+        }
+
+        e.nameHash = kitBundleHash(items[i].name.c_str());
+        e.offset = dataSize;
+        e.bytes = sampleCodecBytes(codec, a.frames, a.channels);
+        e.frames = a.frames;
+        e.sampleRate = a.sampleRate;
+        e.channels = a.channels;
+        e.format = codec;
+        e.trimLeadFrames = (uint16_t)(trims[i].startFrame < 0xFFFF ? trims[i].startFrame : 0xFFFF);
+        e.loopStart = items[i].loopStart >= 0 ? (uint32_t)items[i].loopStart : a.loopStart;
+        e.loopEnd = items[i].loopEnd >= 0 ? (uint32_t)items[i].loopEnd : a.loopEnd;
+        if (e.loopEnd > e.frames || e.loopStart > e.loopEnd) {
+            std::fprintf(stderr, "error: %s: loop points outside the sample\n", items[i].name.c_str());
+            return 1;
+        }
+        std::strncpy(e.name, items[i].name.c_str(), KIT_BUNDLE_NAME_LEN - 1);
+
+        dataSize = kitBundleAlign(dataSize + e.bytes);
+    }
+
+    KitBundleHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = KIT_BUNDLE_MAGIC;
+    header.version = KIT_BUNDLE_VERSION;
+    header.headerSize = sizeof(KitBundleHeader);
+    header.entrySize = sizeof(KitBundleEntry);
+    header.sampleCount = (uint16_t)items.size();
+    header.indexOffset = kitBundleAlign(sizeof(KitBundleHeader));
+    header.dataOffset = kitBundleAlign(header.indexOffset + (uint32_t)(items.size() * sizeof(KitBundleEntry)));
+    header.dataSize = dataSize;
+    std::strncpy(header.kitName, kitName.c_str(), KIT_BUNDLE_KIT_NAME_LEN - 1);
+
+    std::vector<uint8_t> out(header.dataOffset + dataSize, 0);
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + header.indexOffset, index.data(), index.size() * sizeof(KitBundleEntry));
+    for (size_t i = 0; i < items.size(); i++) {
+        uint8_t* blob = out.data() + header.dataOffset + index[i].offset;
+        if (sampleCodecIsCoded(codec)) {
+            sampleCodecEncode(codec, audio[i].pcm.data(), index[i].frames, index[i].channels, blob);
+        } else {
+            std::memcpy(blob, audio[i].pcm.data(), index[i].bytes);
+        }
+    }
+
+    FILE* f = std::fopen(argv[3], "wb");
+    if (!f || std::fwrite(out.data(), 1, out.size(), f) != out.size() || std::fclose(f) != 0) {
+        std::fprintf(stderr, "error: cannot write %s\n", argv[3]);
+        return 1;
+    }
+
+    std::printf("Kit '%s': %zu samples, %u KB %s, %zu bytes total\n",
+                header.kitName, items.size(), dataSize / 1024, sampleCodecName(codec), out.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        const KitBundleEntry& e = index[i];
+        std::printf("  %-32s %8u frames  %u ch  %5u Hz  @%u  trimmed %.1f ms lead, %.1f ms tail\n",
+                    items[i].name.c_str(), e.frames, e.channels, e.sampleRate, e.offset,
+                    sampleTrimMs(trims[i].startFrame, e.sampleRate),
+                    sampleTrimMs(sourceFrames[i] - trims[i].endFrame, e.sampleRate));
+    }
+    return 0;
+}
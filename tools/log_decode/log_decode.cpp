@@ -0,0 +1,96 @@
+/**
+ * @file log_decode.cpp
+ * @brief Host-side decoder for the firmware's binary deferred log
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -Ishared/protocol tools/log_decode/log_decode.cpp -o log_decode
+ *
+ * Usage:
+ *   log_decode [--stats] <capture.bin | ->
+ *
+ * With the log in binary mode ('b' serial command, or LOG_BINARY_DEFAULT)
+ * the main brain writes LogRecord frames (shared/protocol/log_protocol.h)
+ * instead of text. Capture the serial port raw and feed it here, or pipe
+ * it live:
+ *
+ *   stty -F /dev/ttyUSB0 115200 raw && log_decode - < /dev/ttyUSB0
+ *
+ * Frames are turned back into the same text the firmware prints in text
+ * mode; anything else on the port (boot banner, Serial.printf output) is
+ * passed through unchanged. --stats adds a per-format count at the end.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "log_protocol.h"
+
+int main(int argc, char** argv) {
+    bool stats = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (!path) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [--stats] <capture.bin | ->\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    std::vector<uint8_t> buf;
+    std::map<uint32_t, unsigned long> counts;
+    unsigned long frames = 0, unknown = 0;
+    uint8_t chunk[4096];
+    bool eof = false;
+
+    while (!eof) {
+        size_t n = fread(chunk, 1, sizeof(chunk), in);
+        if (n == 0) eof = true;
+        buf.insert(buf.end(), chunk, chunk + n);
+
+        size_t pos = 0;
+        while (pos < buf.size()) {
+            LogRecord rec;
+            int used = logDecodeFrame(buf.data() + pos, buf.size() - pos, rec);
+            if (used < 0 && !eof) break;  // Partial frame: wait for more input
+            if (used <= 0) {
+                fputc(buf[pos++], stdout);  // Plain text (or a truncated frame at EOF)
+                continue;
+            }
+
+            char line[256];
+            logFormatRecord(rec, line, sizeof(line));
+            puts(line);
+            frames++;
+            counts[rec.formatId]++;
+            if (!logFormatString(rec.formatId)) unknown++;
+            pos += used;
+        }
+        buf.erase(buf.begin(), buf.begin() + pos);
+    }
+
+    if (in != stdin) fclose(in);
+
+    if (stats) {
+        fprintf(stderr, "%lu frames, %lu with an unknown format id\n", frames, unknown);
+        for (const auto& entry : counts) {
+            const char* fmt = logFormatString(entry.first);
+            fprintf(stderr, "  %8lu  0x%08x  %s\n", entry.second, entry.first, fmt ? fmt : "?");
+        }
+    }
+    return 0;
+}
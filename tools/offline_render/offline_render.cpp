@@ -0,0 +1,472 @@
+/**
+ * @file offline_render.cpp
+ * @brief Host-side offline renderer: runs the firmware mixer over a scripted hit sequence
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -Ishared/audio -Itools/common tools/offline_render/offline_render.cpp -o offline_render
+ *
+ * Usage:
+ *   offline_render [--no-trim] [--passes N] [--check ref.wav] <wav-folder> <script> <output.wav>
+ *
+ * The mixer is the firmware's own MixEngine (shared/audio/mix_engine.h), with
+ * the same voices, block size and buses as AudioEngine. Samples come from a
+ * file-based store instead of SampleManager: WAVs under <wav-folder>, trimmed
+ * like the firmware trims loose WAVs, or the entries of a kit bundle
+ * (including compressed ones).
+ *
+ * Script (plain text, '#' starts a comment, times in milliseconds):
+ *
+ *   kit kits/default.kit          # optional: samples by bundle name
+ *   pad 0 kick.wav                # sample played by a pad (file or bundle name)
+ *   pad 2 hihat.wav choke 1       # optional choke group 1-8
+ *   fader 0 100                   # bus fader 0-127
+ *   pan 1 -20                     # bus pan -64..64
+ *   master 110                    # master volume 0-127
+ *   hit 0 0 127                   # time_ms pad velocity
+ *   hit 250.5 1 90
+ *   end 2000                      # optional render length (default: until silent)
+ *
+ * As on the device, a hit starts sounding at the mixer block that contains
+ * its timestamp (256 frames, 5.8 ms).
+ *
+ * The output is deterministic: the same script, samples and build always
+ * give the same file, so --check compares against a reference WAV bit by
+ * bit and exits with 1 on any difference (mixer regression test). The
+ * renderer prints frames/s and the cost per 256-frame block (host cycles
+ * where a cycle counter is available); --passes repeats the render to
+ * stabilize the timing.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "kit_bundle.h"
+#include "mix_engine.h"
+#include "sample_codec.h"
+#include "sample_trim.h"
+#include "wav_file.h"
+
+namespace {
+
+// Same configuration as AudioEngine (audio_engine.h / edrum_config.h)
+constexpr uint32_t SAMPLE_RATE = 44100;
+constexpr size_t VOICES = 12;
+constexpr size_t BLOCK = 256;
+constexpr size_t PADS = 4;
+constexpr uint8_t MASTER_DEFAULT = 127;
+
+typedef MixEngine<VOICES, BLOCK, 2, PADS> Engine;
+
+uint64_t cycleNow() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+const char* CYCLE_UNIT = "host cycles (TSC)";
+#else
+const char* CYCLE_UNIT = "ns";
+#endif
+
+uint32_t limiterCycleNow() {
+    return (uint32_t)cycleNow();
+}
+
+// ============================================================
+// FILE-BASED SAMPLE STORE
+// ============================================================
+
+struct StoredSample {
+    std::vector<int16_t> pcm;       // Loose WAVs
+    MixSource source = {};
+    std::vector<uint16_t> envelope;
+};
+
+class SampleStore {
+public:
+    SampleStore(const std::string& folder, bool trim) : folder(folder), trim(trim) {}
+
+    bool loadKit(const std::string& path, std::string& error) {
+        std::ifstream in(folder + path, std::ios::binary);
+        if (!in) in.open(path, std::ios::binary);
+        if (!in) {
+            error = "cannot open kit " + path;
+            return false;
+        }
+        kit.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        KitBundleHeader header;
+        if (kit.size() < sizeof(header)) {
+            error = path + " is not a kit bundle";
+            return false;
+        }
+        std::memcpy(&header, kit.data(), sizeof(header));
+        if (header.magic != KIT_BUNDLE_MAGIC || header.version != KIT_BUNDLE_VERSION ||
+            (size_t)header.dataOffset + header.dataSize > kit.size() ||
+            header.indexOffset + header.sampleCount * sizeof(KitBundleEntry) > kit.size()) {
+            error = path + " is not a valid v" + std::to_string(KIT_BUNDLE_VERSION) + " kit bundle";
+            return false;
+        }
+
+        const uint8_t* data = kit.data() + header.dataOffset;
+        for (uint16_t i = 0; i < header.sampleCount; i++) {
+            KitBundleEntry e;
+            std::memcpy(&e, kit.data() + header.indexOffset + i * sizeof(KitBundleEntry), sizeof(e));
+            if (!sampleCodecIsKnown(e.format) || e.bytes != sampleCodecBytes(e.format, e.frames, e.channels) ||
+                (size_t)e.offset + e.bytes > header.dataSize) {
+                error = path + ": bad entry " + std::string(e.name, strnlen(e.name, KIT_BUNDLE_NAME_LEN));
+                return false;
+            }
+            std::unique_ptr<StoredSample> s(new StoredSample);
+            s->source.frames = e.frames;
+            s->source.channels = e.channels;
+            s->source.format = e.format;
+            if (sampleCodecIsCoded(e.format)) {
+                s->source.coded = data + e.offset;
+            } else {
+                s->source.data = reinterpret_cast<const int16_t*>(data + e.offset);
+            }
+            finish(*s);
+            samples[std::string(e.name, strnlen(e.name, KIT_BUNDLE_NAME_LEN))] = std::move(s);
+        }
+        return true;
+    }
+
+    // Bundle entry, or a WAV under the folder loaded on first use
+    const MixSource* get(const std::string& name, std::string& error) {
+        auto it = samples.find(name);
+        if (it != samples.end()) return &it->second->source;
+
+        wav::Audio audio;
+        if (!wav::read(folder + name, audio, error)) return nullptr;
+        if (audio.frames == 0 || audio.channels > 2) {
+            error = name + ": empty or more than two channels";
+            return nullptr;
+        }
+        if (audio.sampleRate != SAMPLE_RATE) {
+            std::fprintf(stderr, "warning: %s is %u Hz, played at %u Hz without resampling\n", name.c_str(),
+                         audio.sampleRate, SAMPLE_RATE);
+        }
+        if (trim) {
+            SampleTrim t = analyzeSampleTrim(audio.pcm.data(), audio.frames, audio.channels, audio.sampleRate);
+            audio.frames = applySampleTrim(audio.pcm.data(), audio.channels, t);
+            audio.pcm.resize((size_t)audio.frames * audio.channels);
+        }
+
+        std::unique_ptr<StoredSample> s(new StoredSample);
+        s->pcm = std::move(audio.pcm);
+        s->source.data = s->pcm.data();
+        s->source.frames = audio.frames;
+        s->source.channels = audio.channels;
+        s->source.format = KIT_FORMAT_PCM16;
+        finish(*s);
+        const MixSource* source = &s->source;
+        samples[name] = std::move(s);
+        return source;
+    }
+
+private:
+    std::string folder;
+    bool trim;
+    std::vector<uint8_t> kit;
+    std::map<std::string, std::unique_ptr<StoredSample>> samples;
+
+    static void finish(StoredSample& s) {
+        int16_t scratch[SAMPLE_CODEC_BLOCK * 2];
+        s.envelope.resize(mixEnvelopeBlocks(s.source.frames));
+        mixBuildEnvelope(s.source, s.envelope.data(), scratch);
+        s.source.envelope = s.envelope.data();
+        s.source.envelopeBlocks = (uint32_t)s.envelope.size();
+    }
+};
+
+// ============================================================
+// SCRIPT
+// ============================================================
+
+struct PadSetup {
+    std::string sample;
+    uint8_t chokeGroup = 0;     // 1-8, 0 = none
+    int fader = -1;             // -1 = engine default
+    int pan = 0;
+};
+
+struct Hit {
+    double timeMs;
+    uint8_t pad;
+    uint8_t velocity;
+};
+
+struct Script {
+    std::string kit;
+    PadSetup pads[PADS];
+    int master = MASTER_DEFAULT;
+    std::vector<Hit> hits;
+    double endMs = -1.0;
+};
+
+bool parseScript(const std::string& path, Script& script) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "error: cannot open script %s\n", path.c_str());
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    auto fail = [&](const char* what) {
+        std::fprintf(stderr, "error: %s:%d: %s\n", path.c_str(), lineNo, what);
+        return false;
+    };
+    auto padIndex = [&](int pad) { return pad >= 0 && pad < (int)PADS; };
+
+    while (std::getline(in, line)) {
+        lineNo++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        std::string cmd;
+        if (!(ss >> cmd)) continue;
+
+        int pad = 0, value = 0;
+        if (cmd == "kit") {
+            if (!(ss >> script.kit)) return fail("kit needs a path");
+        } else if (cmd == "pad") {
+            std::string sample, word;
+            if (!(ss >> pad >> sample) || !padIndex(pad)) return fail("expected: pad <0-3> <sample> [choke <1-8>]");
+            script.pads[pad].sample = sample;
+            if (ss >> word) {
+                if (word != "choke" || !(ss >> value) || value < 1 || value > 8) return fail("expected: choke <1-8>");
+                script.pads[pad].chokeGroup = (uint8_t)value;
+            }
+        } else if (cmd == "fader") {
+            if (!(ss >> pad >> value) || !padIndex(pad) || value < 0 || value > 127) return fail("expected: fader <pad> <0-127>");
+            script.pads[pad].fader = value;
+        } else if (cmd == "pan") {
+            if (!(ss >> pad >> value) || !padIndex(pad) || value < -64 || value > 64) return fail("expected: pan <pad> <-64..64>");
+            script.pads[pad].pan = value;
+        } else if (cmd == "master") {
+            if (!(ss >> value) || value < 0 || value > 127) return fail("expected: master <0-127>");
+            script.master = value;
+        } else if (cmd == "hit") {
+            Hit hit;
+            if (!(ss >> hit.timeMs >> pad >> value) || hit.timeMs < 0 || !padIndex(pad) || value < 1 || value > 127) {
+                return fail("expected: hit <ms> <pad> <velocity 1-127>");
+            }
+            hit.pad = (uint8_t)pad;
+            hit.velocity = (uint8_t)value;
+            script.hits.push_back(hit);
+        } else if (cmd == "end") {
+            if (!(ss >> script.endMs) || script.endMs <= 0) return fail("expected: end <ms>");
+        } else {
+            return fail("unknown command");
+        }
+    }
+
+    if (script.hits.empty()) {
+        std::fprintf(stderr, "error: %s has no hits\n", path.c_str());
+        return false;
+    }
+    for (const Hit& hit : script.hits) {
+        if (script.pads[hit.pad].sample.empty()) {
+            std::fprintf(stderr, "error: pad %u is hit but has no sample\n", hit.pad);
+            return false;
+        }
+    }
+    std::stable_sort(script.hits.begin(), script.hits.end(),
+                     [](const Hit& a, const Hit& b) { return a.timeMs < b.timeMs; });
+    return true;
+}
+
+// ============================================================
+// RENDER
+// ============================================================
+
+struct RenderStats {
+    double seconds = 0.0;
+    uint64_t minBlock = UINT64_MAX;
+    uint64_t maxBlock = 0;
+    uint64_t totalBlock = 0;
+    uint32_t blocks = 0;
+    uint32_t limiterMax = 0;
+    uint32_t culled = 0;
+    uint32_t stolen = 0;
+    MasterLimiterStats limiter = {};
+};
+
+uint32_t hitFrame(const Hit& hit) {
+    return (uint32_t)(hit.timeMs * SAMPLE_RATE / 1000.0 + 0.5);
+}
+
+void render(const Script& script, const MixSource* const* sources, uint32_t totalFrames,
+            std::vector<int16_t>& out, RenderStats& stats) {
+    std::unique_ptr<Engine> engine(new Engine(SAMPLE_RATE));  // ~45 KB: keep it off the stack
+    engine->setCycleCounter(limiterCycleNow);
+    engine->setMasterVolume((uint8_t)script.master);
+    for (uint8_t p = 0; p < PADS; p++) {
+        if (script.pads[p].fader >= 0) engine->setBusVolume(p, (uint8_t)script.pads[p].fader);
+        engine->setBusPan(p, (int8_t)script.pads[p].pan);
+    }
+
+    uint32_t blocks = (totalFrames + BLOCK - 1) / BLOCK;
+    out.assign((size_t)blocks * BLOCK * 2, 0);
+    size_t next = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t b = 0; b < blocks; b++) {
+        uint32_t blockEnd = (b + 1) * BLOCK;
+        uint64_t t0 = cycleNow();
+        while (next < script.hits.size() && hitFrame(script.hits[next]) < blockEnd) {
+            const Hit& hit = script.hits[next++];
+            const PadSetup& pad = script.pads[hit.pad];
+            uint8_t chokeMask = pad.chokeGroup ? (uint8_t)(1u << (pad.chokeGroup - 1)) : 0;
+            engine->start(*sources[hit.pad], hit.velocity, 127, chokeMask, hit.pad);
+        }
+        engine->render(&out[(size_t)b * BLOCK * 2]);
+        uint64_t cycles = cycleNow() - t0;
+        stats.minBlock = std::min(stats.minBlock, cycles);
+        stats.maxBlock = std::max(stats.maxBlock, cycles);
+        stats.totalBlock += cycles;
+    }
+    stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.blocks += blocks;
+    stats.limiterMax = std::max(stats.limiterMax, engine->limiterCycles());
+    stats.culled = engine->culledVoices();
+    stats.stolen = engine->stolenVoices();
+    stats.limiter = engine->limiterStats();
+    out.resize((size_t)totalFrames * 2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* program = argv[0];
+    bool trimSamples = true;
+    int passes = 1;
+    std::string checkPath;
+    while (argc > 1 && std::strncmp(argv[1], "--", 2) == 0) {
+        if (std::strcmp(argv[1], "--no-trim") == 0) {
+            trimSamples = false;
+        } else if (std::strcmp(argv[1], "--passes") == 0 && argc > 2) {
+            passes = std::max(1, std::atoi(argv[2]));
+            argv++;
+            argc--;
+        } else if (std::strcmp(argv[1], "--check") == 0 && argc > 2) {
+            checkPath = argv[2];
+            argv++;
+            argc--;
+        } else {
+            break;
+        }
+        argv++;
+        argc--;
+    }
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s [--no-trim] [--passes N] [--check ref.wav] <wav-folder> <script> <output.wav>\n",
+                     program);
+        return 2;
+    }
+    std::string folder = argv[1];
+    if (!folder.empty() && folder.back() != '/') folder += '/';
+
+    Script script;
+    if (!parseScript(argv[2], script)) return 1;
+
+    SampleStore store(folder, trimSamples);
+    std::string error;
+    if (!script.kit.empty() && !store.loadKit(script.kit, error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+    const MixSource* sources[PADS] = {};
+    for (uint8_t p = 0; p < PADS; p++) {
+        if (script.pads[p].sample.empty()) continue;
+        sources[p] = store.get(script.pads[p].sample, error);
+        if (!sources[p]) {
+            std::fprintf(stderr, "error: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    // Length: explicit, or the last sample tail plus the limiter lookahead
+    uint32_t totalFrames = 0;
+    if (script.endMs > 0) {
+        totalFrames = (uint32_t)(script.endMs * SAMPLE_RATE / 1000.0);
+    } else {
+        for (const Hit& hit : script.hits) {
+            uint32_t blockStart = hitFrame(hit) / BLOCK * BLOCK;
+            totalFrames = std::max(totalFrames, blockStart + sources[hit.pad]->frames);
+        }
+        totalFrames += MASTER_LIMITER_LOOKAHEAD_FRAMES + BLOCK;
+    }
+
+    std::vector<int16_t> out;
+    RenderStats stats;
+    for (int pass = 0; pass < passes; pass++) render(script, sources, totalFrames, out, stats);
+
+    if (!wav::write(argv[3], out.data(), totalFrames, 2, SAMPLE_RATE)) {
+        std::fprintf(stderr, "error: cannot write %s\n", argv[3]);
+        return 1;
+    }
+
+    double audioSeconds = (double)totalFrames / SAMPLE_RATE;
+    double framesPerSecond = (double)totalFrames * passes / stats.seconds;
+    std::printf("Rendered %zu hits, %.2f s of audio to %s\n", script.hits.size(), audioSeconds, argv[3]);
+    std::printf("  %.0f frames/s (%.0fx real time) over %d pass(es)\n", framesPerSecond,
+                framesPerSecond / SAMPLE_RATE, passes);
+    std::printf("  per %zu-frame block: min %llu / avg %llu / max %llu %s, limiter max %u\n", BLOCK,
+                (unsigned long long)stats.minBlock, (unsigned long long)(stats.totalBlock / stats.blocks),
+                (unsigned long long)stats.maxBlock, CYCLE_UNIT, stats.limiterMax);
+    std::printf("  voices culled %u, stolen %u; limiter min gain %.1f dB, %u samples clipped\n", stats.culled,
+                stats.stolen, masterLimiterReductionDb(stats.limiter.minGain), stats.limiter.clippedSamples);
+
+    if (!checkPath.empty()) {
+        wav::Audio ref;
+        if (!wav::read(checkPath, ref, error)) {
+            std::fprintf(stderr, "error: %s\n", error.c_str());
+            return 1;
+        }
+        size_t differing = 0;
+        size_t first = SIZE_MAX;
+        if (ref.channels != 2 || ref.frames != totalFrames) {
+            differing = SIZE_MAX;
+        } else {
+            for (size_t i = 0; i < out.size(); i++) {
+                if (out[i] != ref.pcm[i]) {
+                    if (first == SIZE_MAX) first = i / 2;
+                    differing++;
+                }
+            }
+        }
+        if (differing == SIZE_MAX) {
+            std::printf("CHECK FAILED: %s has a different length or layout (%u frames, %u ch)\n",
+                        checkPath.c_str(), ref.frames, ref.channels);
+            return 1;
+        }
+        if (differing) {
+            std::printf("CHECK FAILED: %zu samples differ from %s, first at frame %zu (%.1f ms)\n", differing,
+                        checkPath.c_str(), first, first * 1000.0 / SAMPLE_RATE);
+            return 1;
+        }
+        std::printf("CHECK OK: bit-exact with %s\n", checkPath.c_str());
+    }
+    return 0;
+}